@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <benchmark/benchmark.h>
+#include <libpman.h>
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <driver/ppm_events_public.h>
+#include "state.h"
+#include "ringbuffer_definitions.h"
+}
+
+namespace {
+
+constexpr uint32_t EVENTS_PER_RING = 1024;
+
+// BPF ring buffers laid out in plain memory, so that we can drive the libpman
+// consumer without loading the probe. Every ring is filled once with committed
+// events, the timestamps are interleaved across the rings.
+class mocked_rings {
+public:
+	explicit mocked_rings(uint32_t nrings):
+	        m_data(nrings),
+	        m_consumer(nrings),
+	        m_producer(nrings),
+	        m_rings(nrings),
+	        m_ring_ptrs(nrings),
+	        m_cons_pos(nrings),
+	        m_prod_pos(nrings),
+	        m_heads(nrings) {
+		uint32_t record_size = roundup_len(sizeof(ppm_evt_hdr));
+		uint64_t ring_size = 1;
+		while(ring_size < EVENTS_PER_RING * record_size) {
+			ring_size <<= 1;
+		}
+
+		uint64_t seed = 42;
+		for(uint32_t j = 0; j < nrings; j++) {
+			uint64_t ts = j;
+			m_data[j].resize(ring_size);
+			for(uint32_t i = 0; i < EVENTS_PER_RING; i++) {
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				ts += 1 + (seed >> 33) % (2 * nrings);
+
+				char* record = m_data[j].data() + i * record_size;
+				uint32_t len = sizeof(ppm_evt_hdr);
+				memcpy(record, &len, sizeof(len));
+
+				ppm_evt_hdr evt = {};
+				evt.ts = ts;
+				evt.len = sizeof(ppm_evt_hdr);
+				memcpy(record + BPF_RINGBUF_HDR_SZ, &evt, sizeof(evt));
+			}
+
+			m_rings[j].data = m_data[j].data();
+			m_rings[j].mask = ring_size - 1;
+			m_rings[j].consumer_pos = &m_consumer[j];
+			m_rings[j].producer_pos = &m_producer[j];
+			m_ring_ptrs[j] = &m_rings[j];
+		}
+		m_produced = EVENTS_PER_RING * record_size;
+
+		m_rb.rings = m_ring_ptrs.data();
+		m_rb.ring_cnt = nrings;
+
+		g_state.rb_manager = &m_rb;
+		g_state.n_required_buffers = nrings;
+		g_state.cons_pos = m_cons_pos.data();
+		g_state.prod_pos = m_prod_pos.data();
+		g_state.ring_heads = m_heads.data();
+		rewind();
+	}
+
+	~mocked_rings() {
+		g_state.rb_manager = nullptr;
+		g_state.n_required_buffers = 0;
+		g_state.cons_pos = nullptr;
+		g_state.prod_pos = nullptr;
+		g_state.ring_heads = nullptr;
+	}
+
+	// Make all the events available again, as if the producers wrote them again.
+	void rewind() {
+		for(uint32_t j = 0; j < m_rings.size(); j++) {
+			m_consumer[j] = 0;
+			m_producer[j] = m_produced;
+			m_cons_pos[j] = 0;
+			m_prod_pos[j] = 0;
+		}
+		// keep the current mode, this only drops the cached ring heads
+		pman_set_incremental_merge(g_state.incremental_merge);
+		g_state.last_ring_read = -1;
+		g_state.last_event_size = 0;
+	}
+
+private:
+	std::vector<std::vector<char>> m_data;
+	std::vector<unsigned long> m_consumer;
+	std::vector<unsigned long> m_producer;
+	std::vector<ring> m_rings;
+	std::vector<ring*> m_ring_ptrs;
+	std::vector<unsigned long> m_cons_pos;
+	std::vector<unsigned long> m_prod_pos;
+	std::vector<ring_head> m_heads;
+	ring_buffer m_rb = {};
+	unsigned long m_produced = 0;
+};
+
+}  // namespace
+
+// Args: number of rings, incremental merge enabled.
+static void BM_pman_consume_first_event(benchmark::State& state) {
+	pman_set_incremental_merge(state.range(1) != 0);
+	mocked_rings rings(state.range(0));
+	void* evt;
+	int16_t buffer_id;
+	int64_t events = 0;
+
+	for(auto _ : state) {
+		pman_consume_first_event(&evt, &buffer_id);
+		if(evt == nullptr) {
+			rings.rewind();
+			continue;
+		}
+		events++;
+	}
+	state.SetItemsProcessed(events);
+	pman_set_incremental_merge(false);
+}
+BENCHMARK(BM_pman_consume_first_event)->ArgsProduct({{8, 64, 256}, {0, 1}});
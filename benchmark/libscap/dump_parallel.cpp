@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/scap.h>
+#include <libscap/scap_engines.h>
+#include <libscap/scap_savefile_api.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+extern "C" {
+#include <libscap/scap_platform.h>
+}
+
+namespace {
+
+constexpr uint32_t NUM_REPLAYS = 200;
+
+struct captured_evt {
+	std::vector<char> data;
+	uint16_t cpuid;
+	uint32_t flags;
+};
+
+// The events of a real capture, copied in memory
+const std::vector<captured_evt>& get_events() {
+	static std::vector<captured_evt> events = [] {
+		std::vector<captured_evt> res;
+		char error[SCAP_LASTERR_SIZE];
+		int32_t rc;
+
+		struct scap_platform* platform = scap_savefile_alloc_platform(NULL, NULL);
+		scap_savefile_engine_params params = {};
+		params.fname = BENCHMARK_CAPTURES_PATH "/single_ipv6_conn.scap";
+		params.platform = platform;
+		scap_open_args oargs = {};
+		oargs.engine_params = &params;
+
+		scap_t* h = scap_open(&oargs, &scap_savefile_engine, error, &rc);
+		if(h != NULL) {
+			scap_evt* evt;
+			uint16_t cpuid;
+			uint32_t flags;
+			while(scap_next(h, &evt, &cpuid, &flags) == SCAP_SUCCESS) {
+				const char* p = (const char*)evt;
+				res.push_back({std::vector<char>(p, p + evt->len), cpuid, flags});
+			}
+			scap_close(h);
+		}
+		scap_platform_close(platform);
+		scap_platform_free(platform);
+		return res;
+	}();
+	return events;
+}
+
+}  // namespace
+
+// Dumping `NUM_REPLAYS` replays of a real capture to a compressed file, on the
+// calling thread (0) or with the compression offloaded to `state.range(0)`
+// threads. The latency counters are the time spent in scap_dump(), that is
+// taken from the event loop, and the time taken by closing the file.
+static void BM_dump_parallel(benchmark::State& state) {
+	const auto& events = get_events();
+	uint32_t num_workers = state.range(0);
+	char tmpl[] = "/tmp/bench_dump_XXXXXX";
+	int fd = mkstemp(tmpl);
+	close(fd);
+	char error[SCAP_LASTERR_SIZE];
+
+	uint64_t nevents = 0;
+	double max_latency = 0;
+	double total_latency = 0;
+	double close_latency = 0;
+	for(auto _ : state) {
+		scap_dumper_t* d = num_workers == 0
+		                           ? scap_dump_open(NULL, tmpl, SCAP_COMPRESSION_GZIP, error)
+		                           : scap_dump_open_parallel(NULL, tmpl, num_workers, error);
+		if(d == NULL) {
+			state.SkipWithError(error);
+			break;
+		}
+
+		for(uint32_t i = 0; i < NUM_REPLAYS; i++) {
+			for(const auto& evt : events) {
+				auto start = std::chrono::steady_clock::now();
+				scap_dump(d, (scap_evt*)evt.data.data(), evt.cpuid, evt.flags);
+				std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start;
+				max_latency = std::max(max_latency, latency.count());
+				total_latency += latency.count();
+			}
+		}
+		nevents += NUM_REPLAYS * events.size();
+
+		auto start = std::chrono::steady_clock::now();
+		scap_dump_close(d);
+		std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start;
+		close_latency += latency.count();
+	}
+	unlink(tmpl);
+
+	state.counters["events/s"] = benchmark::Counter(nevents, benchmark::Counter::kIsRate);
+	state.counters["dump_avg_ns"] = nevents ? total_latency * 1e9 / nevents : 0;
+	state.counters["dump_max_us"] = max_latency * 1e6;
+	state.counters["close_ms"] = close_latency * 1e3 / state.iterations();
+}
+BENCHMARK(BM_dump_parallel)
+        ->ArgNames({"threads"})
+        ->Arg(0)
+        ->Arg(1)
+        ->Arg(2)
+        ->Arg(4)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
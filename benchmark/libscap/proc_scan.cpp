@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/scap.h>
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <string>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C" {
+#include <libscap/scap-int.h>
+#include <libscap/scap_platform.h>
+#include <libscap/linux/scap_linux_int.h>
+#include <libscap/linux/scap_linux_platform.h>
+}
+
+namespace {
+
+constexpr uint32_t NUM_PROCS = 2000;
+constexpr uint32_t NUM_TASKS = 4;
+constexpr uint32_t NUM_FDS = 32;
+
+// A /proc-like directory shaped like a busy host: `NUM_PROCS` processes, each one
+// with `NUM_TASKS` additional threads and `NUM_FDS` open files.
+class fake_proc_tree {
+public:
+	fake_proc_tree() {
+		char path[] = "/tmp/scap_proc_scan_XXXXXX";
+		m_path = mkdtemp(path);
+		for(uint32_t i = 0; i < NUM_PROCS; i++) {
+			uint64_t pid = 1000 + i * (NUM_TASKS + 1);
+			std::string dir = m_path + "/" + std::to_string(pid);
+			add_thread(dir, pid, pid);
+
+			for(uint32_t j = 0; j <= NUM_TASKS; j++) {
+				add_thread(dir + "/task/" + std::to_string(pid + j), pid, pid + j);
+			}
+
+			mkdir((dir + "/fd").c_str(), 0755);
+			for(uint32_t fd = 0; fd < NUM_FDS; fd++) {
+				std::string target = fd % 2 ? "/dev/null" : "/tmp";
+				symlink(target.c_str(), (dir + "/fd/" + std::to_string(fd)).c_str());
+			}
+		}
+	}
+
+	~fake_proc_tree() {
+		nftw(
+		        m_path.c_str(),
+		        [](const char* p, const struct stat*, int, struct FTW*) { return remove(p); },
+		        16,
+		        FTW_DEPTH | FTW_PHYS);
+	}
+
+	char* path() { return m_path.data(); }
+
+private:
+	static void write_file(const std::string& path, const std::string& content) {
+		std::ofstream(path, std::ios::binary) << content;
+	}
+
+	static void add_thread(const std::string& dir, uint64_t pid, uint64_t tid) {
+		std::string pid_s = std::to_string(pid);
+		std::string tid_s = std::to_string(tid);
+		std::string uid_s = std::to_string(getuid());
+		std::string gid_s = std::to_string(getgid());
+
+		mkdir(dir.c_str(), 0755);
+		mkdir((dir + "/task").c_str(), 0755);
+		symlink("/bin/sh", (dir + "/exe").c_str());
+		symlink("/", (dir + "/cwd").c_str());
+		symlink("/", (dir + "/root").c_str());
+		write_file(dir + "/cmdline", std::string("sh\0-c\0sleep infinity\0", 21));
+		write_file(dir + "/environ", std::string("PATH=/usr/bin:/bin\0HOME=/\0", 26));
+		write_file(dir + "/cgroup", "0::/\n");
+		write_file(dir + "/status",
+		           "Name:\tsh\nTgid:\t" + pid_s + "\nPid:\t" + tid_s + "\nPPid:\t1\nUid:\t" +
+		                   uid_s + "\t" + uid_s + "\t" + uid_s + "\t" + uid_s + "\nGid:\t" +
+		                   gid_s + "\t" + gid_s + "\t" + gid_s + "\t" + gid_s +
+		                   "\nNStgid:\t" + pid_s + "\t" + pid_s + "\nNSpid:\t" + tid_s + "\t" +
+		                   tid_s + "\nNSpgid:\t" + pid_s + "\t" + pid_s + "\nVmSize:\t1000 kB\n" +
+		                   "VmRSS:\t100 kB\nVmSwap:\t0 kB\nCapInh:\t0\nCapPrm:\t0\nCapEff:\t0\n");
+		write_file(dir + "/stat",
+		           tid_s + " (sh) S 1 " + pid_s + " " + pid_s + " 0 -1 0 10 0 1 0\n");
+		write_file(dir + "/loginuid", uid_s + "\n");
+	}
+
+	std::string m_path;
+};
+
+}  // namespace
+
+// Wall time of the initial /proc scan of the fake tree as a function of the number of
+// scanning threads (0 is the serial scan) and of whether the fd details are deferred.
+static void BM_proc_scan(benchmark::State& state) {
+	static fake_proc_tree tree;
+	char lasterr[SCAP_LASTERR_SIZE];
+
+	struct scap_platform* platform = scap_linux_alloc_platform(NULL, NULL);
+	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
+	linux_platform->m_lasterr = lasterr;
+	linux_platform->m_proc_scan_num_threads = state.range(0);
+	linux_platform->m_proc_scan_lazy_fds = state.range(1);
+	if(scap_cgroup_interface_init(&linux_platform->m_cgroups, "", lasterr, false) !=
+	   SCAP_SUCCESS) {
+		state.SkipWithError(lasterr);
+		scap_platform_free(platform);
+		return;
+	}
+
+	for(auto _ : state) {
+		if(scap_linux_scan_proc_table(linux_platform,
+		                              &platform->m_proclist,
+		                              tree.path(),
+		                              lasterr) != SCAP_SUCCESS) {
+			state.SkipWithError(lasterr);
+			break;
+		}
+
+		state.PauseTiming();
+		scap_proc_free_table(&platform->m_proclist);
+		platform->m_proclist.m_proclist = NULL;
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() * NUM_PROCS);
+	scap_platform_close(platform);
+	scap_platform_free(platform);
+}
+BENCHMARK(BM_proc_scan)
+        ->ArgNames({"threads", "lazy_fds"})
+        ->Args({0, 0})
+        ->Args({2, 0})
+        ->Args({4, 0})
+        ->Args({8, 0})
+        ->Args({0, 1})
+        ->Args({4, 1})
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/scap.h>
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <sys/param.h>
+#include <vector>
+
+extern "C" {
+#include <libscap/ringbuffer/devset.h>
+
+// Synthetic devices: every refill hands back the same full block, as if the
+// producers were always one block ahead of us, so that we never sleep.
+static inline void synthetic_get_buf_pointers(scap_device* dev,
+                                              uint64_t* phead,
+                                              uint64_t* ptail,
+                                              uint64_t* pread_size) {
+	*phead = dev->m_buffer_size;
+	*ptail = 0;
+	*pread_size = dev->m_buffer_size;
+}
+
+static inline void synthetic_advance_tail(scap_device* dev) {
+	dev->m_lastreadsize = 0;
+}
+
+static inline int32_t synthetic_readbuf(scap_device* dev, char** buf, uint32_t* len) {
+	dev->m_lastreadsize = (uint32_t)dev->m_buffer_size;
+	*buf = dev->m_buffer;
+	*len = (uint32_t)dev->m_buffer_size;
+	return SCAP_SUCCESS;
+}
+
+#define GET_BUF_POINTERS synthetic_get_buf_pointers
+#define ADVANCE_TAIL synthetic_advance_tail
+#define READBUF synthetic_readbuf
+
+#include <libscap/ringbuffer/ringbuffer.h>
+}
+
+namespace {
+
+// Enough events to stay above `BUFFER_EMPTY_THRESHOLD_B`.
+constexpr uint32_t EVENTS_PER_BLOCK = 1024;
+
+class synthetic_devset {
+public:
+	explicit synthetic_devset(uint32_t ndevs): m_blocks(ndevs) {
+		devset_init(&m_devset, ndevs, m_lasterr);
+
+		// Timestamps are interleaved across devices with some jitter, as on a busy host.
+		uint64_t seed = 42;
+		for(uint32_t j = 0; j < ndevs; j++) {
+			uint64_t ts = j;
+			m_blocks[j].resize(EVENTS_PER_BLOCK * sizeof(scap_evt));
+			for(uint32_t i = 0; i < EVENTS_PER_BLOCK; i++) {
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				ts += 1 + (seed >> 33) % (2 * ndevs);
+
+				scap_evt evt = {};
+				evt.ts = ts;
+				evt.tid = j;
+				evt.len = sizeof(scap_evt);
+				memcpy(m_blocks[j].data() + i * sizeof(scap_evt), &evt, sizeof(scap_evt));
+			}
+
+			m_devset.m_devs[j].m_buffer = m_blocks[j].data();
+			m_devset.m_devs[j].m_buffer_size = m_blocks[j].size();
+		}
+	}
+
+	~synthetic_devset() {
+		for(uint32_t j = 0; j < m_devset.m_ndevs; j++) {
+			m_devset.m_devs[j].m_buffer = (char*)INVALID_MAPPING;
+		}
+		devset_free(&m_devset);
+	}
+
+	scap_device_set* devset() { return &m_devset; }
+
+private:
+	scap_device_set m_devset;
+	std::vector<std::vector<char>> m_blocks;
+	char m_lasterr[SCAP_LASTERR_SIZE];
+};
+
+}  // namespace
+
+static void BM_ringbuffer_next(benchmark::State& state) {
+	synthetic_devset devs(state.range(0));
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+	int64_t events = 0;
+
+	for(auto _ : state) {
+		if(ringbuffer_next(devs.devset(), &evt, &devid, &flags) == SCAP_SUCCESS) {
+			benchmark::DoNotOptimize(evt);
+			events++;
+		}
+	}
+	state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_ringbuffer_next)->Arg(8)->Arg(64)->Arg(256);
+
+static void BM_ringbuffer_next_batch(benchmark::State& state) {
+	synthetic_devset devs(state.range(0));
+	uint32_t max_events = state.range(1);
+	std::vector<scap_evt*> evts(max_events);
+	std::vector<uint16_t> devids(max_events);
+	std::vector<uint32_t> flags(max_events);
+	uint32_t nevents;
+	int64_t events = 0;
+
+	for(auto _ : state) {
+		if(ringbuffer_next_batch(devs.devset(),
+		                         evts.data(),
+		                         devids.data(),
+		                         flags.data(),
+		                         max_events,
+		                         &nevents) == SCAP_SUCCESS) {
+			benchmark::DoNotOptimize(evts.data());
+			events += nevents;
+		}
+	}
+	state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_ringbuffer_next_batch)->ArgsProduct({{8, 64, 256}, {16, 128}});
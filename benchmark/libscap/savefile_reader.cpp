@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/scap.h>
+#include <libscap/scap_engines.h>
+#include <libsinsp/sinsp.h>
+#include <libsinsp/dumper.h>
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+extern "C" {
+#include <libscap/scap_platform.h>
+}
+
+namespace {
+
+constexpr uint64_t CAPTURE_SIZE = 1ULL << 30;
+constexpr uint32_t READ_BUFFER_SIZE = 1 << 20;
+
+enum savefile_reader { READER_ZLIB, READER_BUFFERED, READER_MMAP };
+
+// An uncompressed capture of about `CAPTURE_SIZE` bytes: the headers of a real
+// capture followed by its events, repeated
+struct large_capture {
+	std::string path;
+	uint64_t size = 0;
+
+	large_capture() {
+		char tmpl[] = "/tmp/bench_savefile_reader_XXXXXX";
+		int fd = mkstemp(tmpl);
+		close(fd);
+		path = tmpl;
+
+		uint64_t header_size;
+		{
+			sinsp inspector;
+			inspector.open_savefile(BENCHMARK_CAPTURES_PATH "/single_ipv6_conn.scap");
+			sinsp_dumper dumper;
+			dumper.open(&inspector, path, false);
+			header_size = dumper.next_write_position();
+			sinsp_evt* evt;
+			while(inspector.next(&evt) != SCAP_EOF) {
+				if(evt != nullptr) {
+					dumper.dump(evt);
+				}
+			}
+			dumper.close();
+		}
+
+		std::ifstream in(path, std::ios::binary);
+		std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		std::string events = content.substr(header_size);
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(content.data(), header_size);
+		uint64_t replays = (CAPTURE_SIZE - header_size) / events.size();
+		for(uint64_t i = 0; i < replays; i++) {
+			out.write(events.data(), events.size());
+		}
+		size = header_size + replays * events.size();
+	}
+
+	~large_capture() { unlink(path.c_str()); }
+};
+
+}  // namespace
+
+// Events per second read from a large uncompressed capture through zlib, through
+// zlib with a read buffer, and from a memory mapping.
+static void BM_savefile_reader(benchmark::State& state) {
+	static large_capture capture;
+	char error[SCAP_LASTERR_SIZE];
+	uint64_t num_events = 0;
+	int32_t rc;
+
+	for(auto _ : state) {
+		struct scap_platform* platform = scap_savefile_alloc_platform(NULL, NULL);
+		scap_savefile_engine_params params = {};
+		params.fname = capture.path.c_str();
+		params.fbuffer_size = state.range(0) == READER_BUFFERED ? READ_BUFFER_SIZE : 0;
+		params.use_mmap = state.range(0) == READER_MMAP;
+		params.platform = platform;
+		scap_open_args oargs = {};
+		oargs.engine_params = &params;
+
+		scap_t* h = scap_open(&oargs, &scap_savefile_engine, error, &rc);
+		if(h == NULL) {
+			state.SkipWithError(error);
+			scap_platform_free(platform);
+			break;
+		}
+
+		scap_evt* evt;
+		uint16_t cpuid;
+		uint32_t flags;
+		while((rc = scap_next(h, &evt, &cpuid, &flags)) == SCAP_SUCCESS) {
+			benchmark::DoNotOptimize(evt->ts);
+			num_events++;
+		}
+
+		scap_close(h);
+		scap_platform_close(platform);
+		scap_platform_free(platform);
+
+		if(rc != SCAP_EOF) {
+			state.SkipWithError("unexpected end of the capture");
+			break;
+		}
+	}
+
+	state.SetItemsProcessed(num_events);
+	state.SetBytesProcessed(state.iterations() * capture.size);
+}
+BENCHMARK(BM_savefile_reader)
+        ->ArgNames({"reader"})
+        ->Arg(READER_ZLIB)
+        ->Arg(READER_BUFFERED)
+        ->Arg(READER_MMAP)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/scap.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include <sys/eventfd.h>
+#include <sys/param.h>
+#include <time.h>
+
+extern "C" {
+#include <libscap/ringbuffer/devset.h>
+
+// Synthetic devices fed by a producer thread. The head is published by the producer, the tail
+// by the consumer, and `m_fd` is an eventfd signaled when the pending data crosses the wakeup
+// watermark, like a perf buffer opened with `wakeup_watermark`.
+static inline uint64_t* synthetic_head(scap_device* dev) {
+	return (uint64_t*)dev->m_bufinfo;
+}
+
+static inline void synthetic_get_buf_pointers(scap_device* dev,
+                                              uint64_t* phead,
+                                              uint64_t* ptail,
+                                              uint64_t* pread_size) {
+	*phead = __atomic_load_n(synthetic_head(dev), __ATOMIC_ACQUIRE);
+	*ptail = __atomic_load_n(synthetic_head(dev) + 1, __ATOMIC_RELAXED);
+	*pread_size = *phead - *ptail;
+}
+
+static inline void synthetic_advance_tail(scap_device* dev) {
+	uint64_t* tail = synthetic_head(dev) + 1;
+	__atomic_store_n(tail, *tail + dev->m_lastreadsize, __ATOMIC_RELEASE);
+	dev->m_lastreadsize = 0;
+}
+
+static inline int32_t synthetic_readbuf(scap_device* dev, char** buf, uint32_t* len) {
+	uint64_t head, tail, read_size;
+
+	// Reading the buffer clears the wakeup, as `poll` does on a perf buffer.
+	uint64_t wakeups;
+	ssize_t ret = read(dev->m_fd, &wakeups, sizeof(wakeups));
+	(void)ret;
+
+	synthetic_get_buf_pointers(dev, &head, &tail, &read_size);
+	dev->m_lastreadsize = (uint32_t)read_size;
+	*buf = dev->m_buffer + tail;
+	*len = (uint32_t)read_size;
+	return SCAP_SUCCESS;
+}
+
+#define GET_BUF_POINTERS synthetic_get_buf_pointers
+#define ADVANCE_TAIL synthetic_advance_tail
+#define READBUF synthetic_readbuf
+
+#include <libscap/ringbuffer/ringbuffer.h>
+}
+
+namespace {
+
+constexpr uint32_t NUM_DEVS = 4;
+constexpr uint32_t EVENTS_PER_ITERATION = 64;
+
+uint64_t monotonic_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+class producer_devset {
+public:
+	explicit producer_devset(uint32_t watermark): m_watermark(watermark) {
+		devset_init(&m_devset, NUM_DEVS, m_lasterr);
+		for(uint32_t j = 0; j < NUM_DEVS; j++) {
+			scap_device* dev = &m_devset.m_devs[j];
+			m_blocks[j].resize(EVENTS_PER_ITERATION * sizeof(scap_evt));
+			dev->m_buffer = m_blocks[j].data();
+			dev->m_buffer_size = m_blocks[j].size();
+			dev->m_bufinfo = (struct ppm_ring_buffer_info*)m_positions[j];
+			dev->m_fd = eventfd(0, EFD_NONBLOCK);
+		}
+		if(m_watermark != 0) {
+			devset_enable_poll(&m_devset);
+		}
+	}
+
+	~producer_devset() {
+		for(uint32_t j = 0; j < NUM_DEVS; j++) {
+			m_devset.m_devs[j].m_buffer = (char*)INVALID_MAPPING;
+			m_devset.m_devs[j].m_bufinfo = (struct ppm_ring_buffer_info*)INVALID_MAPPING;
+		}
+		devset_free(&m_devset);
+	}
+
+	scap_device_set* devset() { return &m_devset; }
+
+	void reset() {
+		for(uint32_t j = 0; j < NUM_DEVS; j++) {
+			m_positions[j][0] = 0;
+			m_positions[j][1] = 0;
+			m_devset.m_devs[j].m_lastreadsize = 0;
+			m_devset.m_devs[j].m_sn_len = 0;
+		}
+		devset_invalidate_heap(&m_devset);
+	}
+
+	// Emit `EVENTS_PER_ITERATION` events in small bursts separated by idle gaps of 1-8 ms,
+	// as on a quiet host. Every event carries its publication time.
+	void produce(uint64_t seed) {
+		std::mt19937_64 rng(seed);
+		uint32_t emitted = 0;
+		while(emitted < EVENTS_PER_ITERATION) {
+			std::this_thread::sleep_for(std::chrono::microseconds(1000 + rng() % 7000));
+			uint32_t burst = MIN(1 + rng() % 4, EVENTS_PER_ITERATION - emitted);
+			for(uint32_t i = 0; i < burst; i++, emitted++) {
+				publish(rng() % NUM_DEVS);
+			}
+		}
+	}
+
+private:
+	void publish(uint32_t devid) {
+		scap_device* dev = &m_devset.m_devs[devid];
+		uint64_t head = m_positions[devid][0];
+		uint64_t tail = __atomic_load_n(&m_positions[devid][1], __ATOMIC_ACQUIRE);
+
+		scap_evt evt = {};
+		evt.ts = monotonic_ns();
+		evt.tid = devid;
+		evt.len = sizeof(scap_evt);
+		memcpy(dev->m_buffer + head, &evt, sizeof(scap_evt));
+		__atomic_store_n(&m_positions[devid][0], head + sizeof(scap_evt), __ATOMIC_RELEASE);
+
+		// Signal the consumer only when this event crosses the watermark.
+		uint64_t pending = head - tail;
+		if(m_watermark != 0 && pending < m_watermark &&
+		   pending + sizeof(scap_evt) >= m_watermark) {
+			uint64_t one = 1;
+			ssize_t ret = write(dev->m_fd, &one, sizeof(one));
+			(void)ret;
+		}
+	}
+
+	uint32_t m_watermark;
+	scap_device_set m_devset;
+	std::vector<char> m_blocks[NUM_DEVS];
+	uint64_t m_positions[NUM_DEVS][2] = {};  // head, tail
+	char m_lasterr[SCAP_LASTERR_SIZE];
+};
+
+}  // namespace
+
+// Added latency between the publication of an event and its consumption, with the sleep
+// backoff (watermark 0) and when blocking on the device fds. `idle_wakeups/s` counts the
+// refills that found all the buffers empty.
+static void BM_ringbuffer_wakeup(benchmark::State& state) {
+	producer_devset devs(state.range(0));
+	std::vector<uint64_t> latencies;
+	int64_t idle_wakeups = 0;
+	uint64_t seed = 0;
+
+	for(auto _ : state) {
+		devs.reset();
+		std::thread producer(&producer_devset::produce, &devs, seed++);
+
+		scap_evt* evt;
+		uint16_t devid;
+		uint32_t flags;
+		uint32_t consumed = 0;
+		while(consumed < EVENTS_PER_ITERATION) {
+			int32_t res = ringbuffer_next(devs.devset(), &evt, &devid, &flags);
+			if(res == SCAP_SUCCESS) {
+				latencies.push_back(monotonic_ns() - evt->ts);
+				consumed++;
+				continue;
+			}
+
+			bool idle = true;
+			for(uint32_t j = 0; j < NUM_DEVS; j++) {
+				idle = idle && devs.devset()->m_devs[j].m_sn_len == 0;
+			}
+			idle_wakeups += idle;
+		}
+
+		producer.join();
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	state.counters["p50_us"] = latencies[latencies.size() / 2] / 1000.0;
+	state.counters["p99_us"] = latencies[latencies.size() * 99 / 100] / 1000.0;
+	state.counters["idle_wakeups/s"] =
+	        benchmark::Counter((double)idle_wakeups, benchmark::Counter::kIsRate);
+	state.SetItemsProcessed(latencies.size());
+}
+BENCHMARK(BM_ringbuffer_wakeup)->Arg(0)->Arg(1)->Iterations(10)->UseRealTime();
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <libsinsp/dns_manager.h>
+#include <benchmark/benchmark.h>
+
+#include <arpa/inet.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t NUM_NAMES = 10000;
+
+// Numeric names resolve to themselves without querying any DNS server, which
+// lets the cache hold `NUM_NAMES` entries with one known address each.
+std::vector<uint32_t> populate_dns_cache() {
+	std::vector<uint32_t> addrs;
+	for(uint32_t i = 0; i < NUM_NAMES; i++) {
+		std::string name = "10.0." + std::to_string(i / 256) + "." + std::to_string(i % 256);
+		uint32_t addr;
+		inet_pton(AF_INET, name.c_str(), &addr);
+		sinsp_dns_manager::get().match(name.c_str(), AF_INET, &addr, 1);
+		addrs.push_back(addr);
+	}
+	return addrs;
+}
+
+}  // namespace
+
+// Lookups of the name of the addresses of `fd.sip.name`/`fd.rip.name`, half of
+// them for addresses of the cached names and half for unknown addresses.
+static void BM_dns_manager_name_of(benchmark::State& state) {
+	static std::vector<uint32_t> addrs = populate_dns_cache();
+	uint64_t ts = 2;
+	uint32_t i = 0;
+	for(auto _ : state) {
+		uint32_t addr = (i & 1) ? addrs[(i * 7919) % NUM_NAMES] : htonl(0xc0a80000 + i % 65536);
+		benchmark::DoNotOptimize(sinsp_dns_manager::get().name_of(AF_INET, &addr, ts++));
+		i++;
+	}
+}
+BENCHMARK(BM_dns_manager_name_of);
+#endif
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <libsinsp/filter.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A rule condition on the command line of a process, with `n` patterns of the
+// kind found in rulesets: half of them substrings, a quarter of them prefixes,
+// and the rest an 'in' list. None of them match, so all of them are tested.
+std::string condition(size_t n) {
+	std::string ret;
+	size_t i = 0;
+	for(; i < n / 2; i++) {
+		ret += i == 0 ? "" : " or ";
+		ret += "proc.cmdline contains \"miner-" + std::to_string(i) + " --pool\"";
+	}
+	for(; i < n / 2 + n / 4; i++) {
+		ret += " or proc.cmdline startswith \"/opt/tool" + std::to_string(i) + "/\"";
+	}
+	ret += " or proc.cmdline in (";
+	for(size_t j = 0; i < n; i++, j++) {
+		ret += (j == 0 ? "\"" : ", \"") + std::string("bash -c payload") + std::to_string(i) + "\"";
+	}
+	return ret + ")";
+}
+
+template<typename... Args>
+std::vector<char> encode_event(ppm_event_code type, uint32_t n, Args... args) {
+	char error[SCAP_LASTERR_SIZE];
+	scap_sized_buffer buf = {nullptr, 0};
+	size_t size = 0;
+	scap_event_encode_params(buf, &size, error, type, n, args...);
+	std::vector<char> ret(size);
+	buf = {ret.data(), size};
+	scap_event_encode_params(buf, &size, error, type, n, args...);
+	return ret;
+}
+
+}  // namespace
+
+// Evaluation of a condition made of `state.range(0)` string patterns on the same field
+// against a process with a typical command line.
+static void BM_filter_multi_match(benchmark::State& state) {
+	char args[] = "-c\0curl -s http://example.com/install.sh | sh";
+	scap_const_sized_buffer empty = {nullptr, 0};
+	auto clone = encode_event(PPME_SYSCALL_CLONE_20_X,
+	                          21,
+	                          (int64_t)0,
+	                          "/bin/sh",
+	                          scap_const_sized_buffer{args, sizeof(args)},
+	                          (int64_t)100,
+	                          (int64_t)100,
+	                          (int64_t)1,
+	                          "/",
+	                          (int64_t)1024,
+	                          (uint64_t)0,
+	                          (uint64_t)0,
+	                          (uint32_t)0,
+	                          (uint32_t)0,
+	                          (uint32_t)0,
+	                          "sh",
+	                          empty,
+	                          (uint32_t)0,
+	                          (uint32_t)0,
+	                          (uint32_t)0,
+	                          (int64_t)100,
+	                          (int64_t)100,
+	                          (uint64_t)0);
+	scap_evt* events[] = {(scap_evt*)clone.data()};
+	events[0]->ts = 1000;
+	events[0]->tid = 100;
+	scap_test_input_data data = {};
+	data.events = events;
+	data.event_count = 1;
+
+	sinsp inspector;
+	inspector.open_test_input(&data, SINSP_MODE_TEST);
+	sinsp_evt* evt;
+	if(inspector.next(&evt) != SCAP_SUCCESS) {
+		state.SkipWithError("can't read the test event");
+		return;
+	}
+
+	sinsp_filter_check_list flist;
+	auto factory = std::make_shared<sinsp_filter_factory>(&inspector, flist);
+	sinsp_filter_compiler compiler(factory, condition(state.range(0)));
+	auto filter = compiler.compile();
+
+	// each iteration is a new event, so that the cached values can't be reused
+	uint64_t num = evt->get_num();
+	for(auto _ : state) {
+		evt->set_num(++num);
+		benchmark::DoNotOptimize(filter->run(evt));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_filter_multi_match)->RangeMultiplier(10)->Range(10, 10000);
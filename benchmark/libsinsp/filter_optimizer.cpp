@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/filter.h>
+#include <libsinsp/filter/optimizer.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+namespace {
+
+// A rule condition with its macros expanded, as compiled by Falco
+const std::string s_spawned_process = "(evt.type = execve and evt.dir = <)";
+const std::string s_shell_procs = "(proc.name in (bash, sh) or proc.name = zsh or proc.name = ash)";
+const std::string s_container_runtime =
+        "(proc.pname = runc or proc.pname = containerd or proc.pname = dockerd "
+        "or proc.pname in (crio, conmon))";
+const std::string s_always_true = "(evt.num >= 0)";
+const std::string s_never_true = "(proc.name = __never_true__)";
+const std::string s_condition = "(" + s_spawned_process + " and " + s_always_true + ") and (" +
+                                s_spawned_process + " and " + s_shell_procs + ") and " +
+                                s_container_runtime + " and not (" + s_never_true + ") and not (" +
+                                s_always_true + " and " + s_never_true + ")";
+
+size_t count_checks(const sinsp_filter_check* c) {
+	auto e = dynamic_cast<const sinsp_filter_expression*>(c);
+	if(e == nullptr) {
+		return 1;
+	}
+	size_t ret = 0;
+	for(const auto& child : e->m_checks) {
+		ret += count_checks(child.get());
+	}
+	return ret;
+}
+
+}  // namespace
+
+// Evaluation of a rule condition on all the events of a capture, as parsed
+// (`state.range(0)` = 0) or optimized (1).
+static void BM_filter_optimizer(benchmark::State& state) {
+	std::string path = BENCHMARK_CAPTURES_PATH "/curl_google.scap";
+	sinsp inspector;
+	sinsp_filter_check_list flist;
+	auto factory = std::make_shared<sinsp_filter_factory>(&inspector, flist);
+
+	auto ast = libsinsp::filter::parser(s_condition).parse();
+	if(state.range(0) != 0) {
+		auto never_true = libsinsp::filter::parser(s_never_true).parse();
+		ast = libsinsp::filter::ast::optimize(ast.get(), {{never_true.get(), false}});
+	}
+	auto filter = sinsp_filter_compiler(factory, ast.get()).compile();
+
+	uint64_t events = 0;
+	for(auto _ : state) {
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res != SCAP_SUCCESS) {
+				continue;
+			}
+			events++;
+			benchmark::DoNotOptimize(filter->run(evt));
+		}
+		inspector.close();
+	}
+	state.counters["checks"] = count_checks(filter->m_filter.get());
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_filter_optimizer)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
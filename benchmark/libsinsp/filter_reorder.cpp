@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/filter.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Conditions written with the expensive checks first, as often found in
+// rulesets, where a cheaper check on the event type decides most results.
+const std::vector<std::string> s_conditions = {
+        "proc.aname in (sshd, containerd, dockerd) and fd.name regex '^/etc/(shadow|sudoers)' "
+        "and evt.type in (open, openat, openat2)",
+        "proc.acmdline contains 'nc -e' and proc.aname = bash and evt.type = execve",
+        "fd.name glob '/var/run/*.sock' and proc.pname = runc and evt.type = connect "
+        "and evt.dir = <",
+        "not proc.aname = systemd and evt.type in (setuid, setgid)",
+        "(proc.aexe endswith /python or proc.acmdline contains crypto) "
+        "and evt.type in (sendto, recvfrom) and fd.rport = 3333",
+        "proc.cmdline regex 'curl .*[|] *sh' or proc.aname = kthreadd and evt.type = mmap",
+};
+
+}  // namespace
+
+// Evaluation of conditions with mixed cheap and expensive checks on all the
+// events of a capture, with the checks in source order (`state.range(0)` = 0),
+// ordered by static cost (1), or also by their sampled selectivity (2).
+static void BM_filter_reorder_checks(benchmark::State& state) {
+	std::string path = BENCHMARK_CAPTURES_PATH "/curl_google.scap";
+	sinsp inspector;
+	sinsp_filter_check_list flist;
+	auto factory = std::make_shared<sinsp_filter_factory>(&inspector, flist);
+
+	std::vector<std::unique_ptr<sinsp_filter>> filters;
+	for(const auto& c : s_conditions) {
+		sinsp_filter_compiler compiler(factory, c);
+		compiler.set_reorder_checks(state.range(0) > 0, state.range(0) > 1 ? 1000 : 0);
+		filters.push_back(compiler.compile());
+	}
+
+	uint64_t events = 0;
+	for(auto _ : state) {
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res != SCAP_SUCCESS) {
+				continue;
+			}
+			events++;
+			for(auto& f : filters) {
+				benchmark::DoNotOptimize(f->run(evt));
+			}
+		}
+		inspector.close();
+	}
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_filter_reorder_checks)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/filter_set.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A ruleset of `n` rules, made of the kind of conditions found in real
+// rulesets: most of them only apply to a few event types.
+std::vector<std::string> ruleset(size_t n) {
+	static const std::vector<std::string> templates = {
+	        "evt.type in (open, openat, openat2) and evt.dir = < and fd.name startswith /etc/x",
+	        "evt.type = execve and evt.dir = < and proc.name = tool",
+	        "evt.type = connect and evt.dir = < and fd.sport = 1",
+	        "evt.type in (setuid, setgid) and evt.dir = > and proc.name = tool",
+	        "evt.type in (unlink, unlinkat) and evt.dir = < and fs.path.name contains /var/x",
+	        "evt.type in (mkdir, mkdirat) and evt.dir = < and proc.pname = tool",
+	        "evt.type in (sendto, recvfrom) and fd.l4proto = udp and fd.rport = 1",
+	        "evt.type = close and fd.name = /tmp/x",
+	        "evt.type != switch and proc.name = tool",
+	};
+
+	std::vector<std::string> ret;
+	for(size_t i = 0; i < n; i++) {
+		ret.push_back(templates[i % templates.size()] + std::to_string(i));
+	}
+	return ret;
+}
+
+}  // namespace
+
+// Evaluation of a ruleset of `state.range(0)` rules on all the events of a
+// capture, either with the rules indexed by event type (`state.range(1)` = 1)
+// or by running all of them on each event.
+static void BM_filter_set_run(benchmark::State& state) {
+	std::string path = BENCHMARK_CAPTURES_PATH "/curl_google.scap";
+	sinsp inspector;
+	sinsp_filter_check_list flist;
+	auto factory = std::make_shared<sinsp_filter_factory>(&inspector, flist);
+
+	auto rules = ruleset(state.range(0));
+	sinsp_filter_set set(factory);
+	std::vector<std::unique_ptr<sinsp_filter>> filters;
+	for(size_t i = 0; i < rules.size(); i++) {
+		set.add(i, "syscall", rules[i]);
+		filters.push_back(sinsp_filter_compiler(factory, rules[i]).compile());
+	}
+
+	bool indexed = state.range(1) != 0;
+	std::vector<uint32_t> ids;
+	uint64_t events = 0;
+	for(auto _ : state) {
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res != SCAP_SUCCESS) {
+				continue;
+			}
+			events++;
+			if(indexed) {
+				benchmark::DoNotOptimize(set.run(evt, ids));
+				continue;
+			}
+			for(auto& f : filters) {
+				benchmark::DoNotOptimize(f->run(evt));
+			}
+		}
+		inspector.close();
+	}
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_filter_set_run)
+        ->ArgsProduct({{10, 100, 500}, {0, 1}})
+        ->ArgNames({"filters", "indexed"})
+        ->Unit(benchmark::kMicrosecond);
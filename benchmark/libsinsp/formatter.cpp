@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/eventformatter.h>
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace {
+
+// An output with the fields usually found in alerts
+const std::string s_format =
+        "*%evt.time: event %evt.type (user=%user.name user_uid=%user.uid process=%proc.name "
+        "proc_exepath=%proc.exepath parent=%proc.pname command=%proc.cmdline pid=%proc.pid "
+        "terminal=%proc.tty fd=%fd.num file=%fd.name container_id=%container.id "
+        "args=%evt.args) %15proc.name %toupper(proc.name)";
+
+}  // namespace
+
+// Formatting of an output for all the events of a capture as text
+// (`state.range(0)` = 0), in JSON building a document (1), or in JSON with
+// the streaming writer (2).
+static void BM_formatter_tostring(benchmark::State& state) {
+	std::string path = BENCHMARK_CAPTURES_PATH "/curl_google.scap";
+	sinsp inspector;
+	sinsp_filter_check_list flist;
+	sinsp_evt_formatter formatter(&inspector, flist);
+	auto of = state.range(0) > 0 ? sinsp_evt_formatter::OF_JSON : sinsp_evt_formatter::OF_NORMAL;
+	formatter.set_format(of, s_format);
+	formatter.set_resolve_transformed_fields(true);
+	formatter.set_streaming_json(state.range(0) > 1);
+
+	std::string output;
+	uint64_t events = 0;
+	for(auto _ : state) {
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res != SCAP_SUCCESS) {
+				continue;
+			}
+			events++;
+			benchmark::DoNotOptimize(formatter.tostring(evt, output));
+		}
+		inspector.close();
+	}
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_formatter_tostring)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/net_prefix_search.h>
+#include <libsinsp/filter_compare.h>
+#include <libsinsp/sinsp_inet.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// IPv4 networks with prefixes from /12 to /28, as in lists of known ranges.
+std::vector<ipv4net> ipv4_networks(size_t n) {
+	std::mt19937 rng(42);
+	std::vector<ipv4net> nets;
+	for(size_t i = 0; i < n; i++) {
+		uint32_t prefix_len = 12 + rng() % 17;
+		ipv4net net;
+		net.m_netmask = htonl(~0U << (32 - prefix_len));
+		net.m_ip = rng() & net.m_netmask;
+		nets.push_back(net);
+	}
+	return nets;
+}
+
+// Addresses of connections, about half of them in one of the networks.
+std::vector<uint32_t> ipv4_probes(const std::vector<ipv4net>& nets) {
+	std::mt19937 rng(7);
+	std::vector<uint32_t> addrs;
+	for(size_t i = 0; i < 1024; i++) {
+		if(i % 2) {
+			addrs.push_back(rng());
+			continue;
+		}
+		const ipv4net& net = nets[rng() % nets.size()];
+		addrs.push_back(net.m_ip | (rng() & ~net.m_netmask));
+	}
+	return addrs;
+}
+
+}  // namespace
+
+// Membership of addresses in `state.range(0)` networks, as for `fd.net in (...)`.
+static void BM_net_prefix_search_match(benchmark::State& state) {
+	net_prefix_search search;
+	auto nets = ipv4_networks(state.range(0));
+	for(auto& net : nets) {
+		search.add_network(net);
+	}
+	auto probes = ipv4_probes(nets);
+
+	size_t i = 0;
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(search.match(probes[i++ % probes.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_net_prefix_search_match)->Arg(10)->Arg(1000)->Arg(100000);
+
+// The same membership test done by comparing the address with each network.
+static void BM_net_prefix_scan_match(benchmark::State& state) {
+	auto nets = ipv4_networks(state.range(0));
+	auto probes = ipv4_probes(nets);
+
+	size_t i = 0;
+	for(auto _ : state) {
+		uint32_t addr = probes[i++ % probes.size()];
+		bool found = false;
+		for(auto& net : nets) {
+			if(flt_compare_ipv4net(CO_EQ, addr, &net)) {
+				found = true;
+				break;
+			}
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_net_prefix_scan_match)->Arg(10)->Arg(1000)->Arg(100000);
+
+// Membership of IPv6 addresses in `state.range(0)` networks from /32 to /64.
+static void BM_net_prefix_search_match_ipv6(benchmark::State& state) {
+	std::mt19937 rng(42);
+	net_prefix_search search;
+	std::vector<ipv6addr> probes;
+	for(int64_t i = 0; i < state.range(0); i++) {
+		char str[64];
+		snprintf(str,
+		         sizeof(str),
+		         "2001:%x:%x:%x::/%u",
+		         (unsigned)(rng() % 0xffff),
+		         (unsigned)(rng() % 0xffff),
+		         (unsigned)(rng() % 0xffff),
+		         (unsigned)(32 + rng() % 33));
+		search.add_network(ipv6net(str));
+		if(probes.size() < 512) {
+			probes.push_back(ipv6net(str).addr());
+			snprintf(str, sizeof(str), "2002:%x::1", (unsigned)(rng() % 0xffff));
+			probes.push_back(ipv6addr(str));
+		}
+	}
+
+	size_t i = 0;
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(search.match(probes[i++ % probes.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_net_prefix_search_match_ipv6)->Arg(10)->Arg(1000)->Arg(100000);
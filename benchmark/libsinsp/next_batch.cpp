@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <libsinsp/dumper.h>
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t CAPTURE_EVENTS = 100000;
+
+// Dump a capture of `CAPTURE_EVENTS` events once and share it between the benchmarks.
+const std::string& capture_path() {
+	static const std::string path = [] {
+		std::string p =
+		        (std::filesystem::temp_directory_path() / "bench.next_batch.scap").string();
+		char error[SCAP_LASTERR_SIZE];
+		std::vector<std::vector<char>> buffers(CAPTURE_EVENTS);
+		std::vector<scap_evt*> events;
+		for(uint32_t i = 0; i < CAPTURE_EVENTS; i++) {
+			scap_sized_buffer buf = {nullptr, 0};
+			size_t size = 0;
+			scap_event_encode_params(buf,
+			                         &size,
+			                         error,
+			                         PPME_SYSCALL_OPEN_E,
+			                         3,
+			                         "/tmp/the_file.txt",
+			                         (uint32_t)0,
+			                         (uint32_t)0);
+			buffers[i].resize(size);
+			buf = {buffers[i].data(), size};
+			scap_event_encode_params(buf,
+			                         &size,
+			                         error,
+			                         PPME_SYSCALL_OPEN_E,
+			                         3,
+			                         "/tmp/the_file.txt",
+			                         (uint32_t)0,
+			                         (uint32_t)0);
+			scap_evt* evt = (scap_evt*)buffers[i].data();
+			evt->ts = 1000 + i;
+			evt->tid = 1;
+			events.push_back(evt);
+		}
+
+		scap_test_input_data data = {};
+		data.events = events.data();
+		data.event_count = events.size();
+
+		sinsp inspector;
+		inspector.open_test_input(&data, SINSP_MODE_TEST);
+		sinsp_dumper dumper;
+		dumper.open(&inspector, p, false);
+		sinsp_evt* evt;
+		while(inspector.next(&evt) == SCAP_SUCCESS) {
+			dumper.dump(evt);
+		}
+		dumper.close();
+		return p;
+	}();
+	return path;
+}
+
+template<typename F>
+void read_capture(benchmark::State& state, F&& read_all) {
+	const std::string& path = capture_path();
+	int64_t events = 0;
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto inspector = std::make_unique<sinsp>();
+		inspector->open_savefile(path);
+		state.ResumeTiming();
+
+		events += read_all(*inspector);
+
+		state.PauseTiming();
+		inspector.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(events);
+}
+
+}  // namespace
+
+static void BM_sinsp_next(benchmark::State& state) {
+	read_capture(state, [](sinsp& inspector) {
+		int64_t n = 0;
+		sinsp_evt* evt;
+		while(inspector.next(&evt) == SCAP_SUCCESS) {
+			benchmark::DoNotOptimize(evt);
+			n++;
+		}
+		return n;
+	});
+}
+BENCHMARK(BM_sinsp_next);
+
+static void BM_sinsp_next_batch(benchmark::State& state) {
+	uint32_t max_events = state.range(0);
+	read_capture(state, [max_events](sinsp& inspector) {
+		int64_t n = 0;
+		while(inspector.next_batch(max_events, [&n](sinsp_evt* evt) {
+			benchmark::DoNotOptimize(evt);
+			n++;
+		}) == SCAP_SUCCESS) {
+		}
+		return n;
+	});
+}
+BENCHMARK(BM_sinsp_next_batch)->Arg(64)->Arg(1024);
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <libsinsp/filter.h>
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr char digits[] = "0123456789abcdef";
+
+// An extraction plugin that decodes the whole event at each request, like
+// plugins parsing a JSON payload do, and exposes many fields of it.
+struct plugin_state {
+	std::string lasterr;
+	std::map<std::string, std::string> doc;
+	std::string hex;
+	std::vector<uint64_t> u64storage;
+	std::vector<const char*> strstorage;
+};
+
+const char* plugin_get_required_api_version() {
+	return PLUGIN_API_VERSION_STR;
+}
+
+const char* plugin_get_version() {
+	return "0.1.0";
+}
+
+const char* plugin_get_name() {
+	return "bench_extract";
+}
+
+const char* plugin_get_description() {
+	return "some desc";
+}
+
+const char* plugin_get_contact() {
+	return "some contact";
+}
+
+const char* plugin_get_fields() {
+	return R"(
+[
+	{"type": "uint64", "name": "bench.type", "desc": "Type of the event"},
+	{"type": "uint64", "name": "bench.tid", "desc": "Thread ID of the event"},
+	{"type": "uint64", "name": "bench.len", "desc": "Length of the event"},
+	{"type": "uint64", "name": "bench.nparams", "desc": "Number of parameters of the event"},
+	{"type": "string", "name": "bench.hex", "desc": "Hex dump of the event payload"},
+	{"type": "uint64", "name": "bench.doclen", "desc": "Number of decoded parameters"}
+])";
+}
+
+const char* plugin_get_extract_event_sources() {
+	return "[\"syscall\"]";
+}
+
+ss_plugin_t* plugin_init(const ss_plugin_init_input* in, ss_plugin_rc* rc) {
+	*rc = SS_PLUGIN_SUCCESS;
+	return new plugin_state();
+}
+
+void plugin_destroy(ss_plugin_t* s) {
+	delete reinterpret_cast<plugin_state*>(s);
+}
+
+const char* plugin_get_last_error(ss_plugin_t* s) {
+	return ((plugin_state*)s)->lasterr.c_str();
+}
+
+ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
+                                   const ss_plugin_event_input* ev,
+                                   const ss_plugin_field_extract_input* in) {
+	auto ps = reinterpret_cast<plugin_state*>(s);
+
+	// decode each parameter in a document, as a JSON parser would do
+	auto lens = (const uint16_t*)((const uint8_t*)ev->evt + sizeof(ss_plugin_event));
+	auto payload = (const uint8_t*)(lens + ev->evt->nparams);
+	auto end = (const uint8_t*)ev->evt + ev->evt->len;
+	ps->doc.clear();
+	ps->hex.clear();
+	for(uint32_t i = 0; i < ev->evt->nparams && payload + lens[i] <= end; i++) {
+		std::string val;
+		for(uint16_t j = 0; j < lens[i]; j++) {
+			val += digits[payload[j] >> 4];
+			val += digits[payload[j] & 0xf];
+		}
+		payload += lens[i];
+		ps->hex += val;
+		ps->doc["param" + std::to_string(i)] = std::move(val);
+	}
+
+	ps->u64storage.resize(in->num_fields);
+	ps->strstorage.resize(in->num_fields);
+	for(uint32_t i = 0; i < in->num_fields; i++) {
+		auto& f = in->fields[i];
+		f.res.u64 = &ps->u64storage[i];
+		f.res_len = 1;
+		switch(f.field_id) {
+		case 0:
+			ps->u64storage[i] = ev->evt->type;
+			break;
+		case 1:
+			ps->u64storage[i] = ev->evt->tid;
+			break;
+		case 2:
+			ps->u64storage[i] = ev->evt->len;
+			break;
+		case 3:
+			ps->u64storage[i] = ev->evt->nparams;
+			break;
+		case 4:
+			ps->strstorage[i] = ps->hex.c_str();
+			f.res.str = &ps->strstorage[i];
+			break;
+		case 5:
+			ps->u64storage[i] = ps->doc.size();
+			break;
+		default:
+			return SS_PLUGIN_FAILURE;
+		}
+	}
+	return SS_PLUGIN_SUCCESS;
+}
+
+std::shared_ptr<sinsp_plugin> register_bench_plugin(sinsp& inspector, benchmark::State& state) {
+	plugin_api api;
+	memset(&api, 0, sizeof(plugin_api));
+	api.get_required_api_version = plugin_get_required_api_version;
+	api.get_version = plugin_get_version;
+	api.get_description = plugin_get_description;
+	api.get_contact = plugin_get_contact;
+	api.get_name = plugin_get_name;
+	api.get_last_error = plugin_get_last_error;
+	api.init = plugin_init;
+	api.destroy = plugin_destroy;
+	api.get_fields = plugin_get_fields;
+	api.get_extract_event_sources = plugin_get_extract_event_sources;
+	api.extract_fields = plugin_extract_fields;
+
+	std::string err;
+	auto pl = inspector.register_plugin(&api);
+	if(!pl->init("", err)) {
+		state.SkipWithError(err.c_str());
+		return nullptr;
+	}
+	return pl;
+}
+
+// Conditions that are true for all the events, so that all their checks run.
+const std::vector<std::string> s_checks = {
+        "bench.type >= 0",
+        "bench.tid >= 0",
+        "bench.len > 0",
+        "bench.nparams >= 0",
+        "bench.hex exists",
+        "bench.doclen >= 0",
+};
+
+}  // namespace
+
+// Evaluation of a filter using `state.range(0)` fields of a plugin that decodes
+// the whole event at each extraction request, on all the events of a capture.
+static void BM_plugin_extract_fields(benchmark::State& state) {
+	std::string path = BENCHMARK_CAPTURES_PATH "/curl_google.scap";
+	sinsp inspector;
+	auto pl = register_bench_plugin(inspector, state);
+	if(!pl) {
+		return;
+	}
+
+	sinsp_filter_check_list flist;
+	flist.add_filter_check(sinsp_plugin::new_filtercheck(pl));
+	auto factory = std::make_shared<sinsp_filter_factory>(&inspector, flist);
+
+	std::string condition;
+	for(int64_t i = 0; i < state.range(0); i++) {
+		condition += (i == 0 ? "" : " and ") + s_checks[i];
+	}
+	auto filter = sinsp_filter_compiler(factory, condition).compile();
+
+	uint64_t events = 0;
+	for(auto _ : state) {
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res != SCAP_SUCCESS) {
+				continue;
+			}
+			events++;
+			benchmark::DoNotOptimize(filter->run(evt));
+		}
+		inspector.close();
+	}
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_plugin_extract_fields)->Arg(1)->Arg(3)->Arg(6)->Unit(benchmark::kMicrosecond);
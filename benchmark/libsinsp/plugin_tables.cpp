@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+constexpr uint32_t NUM_INT_FIELDS = 6;
+constexpr uint32_t NUM_STR_FIELDS = 2;
+constexpr uint32_t NUM_FIELDS = NUM_INT_FIELDS + NUM_STR_FIELDS;
+constexpr int64_t NUM_ENTRIES = 1000;
+
+// A parsing plugin that defines `NUM_FIELDS` dynamic fields in the threads table
+// and hands its table accessors to the benchmarks.
+struct plugin_state {
+	std::string lasterr;
+	ss_plugin_table_t* thread_table;
+	ss_plugin_table_field_t* fields[NUM_FIELDS];
+	ss_plugin_table_reader_vtable_ext reader;
+	ss_plugin_table_writer_vtable_ext writer;
+};
+
+plugin_state* s_plugin = nullptr;
+
+const char* plugin_get_required_api_version() {
+	return PLUGIN_API_VERSION_STR;
+}
+
+const char* plugin_get_version() {
+	return "0.1.0";
+}
+
+const char* plugin_get_name() {
+	return "bench_tables";
+}
+
+const char* plugin_get_description() {
+	return "some desc";
+}
+
+const char* plugin_get_contact() {
+	return "some contact";
+}
+
+const char* plugin_get_parse_event_sources() {
+	return "[\"syscall\"]";
+}
+
+ss_plugin_t* plugin_init(const ss_plugin_init_input* in, ss_plugin_rc* rc) {
+	auto ret = new plugin_state();
+	*rc = SS_PLUGIN_FAILURE;
+
+	ret->thread_table =
+	        in->tables->get_table(in->owner, "threads", ss_plugin_state_type::SS_PLUGIN_ST_INT64);
+	if(!ret->thread_table) {
+		ret->lasterr = "can't access thread table";
+		return ret;
+	}
+
+	for(uint32_t i = 0; i < NUM_FIELDS; i++) {
+		std::string name = "bench_field_" + std::to_string(i);
+		auto type = i < NUM_INT_FIELDS ? ss_plugin_state_type::SS_PLUGIN_ST_UINT64
+		                               : ss_plugin_state_type::SS_PLUGIN_ST_STRING;
+		ret->fields[i] =
+		        in->tables->fields_ext->add_table_field(ret->thread_table, name.c_str(), type);
+		if(!ret->fields[i]) {
+			ret->lasterr = "can't add field " + name;
+			return ret;
+		}
+	}
+
+	ret->reader = *in->tables->reader_ext;
+	ret->writer = *in->tables->writer_ext;
+	s_plugin = ret;
+	*rc = SS_PLUGIN_SUCCESS;
+	return ret;
+}
+
+void plugin_destroy(ss_plugin_t* s) {
+	s_plugin = nullptr;
+	delete reinterpret_cast<plugin_state*>(s);
+}
+
+const char* plugin_get_last_error(ss_plugin_t* s) {
+	return ((plugin_state*)s)->lasterr.c_str();
+}
+
+ss_plugin_rc plugin_parse_event(ss_plugin_t* s,
+                                const ss_plugin_event_input* ev,
+                                const ss_plugin_event_parse_input* in) {
+	return SS_PLUGIN_SUCCESS;
+}
+
+bool register_bench_plugin(sinsp& inspector, benchmark::State& state) {
+	plugin_api api;
+	memset(&api, 0, sizeof(plugin_api));
+	api.get_required_api_version = plugin_get_required_api_version;
+	api.get_version = plugin_get_version;
+	api.get_description = plugin_get_description;
+	api.get_contact = plugin_get_contact;
+	api.get_name = plugin_get_name;
+	api.get_last_error = plugin_get_last_error;
+	api.init = plugin_init;
+	api.destroy = plugin_destroy;
+	api.get_parse_event_sources = plugin_get_parse_event_sources;
+	api.parse_event = plugin_parse_event;
+
+	std::string err;
+	auto pl = inspector.register_plugin(&api);
+	if(!pl->init("", err)) {
+		state.SkipWithError(err.c_str());
+		return false;
+	}
+	return true;
+}
+
+void write_fields(ss_plugin_table_entry_t* e, uint64_t val) {
+	ss_plugin_state_data data;
+	for(uint32_t i = 0; i < NUM_FIELDS; i++) {
+		if(i < NUM_INT_FIELDS) {
+			data.u64 = val + i;
+		} else {
+			data.str = "a value that does not fit in a small string";
+		}
+		s_plugin->writer.write_entry_field(s_plugin->thread_table, e, s_plugin->fields[i], &data);
+	}
+}
+
+}  // namespace
+
+// Creation of thread entries from a plugin that sets all the dynamic fields it defined.
+static void BM_plugin_table_new_entry(benchmark::State& state) {
+	sinsp inspector;
+	if(!register_bench_plugin(inspector, state)) {
+		return;
+	}
+
+	for(auto _ : state) {
+		auto e = s_plugin->writer.create_table_entry(s_plugin->thread_table);
+		write_fields(e, 1);
+		s_plugin->writer.destroy_table_entry(s_plugin->thread_table, e);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_plugin_table_new_entry);
+
+// Reads and writes of all the dynamic fields of `NUM_ENTRIES` thread entries from a plugin.
+static void BM_plugin_table_read_write(benchmark::State& state) {
+	sinsp inspector;
+	if(!register_bench_plugin(inspector, state)) {
+		return;
+	}
+
+	ss_plugin_state_data key;
+	for(key.s64 = 1; key.s64 <= NUM_ENTRIES; key.s64++) {
+		auto e = s_plugin->writer.create_table_entry(s_plugin->thread_table);
+		e = s_plugin->writer.add_table_entry(s_plugin->thread_table, &key, e);
+		write_fields(e, key.s64);
+		s_plugin->reader.release_table_entry(s_plugin->thread_table, e);
+	}
+
+	ss_plugin_state_data data;
+	for(auto _ : state) {
+		for(key.s64 = 1; key.s64 <= NUM_ENTRIES; key.s64++) {
+			auto e = s_plugin->reader.get_table_entry(s_plugin->thread_table, &key);
+			for(uint32_t i = 0; i < NUM_FIELDS; i++) {
+				s_plugin->reader.read_entry_field(s_plugin->thread_table,
+				                                  e,
+				                                  s_plugin->fields[i],
+				                                  &data);
+				if(i < NUM_INT_FIELDS) {
+					data.u64++;
+					s_plugin->writer.write_entry_field(s_plugin->thread_table,
+					                                   e,
+					                                   s_plugin->fields[i],
+					                                   &data);
+				}
+				benchmark::DoNotOptimize(data);
+			}
+			s_plugin->reader.release_table_entry(s_plugin->thread_table, e);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * NUM_ENTRIES * NUM_FIELDS);
+}
+BENCHMARK(BM_plugin_table_read_write);
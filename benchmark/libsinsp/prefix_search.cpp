@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/prefix_search.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const TOP_DIRS[] = {"/usr/lib", "/usr/share", "/etc", "/var/lib", "/opt", "/home"};
+
+// Search paths shaped like the ones of real rules: a few well-known top-level
+// directories with many package, application or user directories below them.
+std::vector<std::string> search_paths(size_t n) {
+	std::vector<std::string> paths;
+	for(size_t i = 0; i < n; i++) {
+		std::string p = TOP_DIRS[i % 6];
+		p += "/pkg" + std::to_string(i / 6);
+		if(i % 3 == 0) {
+			p += "/conf";
+		}
+		paths.push_back(p);
+	}
+	return paths;
+}
+
+// Paths opened by processes, about half of them under one of the search paths.
+std::vector<std::string> probe_paths(size_t n) {
+	static const char* const others[] = {"/proc/self/fd/3",
+	                                     "/tmp/tmp.aBcD1234",
+	                                     "/dev/null",
+	                                     "/usr/bin/bash",
+	                                     "/sys/fs/cgroup/memory.max"};
+	std::mt19937 rng(42);
+	std::vector<std::string> paths;
+	for(size_t i = 0; i < 1024; i++) {
+		if(i % 2) {
+			paths.push_back(others[rng() % 5]);
+			continue;
+		}
+		size_t pkg = rng() % n;
+		std::string p = TOP_DIRS[pkg % 6];
+		p += "/pkg" + std::to_string(pkg / 6);
+		p += pkg % 3 == 0 ? "/conf/settings.yaml" : "/lib/libfoo.so.1";
+		paths.push_back(p);
+	}
+	return paths;
+}
+
+}  // namespace
+
+// Matches of opened files against `state.range(0)` search paths, as for pmatch.
+static void BM_path_prefix_search_match(benchmark::State& state) {
+	path_prefix_search tree;
+	for(auto& p : search_paths(state.range(0))) {
+		tree.add_search_path(p);
+	}
+	auto probes = probe_paths(state.range(0));
+
+	size_t i = 0;
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(tree.match(probes[i++ % probes.size()].c_str()));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_path_prefix_search_match)->Arg(10)->Arg(1000)->Arg(100000);
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/dumper.h>
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t NUM_REPLAYS = 1000;
+constexpr uint32_t NUM_FILES = 4;
+
+const std::string s_capture = BENCHMARK_CAPTURES_PATH "/single_ipv6_conn.scap";
+
+// A large capture, made of `NUM_REPLAYS` replays of a real one shifted in time,
+// written as:
+// - the rotation of `NUM_FILES` compressed files
+// - a single compressed file
+// - a single uncompressed file, and the offsets that split it into
+//   `NUM_FILES` segments
+struct generated_capture {
+	std::string dir;
+	std::vector<std::string> files;
+	std::string single;
+	std::string uncompressed;
+	std::vector<uint64_t> offsets;
+
+	generated_capture() {
+		char tmpl[] = "/tmp/bench_savefile_XXXXXX";
+		dir = mkdtemp(tmpl);
+		for(uint32_t i = 0; i < NUM_FILES; i++) {
+			files.push_back(dir + "/rotation" + std::to_string(i) + ".scap");
+		}
+		single = dir + "/single.scap";
+		uncompressed = dir + "/uncompressed.scap";
+
+		uint64_t first_ts = 0;
+		uint64_t last_ts = 0;
+		replay([&](sinsp_evt* evt) {
+			first_ts = first_ts ? first_ts : evt->get_ts();
+			last_ts = evt->get_ts();
+		});
+
+		// The headers of all the files come from the original capture
+		sinsp inspector;
+		inspector.open_savefile(s_capture);
+		sinsp_dumper single_dumper;
+		single_dumper.open(&inspector, single, true);
+		sinsp_dumper uncompressed_dumper;
+		uncompressed_dumper.open(&inspector, uncompressed, false);
+		std::unique_ptr<sinsp_dumper> file_dumper;
+
+		for(uint32_t i = 0; i < NUM_REPLAYS; i++) {
+			if(i % (NUM_REPLAYS / NUM_FILES) == 0) {
+				file_dumper = std::make_unique<sinsp_dumper>();
+				file_dumper->open(&inspector, files[i / (NUM_REPLAYS / NUM_FILES)], true);
+				if(i > 0) {
+					offsets.push_back(uncompressed_dumper.next_write_position());
+				}
+			}
+
+			replay([&](sinsp_evt* evt) {
+				evt->get_scap_evt()->ts += i * (last_ts - first_ts + 1);
+				file_dumper->dump(evt);
+				single_dumper.dump(evt);
+				uncompressed_dumper.dump(evt);
+			});
+		}
+	}
+
+	~generated_capture() {
+		for(const auto& file : files) {
+			unlink(file.c_str());
+		}
+		unlink(single.c_str());
+		unlink(uncompressed.c_str());
+		rmdir(dir.c_str());
+	}
+
+	template<typename F>
+	static void replay(F&& cb) {
+		sinsp inspector;
+		inspector.open_savefile(s_capture);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res == SCAP_SUCCESS) {
+				cb(evt);
+			}
+		}
+	}
+};
+
+generated_capture& get_capture() {
+	static generated_capture capture;
+	return capture;
+}
+
+uint64_t read_capture(sinsp& inspector) {
+	uint64_t events = 0;
+	sinsp_evt* evt;
+	int32_t res;
+	while((res = inspector.next(&evt)) != SCAP_EOF && res != SCAP_FAILURE) {
+		if(res == SCAP_SUCCESS) {
+			events++;
+		}
+	}
+	return events;
+}
+
+}  // namespace
+
+// Reading a large capture split in the files of a rotation, decoded by
+// `state.range(0)` workers. 0 reads the same events from a single file without
+// workers.
+static void BM_savefile_parallel_files(benchmark::State& state) {
+	auto& capture = get_capture();
+	uint32_t num_workers = state.range(0);
+
+	uint64_t events = 0;
+	for(auto _ : state) {
+		sinsp inspector;
+		if(num_workers == 0) {
+			inspector.open_savefile(capture.single);
+		} else {
+			inspector.open_savefiles(capture.files, num_workers);
+		}
+		events += read_capture(inspector);
+		inspector.close();
+	}
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_savefile_parallel_files)
+        ->Arg(0)
+        ->Arg(1)
+        ->Arg(2)
+        ->Arg(4)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+
+// Same, with a single uncompressed file split in segments.
+static void BM_savefile_parallel_segments(benchmark::State& state) {
+	auto& capture = get_capture();
+	uint32_t num_workers = state.range(0);
+
+	uint64_t events = 0;
+	for(auto _ : state) {
+		sinsp inspector;
+		if(num_workers == 0) {
+			inspector.open_savefile(capture.uncompressed);
+		} else {
+			inspector.open_savefiles({capture.uncompressed}, num_workers, capture.offsets);
+		}
+		events += read_capture(inspector);
+		inspector.close();
+	}
+	state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_savefile_parallel_segments)
+        ->Arg(0)
+        ->Arg(1)
+        ->Arg(2)
+        ->Arg(4)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/dumper.h>
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+constexpr uint32_t NUM_REPLAYS = 1000;
+
+const std::string s_capture = BENCHMARK_CAPTURES_PATH "/single_ipv6_conn.scap";
+
+// `NUM_REPLAYS` replays of a real capture shifted in time, written compressed
+// and uncompressed, each one with its index
+struct indexed_capture {
+	std::string dir;
+	std::string files[2];
+	uint64_t first_ts = 0;
+	uint64_t last_ts = 0;
+
+	indexed_capture() {
+		char tmpl[] = "/tmp/bench_savefile_seek_XXXXXX";
+		dir = mkdtemp(tmpl);
+		files[0] = dir + "/uncompressed.scap";
+		files[1] = dir + "/compressed.scap";
+
+		replay([&](sinsp_evt* evt) {
+			first_ts = first_ts ? first_ts : evt->get_ts();
+			last_ts = evt->get_ts();
+		});
+		uint64_t duration = last_ts - first_ts + 1;
+
+		// The events written by the dumpers when they open take the timestamp
+		// of the last event
+		sinsp inspector;
+		inspector.open_savefile(s_capture);
+		sinsp_evt* evt;
+		while(inspector.next(&evt) != SCAP_SUCCESS) {
+		}
+		sinsp_dumper dumpers[2];
+		for(int i = 0; i < 2; i++) {
+			dumpers[i].set_index(files[i] + ".idx");
+			dumpers[i].open(&inspector, files[i], i == 1);
+		}
+		for(uint32_t i = 0; i < NUM_REPLAYS; i++) {
+			replay([&](sinsp_evt* evt) {
+				evt->get_scap_evt()->ts += i * duration;
+				for(auto& dumper : dumpers) {
+					dumper.dump(evt);
+				}
+			});
+		}
+		last_ts += (NUM_REPLAYS - 1) * duration;
+	}
+
+	~indexed_capture() {
+		for(const auto& file : files) {
+			unlink(file.c_str());
+			unlink((file + ".idx").c_str());
+		}
+		rmdir(dir.c_str());
+	}
+
+	template<typename F>
+	static void replay(F&& cb) {
+		sinsp inspector;
+		inspector.open_savefile(s_capture);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res == SCAP_SUCCESS) {
+				cb(evt);
+			}
+		}
+	}
+};
+
+}  // namespace
+
+// Time to the first event at the middle of a large capture, uncompressed (0) or
+// compressed (1), found by reading the capture from the start (0) or from the
+// closest checkpoint of its index (1).
+static void BM_savefile_seek(benchmark::State& state) {
+	static indexed_capture capture;
+	const std::string& file = capture.files[state.range(0)];
+	std::string index = state.range(1) ? file + ".idx" : "";
+	uint64_t start_ts = capture.first_ts + (capture.last_ts - capture.first_ts) / 2;
+
+	for(auto _ : state) {
+		sinsp inspector;
+		inspector.set_savefile_start(start_ts, 0, index);
+		inspector.open_savefile(file);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_SUCCESS && res != SCAP_EOF) {
+		}
+		if(res != SCAP_SUCCESS || evt->get_ts() < start_ts) {
+			state.SkipWithError("no event at the middle of the capture");
+			break;
+		}
+		inspector.close();
+	}
+}
+BENCHMARK(BM_savefile_seek)
+        ->ArgNames({"compressed", "index"})
+        ->Args({0, 0})
+        ->Args({0, 1})
+        ->Args({1, 0})
+        ->Args({1, 1})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
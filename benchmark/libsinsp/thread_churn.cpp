@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <libsinsp/dumper.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t NUM_PROCS = 5000;
+constexpr uint32_t FDS_PER_PROC = 4;
+
+class event_list {
+public:
+	template<typename... Args>
+	void add(int64_t tid, ppm_event_code type, uint32_t n, Args... args) {
+		char error[SCAP_LASTERR_SIZE];
+		scap_sized_buffer buf = {nullptr, 0};
+		size_t size = 0;
+		scap_event_encode_params(buf, &size, error, type, n, args...);
+		m_buffers.emplace_back(size);
+		buf = {m_buffers.back().data(), size};
+		scap_event_encode_params(buf, &size, error, type, n, args...);
+
+		scap_evt* evt = (scap_evt*)m_buffers.back().data();
+		evt->ts = 1000 + m_buffers.size();
+		evt->tid = tid;
+	}
+
+	std::vector<scap_evt*> events() {
+		std::vector<scap_evt*> ret;
+		for(auto& b : m_buffers) {
+			ret.push_back((scap_evt*)b.data());
+		}
+		return ret;
+	}
+
+private:
+	std::vector<std::vector<char>> m_buffers;
+};
+
+// Dump a capture of `NUM_PROCS` short-lived processes, each one opening and closing
+// `FDS_PER_PROC` files before exiting, once and share it between the benchmarks.
+const std::string& capture_path() {
+	static const std::string path = [] {
+		std::string p =
+		        (std::filesystem::temp_directory_path() / "bench.thread_churn.scap").string();
+		scap_const_sized_buffer empty = {nullptr, 0};
+		event_list list;
+		for(uint32_t i = 0; i < NUM_PROCS; i++) {
+			int64_t tid = 100 + i;
+			list.add(tid,
+			         PPME_SYSCALL_CLONE_20_X,
+			         21,
+			         (int64_t)0,
+			         "/bin/sh",
+			         empty,
+			         tid,
+			         tid,
+			         (int64_t)1,
+			         "/",
+			         (int64_t)1024,
+			         (uint64_t)0,
+			         (uint64_t)0,
+			         (uint32_t)0,
+			         (uint32_t)0,
+			         (uint32_t)0,
+			         "sh",
+			         empty,
+			         (uint32_t)0,
+			         (uint32_t)0,
+			         (uint32_t)0,
+			         tid,
+			         tid,
+			         (uint64_t)0);
+			for(int64_t fd = 3; fd < 3 + FDS_PER_PROC; fd++) {
+				list.add(tid, PPME_SYSCALL_OPEN_E, 3, "/tmp/file", (uint32_t)0, (uint32_t)0);
+				list.add(tid,
+				         PPME_SYSCALL_OPEN_X,
+				         6,
+				         fd,
+				         "/tmp/file",
+				         (uint32_t)0,
+				         (uint32_t)0,
+				         (uint32_t)0,
+				         (uint64_t)0);
+			}
+			for(int64_t fd = 3; fd < 3 + FDS_PER_PROC; fd++) {
+				list.add(tid, PPME_SYSCALL_CLOSE_E, 1, fd);
+				list.add(tid, PPME_SYSCALL_CLOSE_X, 1, (int64_t)0);
+			}
+			list.add(tid,
+			         PPME_PROCEXIT_1_E,
+			         5,
+			         (int64_t)0,
+			         (int64_t)0,
+			         (uint8_t)0,
+			         (uint8_t)0,
+			         (int64_t)0);
+		}
+
+		auto events = list.events();
+		scap_test_input_data data = {};
+		data.events = events.data();
+		data.event_count = events.size();
+
+		sinsp inspector;
+		inspector.open_test_input(&data, SINSP_MODE_TEST);
+		sinsp_dumper dumper;
+		dumper.open(&inspector, p, false);
+		sinsp_evt* evt;
+		while(inspector.next(&evt) == SCAP_SUCCESS) {
+			dumper.dump(evt);
+		}
+		dumper.close();
+		return p;
+	}();
+	return path;
+}
+
+double p99(std::vector<uint64_t>& samples) {
+	std::sort(samples.begin(), samples.end());
+	return samples.empty() ? 0 : samples[samples.size() * 99 / 100];
+}
+
+}  // namespace
+
+// Rate of thread and fd entries created while parsing a clone/exit-heavy capture, with
+// the p99 cost of the events that create and destroy them.
+static void BM_sinsp_thread_churn(benchmark::State& state) {
+	const std::string& path = capture_path();
+	std::vector<uint64_t> clone_ns;
+	std::vector<uint64_t> close_ns;
+	int64_t entries = 0;
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto inspector = std::make_unique<sinsp>();
+		inspector->open_savefile(path);
+		state.ResumeTiming();
+
+		sinsp_evt* evt;
+		auto start = std::chrono::steady_clock::now();
+		while(inspector->next(&evt) == SCAP_SUCCESS) {
+			auto end = std::chrono::steady_clock::now();
+			auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+			switch(evt->get_type()) {
+			case PPME_SYSCALL_CLONE_20_X:
+				clone_ns.push_back(ns);
+				entries++;
+				break;
+			case PPME_SYSCALL_OPEN_X:
+				entries++;
+				break;
+			case PPME_SYSCALL_CLOSE_X:
+				close_ns.push_back(ns);
+				break;
+			default:
+				break;
+			}
+			start = std::chrono::steady_clock::now();
+		}
+
+		state.PauseTiming();
+		inspector.reset();
+		state.ResumeTiming();
+	}
+
+	state.counters["entries/s"] = benchmark::Counter((double)entries, benchmark::Counter::kIsRate);
+	state.counters["p99_clone_x_ns"] = p99(clone_ns);
+	state.counters["p99_close_x_ns"] = p99(close_ns);
+}
+BENCHMARK(BM_sinsp_thread_churn)->Unit(benchmark::kMillisecond);
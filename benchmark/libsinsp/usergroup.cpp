@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <libsinsp/sinsp.h>
+#include <libsinsp/user.h>
+#include <benchmark/benchmark.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr uint32_t NUM_USERS = 50000;
+
+// A host root with a passwd file of `NUM_USERS` users
+struct host_root {
+	std::string path;
+
+	host_root() {
+		char tmpl[] = "/tmp/bench_usergroup_XXXXXX";
+		path = mkdtemp(tmpl);
+		mkdir((path + "/etc").c_str(), 0755);
+		std::ofstream ofs(path + "/etc/passwd");
+		for(uint32_t i = 0; i < NUM_USERS; i++) {
+			ofs << "user" << i << ":x:" << i << ":" << i << "::/home/user" << i << ":/bin/sh\n";
+		}
+	}
+
+	~host_root() {
+		unlink((path + "/etc/passwd").c_str());
+		rmdir((path + "/etc").c_str());
+		rmdir(path.c_str());
+	}
+};
+
+}  // namespace
+
+// Lookups of host users in the passwd file of a host root, for users that are
+// not in the user table yet, as it happens when the table is flushed.
+static void BM_usergroup_host_user_lookup(benchmark::State& state) {
+	static host_root root;
+	sinsp inspector;
+	inspector.set_host_root(root.path);
+	sinsp_usergroup_manager mgr(&inspector);
+
+	uint32_t uid = 0;
+	for(auto _ : state) {
+		uid = (uid + 7919) % NUM_USERS;
+		benchmark::DoNotOptimize(mgr.add_user("", -1, uid, 0, {}, {}, {}));
+		mgr.rm_user("", uid);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_usergroup_host_user_lookup);
@@ -57,6 +57,10 @@ static __always_inline int32_t maps__get_scap_tid() {
 	return g_settings.scap_tid;
 }
 
+static __always_inline uint32_t maps__get_wakeup_watermark() {
+	return g_settings.wakeup_watermark;
+}
+
 /*=============================== SETTINGS ===========================*/
 
 /*=============================== KERNEL CONFIGS ===========================*/
@@ -152,4 +156,33 @@ static __always_inline struct ringbuf_map *maps__get_ringbuf_map() {
 	return (struct ringbuf_map *)bpf_map_lookup_elem(&ringbuf_maps, &cpu_id);
 }
 
+/* Return the flag to use when submitting an event of `event_size` bytes into `rb`.
+ * We wake up the consumer only when this event makes the data pending in the ring buffer
+ * cross the configured watermark, so that a busy consumer is not notified for every event.
+ * When more CPUs share the same ring buffer a crossing could be missed, the consumer
+ * recovers after its wait timeout.
+ * `reserved` states whether the event space was already reserved in `rb`.
+ */
+static __always_inline uint64_t maps__get_ringbuf_wakeup_flag(struct ringbuf_map *rb,
+                                                              uint64_t event_size,
+                                                              bool reserved) {
+	uint32_t watermark = maps__get_wakeup_watermark();
+	if(watermark == 0) {
+		return BPF_RB_NO_WAKEUP;
+	}
+
+	/* Every record carries a header and is 8 bytes aligned. */
+	uint64_t record_size = (event_size + BPF_RINGBUF_HDR_SZ + 7) & ~7ULL;
+	uint64_t pending = bpf_ringbuf_query(rb, BPF_RB_AVAIL_DATA);
+	/* A reserved record is already accounted in the available data. */
+	if(reserved) {
+		pending = pending > record_size ? pending - record_size : 0;
+	}
+
+	if(pending < watermark && pending + record_size >= watermark) {
+		return BPF_RB_FORCE_WAKEUP;
+	}
+	return BPF_RB_NO_WAKEUP;
+}
+
 /*=============================== RINGBUF MAPS ===========================*/
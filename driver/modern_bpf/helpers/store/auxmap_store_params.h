@@ -142,9 +142,11 @@ static __always_inline void auxmap__submit_event(struct auxiliary_map *auxmap, v
 	}
 
 	/* `BPF_RB_NO_WAKEUP` means that we don't send to userspace a notification
-	 *  when a new event is in the buffer.
+	 *  when a new event is in the buffer. We notify it only when a wakeup watermark
+	 *  is configured and this event crosses it.
 	 */
-	int err = bpf_ringbuf_output(rb, auxmap->data, auxmap->payload_pos, BPF_RB_NO_WAKEUP);
+	uint64_t flag = maps__get_ringbuf_wakeup_flag(rb, auxmap->payload_pos, false);
+	int err = bpf_ringbuf_output(rb, auxmap->data, auxmap->payload_pos, flag);
 	if(err) {
 		counter->n_drops_buffer++;
 		compute_event_types_stats(auxmap->event_type, counter);
@@ -172,12 +172,20 @@ static __always_inline void ringbuf__rewrite_header_for_calibration(struct ringb
  * terminated.
  *
  * `BPF_RB_NO_WAKEUP` option allow to not notify the userspace
- * when a new event is submitted.
+ * when a new event is submitted. The userspace is notified only when
+ * a wakeup watermark is configured and this event crosses it.
  *
  * @param ringbuf pointer to the `ringbuf_struct`.
  */
 static __always_inline void ringbuf__submit_event(struct ringbuf_struct *ringbuf) {
-	bpf_ringbuf_submit(ringbuf->data, BPF_RB_NO_WAKEUP);
+	uint64_t flag = BPF_RB_NO_WAKEUP;
+	if(maps__get_wakeup_watermark() != 0) {
+		struct ringbuf_map *rb = maps__get_ringbuf_map();
+		if(rb) {
+			flag = maps__get_ringbuf_wakeup_flag(rb, ringbuf->reserved_event_size, true);
+		}
+	}
+	bpf_ringbuf_submit(ringbuf->data, flag);
 }
 
 /////////////////////////////////
@@ -33,6 +33,7 @@ struct capture_settings {
 	uint16_t fullcapture_port_range_end;   /* last interesting port */
 	uint16_t statsd_port;                  /* port for statsd metrics */
 	int32_t scap_tid;                      /* tid of the scap process */
+	uint32_t wakeup_watermark; /* pending bytes that wake up the consumer, 0 to never wake it */
 };
 
 /**
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <libscap/scap.h>
+
+#include <chrono>
+#include <cstring>
+#include <sys/eventfd.h>
+#include <sys/param.h>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libscap/ringbuffer/ringbuffer.h>
+}
+
+// Devices backed by plain memory, each holding a single block of events
+// with the given timestamps.
+class fake_devset {
+public:
+	explicit fake_devset(const std::vector<std::vector<uint64_t>>& timestamps):
+	        m_buffers(timestamps.size()),
+	        m_bufinfos(timestamps.size()) {
+		devset_init(&m_devset, timestamps.size(), m_lasterr);
+
+		for(uint32_t j = 0; j < timestamps.size(); j++) {
+			size_t block_size = timestamps[j].size() * sizeof(scap_evt);
+			m_buffers[j].resize(2 * block_size + 1);
+			for(uint32_t i = 0; i < timestamps[j].size(); i++) {
+				scap_evt evt = {};
+				evt.ts = timestamps[j][i];
+				evt.tid = j;
+				evt.len = sizeof(scap_evt);
+				memcpy(m_buffers[j].data() + i * sizeof(scap_evt), &evt, sizeof(scap_evt));
+			}
+
+			m_bufinfos[j].head = block_size;
+			m_bufinfos[j].tail = 0;
+			m_devset.m_devs[j].m_buffer = m_buffers[j].data();
+			m_devset.m_devs[j].m_buffer_size = m_buffers[j].size();
+			m_devset.m_devs[j].m_bufinfo = &m_bufinfos[j];
+		}
+	}
+
+	~fake_devset() {
+		for(uint32_t j = 0; j < m_devset.m_ndevs; j++) {
+			m_devset.m_devs[j].m_buffer = (char*)INVALID_MAPPING;
+			m_devset.m_devs[j].m_bufinfo = (ppm_ring_buffer_info*)INVALID_MAPPING;
+		}
+		devset_free(&m_devset);
+	}
+
+	scap_device_set* devset() { return &m_devset; }
+
+	const ppm_ring_buffer_info& bufinfo(uint32_t devid) const { return m_bufinfos[devid]; }
+
+private:
+	scap_device_set m_devset;
+	std::vector<std::vector<char>> m_buffers;
+	std::vector<ppm_ring_buffer_info> m_bufinfos;
+	char m_lasterr[SCAP_LASTERR_SIZE];
+};
+
+TEST(ringbuffer, next_merges_devices_in_timestamp_order) {
+	fake_devset devs({{1, 5, 9, 13}, {2, 3, 4}, {}, {10, 11, 12, 14, 15}, {6, 7, 8}});
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+
+	// The first call reads a block from every device.
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+
+	for(uint64_t expected_ts = 1; expected_ts <= 15; expected_ts++) {
+		ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+		ASSERT_EQ((uint64_t)evt->ts, expected_ts);
+		ASSERT_EQ((uint64_t)evt->tid, devid);
+	}
+
+	// All the blocks are consumed, we need a new refill.
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+	ASSERT_EQ(devid, 65535);
+}
+
+TEST(ringbuffer, next_breaks_ties_by_device_id) {
+	fake_devset devs({{3, 3}, {1, 3}, {3}});
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+
+	std::vector<std::pair<uint64_t, uint16_t>> expected = {{1, 1}, {3, 0}, {3, 0}, {3, 1}, {3, 2}};
+	for(const auto& e : expected) {
+		ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+		ASSERT_EQ((uint64_t)evt->ts, e.first);
+		ASSERT_EQ(devid, e.second);
+	}
+}
+
+TEST(ringbuffer, tail_advances_only_after_last_event_is_released) {
+	fake_devset devs({{1}, {2, 3}});
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ(devid, 0);
+	// The caller still owns the event, the consumer position can't move yet.
+	ASSERT_EQ((uint32_t)devs.bufinfo(0).tail, 0u);
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ(devid, 1);
+	ASSERT_EQ((uint32_t)devs.bufinfo(0).tail, (uint32_t)sizeof(scap_evt));
+	ASSERT_EQ((uint32_t)devs.bufinfo(1).tail, 0u);
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ((uint64_t)evt->ts, 3);
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+	ASSERT_EQ((uint32_t)devs.bufinfo(1).tail, 2 * (uint32_t)sizeof(scap_evt));
+}
+
+TEST(ringbuffer, invalidated_heap_is_rebuilt) {
+	fake_devset devs({{1, 4}, {2, 3}});
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ((uint64_t)evt->ts, 1);
+
+	// Drop the block of the first device, as the kmod engine does when flushing the buffers.
+	scap_device* dev = &devs.devset()->m_devs[0];
+	ADVANCE_TO_EVT(dev, NEXT_EVENT(dev));
+	devset_invalidate_heap(devs.devset());
+
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ((uint64_t)evt->ts, 2);
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ((uint64_t)evt->ts, 3);
+	ASSERT_EQ(ringbuffer_next(devs.devset(), &evt, &devid, &flags), SCAP_TIMEOUT);
+}
+
+TEST(ringbuffer, next_batch_stops_before_releasing_a_block) {
+	fake_devset devs({{1, 2, 5}, {3, 4}});
+	scap_evt* evts[10];
+	uint16_t devids[10];
+	uint32_t flags[10];
+	uint32_t nevents;
+
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 10, &nevents),
+	          SCAP_TIMEOUT);
+	ASSERT_EQ(nevents, 0u);
+
+	// The block of the second device is exhausted after ts 4.
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 10, &nevents),
+	          SCAP_SUCCESS);
+	ASSERT_EQ(nevents, 4u);
+	for(uint32_t i = 0; i < nevents; i++) {
+		ASSERT_EQ((uint64_t)evts[i]->ts, i + 1);
+	}
+	// All the returned events are still owned by the caller.
+	ASSERT_EQ((uint32_t)devs.bufinfo(0).tail, 0u);
+	ASSERT_EQ((uint32_t)devs.bufinfo(1).tail, 0u);
+
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 10, &nevents),
+	          SCAP_SUCCESS);
+	ASSERT_EQ(nevents, 1u);
+	ASSERT_EQ((uint64_t)evts[0]->ts, 5);
+	ASSERT_EQ(devids[0], 0);
+	ASSERT_EQ((uint32_t)devs.bufinfo(1).tail, 2 * (uint32_t)sizeof(scap_evt));
+
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 10, &nevents),
+	          SCAP_TIMEOUT);
+	ASSERT_EQ(nevents, 0u);
+}
+
+TEST(ringbuffer, next_batch_honors_max_events) {
+	fake_devset devs({{1, 3, 5}, {2, 4, 6}});
+	scap_evt* evts[2];
+	uint16_t devids[2];
+	uint32_t flags[2];
+	uint32_t nevents;
+
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 2, &nevents),
+	          SCAP_TIMEOUT);
+
+	for(uint64_t expected_ts = 1; expected_ts <= 3; expected_ts += 2) {
+		ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 2, &nevents),
+		          SCAP_SUCCESS);
+		ASSERT_EQ(nevents, 2u);
+		ASSERT_EQ((uint64_t)evts[0]->ts, expected_ts);
+		ASSERT_EQ((uint64_t)evts[1]->ts, expected_ts + 1);
+	}
+
+	// The first device runs out of events with ts 5.
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 2, &nevents),
+	          SCAP_SUCCESS);
+	ASSERT_EQ(nevents, 1u);
+	ASSERT_EQ((uint64_t)evts[0]->ts, 5);
+	ASSERT_EQ(ringbuffer_next_batch(devs.devset(), evts, devids, flags, 2, &nevents),
+	          SCAP_SUCCESS);
+	ASSERT_EQ(nevents, 1u);
+	ASSERT_EQ((uint64_t)evts[0]->ts, 6);
+}
+
+TEST(ringbuffer, refill_blocks_on_device_fds) {
+	fake_devset devs({{1}, {2}});
+	scap_device_set* devset = devs.devset();
+	for(uint32_t j = 0; j < devset->m_ndevs; j++) {
+		devset->m_devs[j].m_fd = eventfd(0, EFD_NONBLOCK);
+		ASSERT_NE(devset->m_devs[j].m_fd, INVALID_FD);
+	}
+	ASSERT_EQ(devset_enable_poll(devset), SCAP_SUCCESS);
+
+	// The buffers are below the empty threshold, so we wait until a device signals new data.
+	std::thread producer([devset] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		uint64_t one = 1;
+		ASSERT_EQ(write(devset->m_devs[1].m_fd, &one, sizeof(one)), (ssize_t)sizeof(one));
+	});
+
+	auto start = std::chrono::steady_clock::now();
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+	ASSERT_EQ(ringbuffer_next(devset, &evt, &devid, &flags), SCAP_TIMEOUT);
+	ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+	producer.join();
+
+	ASSERT_NE(devset->m_pollfds, nullptr);
+	ASSERT_EQ(ringbuffer_next(devset, &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ((uint64_t)evt->ts, 1);
+}
+
+TEST(ringbuffer, refill_falls_back_to_sleep_when_fds_cannot_be_polled) {
+	fake_devset devs({{1}, {2}});
+	scap_device_set* devset = devs.devset();
+	for(uint32_t j = 0; j < devset->m_ndevs; j++) {
+		devset->m_devs[j].m_fd = eventfd(0, EFD_NONBLOCK);
+	}
+	ASSERT_EQ(devset_enable_poll(devset), SCAP_SUCCESS);
+
+	// A closed fd is reported as `POLLNVAL`.
+	close(devset->m_devs[0].m_fd);
+	devset->m_devs[0].m_fd = INVALID_FD;
+
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+	ASSERT_EQ(ringbuffer_next(devset, &evt, &devid, &flags), SCAP_TIMEOUT);
+	ASSERT_EQ(devset->m_pollfds, nullptr);
+	ASSERT_EQ(ringbuffer_next(devset, &evt, &devid, &flags), SCAP_SUCCESS);
+	ASSERT_EQ((uint64_t)evt->ts, 1);
+}
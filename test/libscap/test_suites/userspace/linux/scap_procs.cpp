@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <libscap/scap.h>
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C" {
+#include <libscap/scap-int.h>
+#include <libscap/scap_platform.h>
+#include <libscap/linux/scap_linux_int.h>
+#include <libscap/linux/scap_linux_platform.h>
+}
+
+// A /proc-like directory with `num_procs` processes, each one with `num_tasks`
+// additional threads and `num_fds` open files.
+class fake_proc_tree {
+public:
+	fake_proc_tree(uint32_t num_procs, uint32_t num_tasks, uint32_t num_fds) {
+		char path[] = "/tmp/scap_procs_XXXXXX";
+		m_path = mkdtemp(path);
+		for(uint32_t i = 0; i < num_procs; i++) {
+			uint64_t pid = 1000 + i * (num_tasks + 1);
+			std::string dir = m_path + "/" + std::to_string(pid);
+			add_thread(dir, pid, pid);
+
+			for(uint32_t j = 0; j <= num_tasks; j++) {
+				add_thread(dir + "/task/" + std::to_string(pid + j), pid, pid + j);
+			}
+
+			mkdir((dir + "/fd").c_str(), 0755);
+			for(uint32_t fd = 0; fd < num_fds; fd++) {
+				symlink("/dev/null", (dir + "/fd/" + std::to_string(fd)).c_str());
+			}
+		}
+	}
+
+	~fake_proc_tree() {
+		nftw(
+		        m_path.c_str(),
+		        [](const char* p, const struct stat*, int, struct FTW*) { return remove(p); },
+		        16,
+		        FTW_DEPTH | FTW_PHYS);
+	}
+
+	char* path() { return m_path.data(); }
+
+private:
+	static void write_file(const std::string& path, const std::string& content) {
+		std::ofstream(path, std::ios::binary) << content;
+	}
+
+	static void add_thread(const std::string& dir, uint64_t pid, uint64_t tid) {
+		std::string pid_s = std::to_string(pid);
+		std::string tid_s = std::to_string(tid);
+		std::string uid_s = std::to_string(getuid());
+		std::string gid_s = std::to_string(getgid());
+
+		mkdir(dir.c_str(), 0755);
+		mkdir((dir + "/task").c_str(), 0755);
+		symlink("/bin/sh", (dir + "/exe").c_str());
+		symlink("/", (dir + "/cwd").c_str());
+		symlink("/", (dir + "/root").c_str());
+		write_file(dir + "/cmdline", std::string("sh\0-c\0true\0", 11));
+		write_file(dir + "/environ", std::string("PATH=/bin\0HOME=/\0", 17));
+		write_file(dir + "/status",
+		           "Name:\tsh\nTgid:\t" + pid_s + "\nPid:\t" + tid_s + "\nPPid:\t1\nUid:\t" +
+		                   uid_s + "\t" + uid_s + "\t" + uid_s + "\t" + uid_s + "\nGid:\t" +
+		                   gid_s + "\t" + gid_s + "\t" + gid_s + "\t" + gid_s +
+		                   "\nNStgid:\t" + pid_s + "\t" + pid_s + "\nNSpid:\t" + tid_s + "\t" +
+		                   tid_s + "\nNSpgid:\t" + pid_s + "\t" + pid_s + "\nVmSize:\t1000 kB\n" +
+		                   "VmRSS:\t100 kB\nVmSwap:\t0 kB\nCapInh:\t0\nCapPrm:\t0\nCapEff:\t0\n");
+		write_file(dir + "/stat",
+		           tid_s + " (sh) S 1 " + pid_s + " " + pid_s + " 0 -1 0 10 0 1 0\n");
+		write_file(dir + "/loginuid", uid_s + "\n");
+	}
+
+	std::string m_path;
+};
+
+// (tid, number of fds) for each thread, in the order they were added to the table
+static std::vector<std::pair<uint64_t, uint32_t>> scan(char* procdirname, uint32_t num_threads) {
+	char lasterr[SCAP_LASTERR_SIZE];
+	std::vector<std::pair<uint64_t, uint32_t>> threads;
+
+	struct scap_platform* platform = scap_linux_alloc_platform(NULL, NULL);
+	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
+	linux_platform->m_lasterr = lasterr;
+	linux_platform->m_proc_scan_num_threads = num_threads;
+	EXPECT_EQ(scap_cgroup_interface_init(&linux_platform->m_cgroups, "", lasterr, false),
+	          SCAP_SUCCESS);
+
+	EXPECT_EQ(scap_linux_scan_proc_table(linux_platform,
+	                                     &platform->m_proclist,
+	                                     procdirname,
+	                                     lasterr),
+	          SCAP_SUCCESS);
+
+	scap_threadinfo *tinfo, *ttinfo;
+	HASH_ITER(hh, platform->m_proclist.m_proclist, tinfo, ttinfo) {
+		threads.emplace_back(tinfo->tid, HASH_COUNT(tinfo->fdlist));
+	}
+
+	scap_platform_close(platform);
+	scap_platform_free(platform);
+	return threads;
+}
+
+TEST(scap_procs, parallel_scan_matches_serial_scan) {
+	fake_proc_tree tree(64, 3, 8);
+
+	auto serial = scan(tree.path(), 0);
+	ASSERT_EQ(serial.size(), 64 * 4);
+	ASSERT_EQ(serial[0].second, 8);
+	ASSERT_EQ(serial[1].second, 0);
+
+	for(uint32_t num_threads : {2, 4, 7}) {
+		ASSERT_EQ(scan(tree.path(), num_threads), serial) << num_threads << " threads";
+	}
+}
+
+TEST(scap_procs, lazy_scan_defers_fd_details) {
+	fake_proc_tree tree(2, 0, 4);
+	char lasterr[SCAP_LASTERR_SIZE];
+
+	struct scap_platform* platform = scap_linux_alloc_platform(NULL, NULL);
+	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
+	linux_platform->m_lasterr = lasterr;
+	linux_platform->m_proc_scan_lazy_fds = true;
+	ASSERT_EQ(scap_cgroup_interface_init(&linux_platform->m_cgroups, "", lasterr, false),
+	          SCAP_SUCCESS);
+
+	ASSERT_EQ(scap_linux_scan_proc_table(linux_platform,
+	                                     &platform->m_proclist,
+	                                     tree.path(),
+	                                     lasterr),
+	          SCAP_SUCCESS);
+
+	int64_t pid = 1000;
+	scap_threadinfo* tinfo;
+	HASH_FIND_INT64(platform->m_proclist.m_proclist, &pid, tinfo);
+	ASSERT_NE(tinfo, nullptr);
+	ASSERT_EQ(HASH_COUNT(tinfo->fdlist), 4);
+
+	scap_fdinfo *fdi, *tfdi;
+	HASH_ITER(hh, tinfo->fdlist, fdi, tfdi) {
+		ASSERT_EQ(fdi->type, SCAP_FD_FILE_V2);
+		ASSERT_STREQ(fdi->info.regularinfo.fname, "");
+	}
+
+	std::string procdir = std::string(tree.path()) + "/1000/";
+	scap_fdinfo resolved = {};
+	resolved.fd = 2;
+	ASSERT_EQ(scap_fd_read_fd(procdir.data(), 1000, &resolved, lasterr), SCAP_SUCCESS);
+	ASSERT_EQ(resolved.type, SCAP_FD_FILE_V2);
+	ASSERT_STREQ(resolved.info.regularinfo.fname, "/dev/null");
+
+	scap_fdinfo missing = {};
+	missing.fd = 42;
+	ASSERT_EQ(scap_fd_read_fd(procdir.data(), 1000, &missing, lasterr), SCAP_NOTFOUND);
+
+	scap_platform_close(platform);
+	scap_platform_free(platform);
+}
+
+TEST(scap_procs, parallel_scan_of_missing_dir) {
+	char lasterr[SCAP_LASTERR_SIZE];
+	char procdirname[] = "/tmp/scap_procs_missing";
+
+	struct scap_platform* platform = scap_linux_alloc_platform(NULL, NULL);
+	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
+	linux_platform->m_lasterr = lasterr;
+	linux_platform->m_proc_scan_num_threads = 4;
+	ASSERT_EQ(scap_cgroup_interface_init(&linux_platform->m_cgroups, "", lasterr, false),
+	          SCAP_SUCCESS);
+
+	ASSERT_EQ(scap_linux_scan_proc_table(linux_platform,
+	                                     &platform->m_proclist,
+	                                     procdirname,
+	                                     lasterr),
+	          SCAP_NOTFOUND);
+	ASSERT_EQ(platform->m_proclist.m_proclist, nullptr);
+
+	scap_platform_close(platform);
+	scap_platform_free(platform);
+}
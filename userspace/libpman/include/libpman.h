@@ -68,6 +68,17 @@ int pman_init_state(falcosecurity_log_fn log_fn,
  */
 void pman_clear_state(void);
 
+/**
+ * @brief Enable or disable the incremental merge of the ring buffers.
+ * When enabled, the first event of every ring buffer is cached between two
+ * consume operations and we poll again only the ring buffer we have just
+ * consumed and the ones that were empty. This avoids reading the producer
+ * positions of all the ring buffers for every event.
+ *
+ * @param enable true to enable the incremental merge.
+ */
+void pman_set_incremental_merge(bool enable);
+
 /**
  * @brief Return the number of allocated ring buffers.
  *
@@ -277,6 +288,37 @@ int pman_finalize_ringbuf_array_after_loading(void);
  */
 void pman_consume_first_event(void** event_ptr, int16_t* buffer_id);
 
+/**
+ * @brief Same as `pman_consume_first_event` but returns up to
+ * `max_events` events in timestamp order with a single call.
+ * The consumer positions are published to the kernel only at the
+ * next consume operation, so all the returned events stay valid
+ * until then.
+ *
+ * @param event_ptrs array of at least `max_events` entries filled
+ * with the pointers to the events.
+ * @param buffer_ids array of at least `max_events` entries filled
+ * with the ids of the ring buffers the events come from.
+ * @param max_events maximum number of events to return.
+ * @param nevents number of events returned, `0` if all the ring
+ * buffers are empty.
+ */
+void pman_consume_batch(void** event_ptrs,
+                        int16_t* buffer_ids,
+                        uint32_t max_events,
+                        uint32_t* nevents);
+
+/**
+ * @brief Block until the driver signals new events in one of the
+ * ring buffers or `timeout_ms` expires. The driver signals new
+ * events only if a wakeup watermark is set with
+ * `pman_set_wakeup_watermark`.
+ *
+ * @param timeout_ms maximum time to wait in milliseconds.
+ * @return `0` when woken up or on timeout, `errno` in case of error.
+ */
+int pman_wait_for_events(int timeout_ms);
+
 /////////////////////////////
 // CAPTURE (EXCHANGE VALUES WITH BPF SIDE)
 /////////////////////////////
@@ -381,6 +423,16 @@ void pman_set_statsd_port(uint16_t statsd_port);
  */
 void pman_set_scap_tid(int32_t scap_tid);
 
+/**
+ * @brief Ask driver to wake up the consumer waiting in
+ * `pman_wait_for_events` when a ring buffer holds at least
+ * `wakeup_watermark` bytes.
+ *
+ * @param wakeup_watermark number of pending bytes, `0` never
+ * wakes up the consumer.
+ */
+void pman_set_wakeup_watermark(uint32_t wakeup_watermark);
+
 /**
  * @brief Get API version to check it a runtime.
  *
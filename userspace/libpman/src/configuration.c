@@ -22,6 +22,7 @@ limitations under the License.
 #include <sys/utsname.h>
 #include <fcntl.h> /* Definition of AT_* constants */
 #include <unistd.h>
+#include <string.h>
 
 static int libbpf_print(enum libbpf_print_level level, const char *format, va_list args) {
 	enum falcosecurity_log_severity sev;
@@ -77,6 +78,10 @@ void pman_clear_state() {
 	g_state.buffer_bytes_dim = 0;
 	g_state.last_ring_read = -1;
 	g_state.last_event_size = 0;
+	g_state.incremental_merge = false;
+	g_state.ring_heads = NULL;
+	g_state.hold_consumer_pos = false;
+	g_state.consumer_pos_held = false;
 
 	for(int j = 0; j < MODERN_BPF_PROG_ATTACHED_MAX; j++) {
 		g_state.attached_progs_fds[j] = -1;
@@ -188,6 +193,15 @@ int pman_init_state(falcosecurity_log_fn log_fn,
 	return 0;
 }
 
+void pman_set_incremental_merge(bool enable) {
+	g_state.incremental_merge = enable;
+
+	/* Drop the cached events, the rings will be polled again at the next consume operation. */
+	if(g_state.ring_heads != NULL) {
+		memset(g_state.ring_heads, 0, g_state.n_required_buffers * sizeof(struct ring_head));
+	}
+}
+
 int pman_get_required_buffers() {
 	return g_state.n_required_buffers;
 }
@@ -77,6 +77,11 @@ void pman_close_probe() {
 		g_state.prod_pos = NULL;
 	}
 
+	if(g_state.ring_heads) {
+		free(g_state.ring_heads);
+		g_state.ring_heads = NULL;
+	}
+
 	if(g_state.skel) {
 		bpf_probe__detach(g_state.skel);
 		bpf_probe__destroy(g_state.skel);
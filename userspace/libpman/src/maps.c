@@ -95,6 +95,10 @@ void pman_set_scap_tid(int32_t scap_tid) {
 	g_state.skel->bss->g_settings.scap_tid = scap_tid;
 }
 
+void pman_set_wakeup_watermark(uint32_t wakeup_watermark) {
+	g_state.skel->bss->g_settings.wakeup_watermark = wakeup_watermark;
+}
+
 void pman_mark_single_64bit_syscall(int intersting_syscall_id, bool interesting) {
 	g_state.skel->bss->g_64bit_interesting_syscalls_table[intersting_syscall_id] = interesting;
 }
@@ -21,7 +21,9 @@ limitations under the License.
 #include <unistd.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <sys/mman.h>
+#include <sys/epoll.h>
 #include <ringbuffer_debug_macro.h>
 #include <driver/ppm_events_public.h>
 
@@ -70,8 +72,10 @@ static int allocate_consumer_producer_positions() {
 	g_state.ringbuf_pos = 0;
 	g_state.cons_pos = (unsigned long *)calloc(g_state.n_required_buffers, sizeof(unsigned long));
 	g_state.prod_pos = (unsigned long *)calloc(g_state.n_required_buffers, sizeof(unsigned long));
-	if(g_state.cons_pos == NULL || g_state.prod_pos == NULL) {
-		pman_print_error("failed to alloc memory for cons_pos and prod_pos");
+	g_state.ring_heads =
+	        (struct ring_head *)calloc(g_state.n_required_buffers, sizeof(struct ring_head));
+	if(g_state.cons_pos == NULL || g_state.prod_pos == NULL || g_state.ring_heads == NULL) {
+		pman_print_error("failed to alloc memory for cons_pos, prod_pos and ring_heads");
 		return errno;
 	}
 	return 0;
@@ -236,6 +240,17 @@ clean_percpu_ring_buffers:
 	return errno;
 }
 
+/* While a batch is in progress the kernel must not reuse the space of the events
+ * we have already returned, so we only move the consumer position locally.
+ */
+static inline void ringbuf__publish_consumer_pos(struct ring *r, int pos) {
+	if(g_state.hold_consumer_pos) {
+		g_state.consumer_pos_held = true;
+		return;
+	}
+	smp_store_release(r->consumer_pos, g_state.cons_pos[pos]);
+}
+
 static inline void *ringbuf__get_first_ring_event(struct ring *r, int pos) {
 	int *len_ptr = NULL;
 	int len = 0;
@@ -269,11 +284,35 @@ static inline void *ringbuf__get_first_ring_event(struct ring *r, int pos) {
 	} else {
 		/* Discard the event kernel side and update the consumer position */
 		g_state.cons_pos[pos] += roundup_len(len);
-		smp_store_release(r->consumer_pos, g_state.cons_pos[pos]);
+		ringbuf__publish_consumer_pos(r, pos);
 		return NULL;
 	}
 }
 
+/* If the last consume operation was successful we can push the consumer position */
+static inline void ringbuf__release_last_event(struct ring_buffer *rb) {
+	if(g_state.last_ring_read != -1) {
+		struct ring *r = rb->rings[g_state.last_ring_read];
+		g_state.cons_pos[g_state.last_ring_read] += g_state.last_event_size;
+		ringbuf__publish_consumer_pos(r, g_state.last_ring_read);
+	}
+}
+
+/* Publish the consumer positions held back by the last batch, the caller is done with its events */
+static inline void ringbuf__publish_held_consumer_pos(struct ring_buffer *rb) {
+	if(!g_state.consumer_pos_held || g_state.hold_consumer_pos) {
+		return;
+	}
+
+	for(uint16_t pos = 0; pos < rb->ring_cnt; pos++) {
+		struct ring *r = rb->rings[pos];
+		if(*r->consumer_pos != g_state.cons_pos[pos]) {
+			smp_store_release(r->consumer_pos, g_state.cons_pos[pos]);
+		}
+	}
+	g_state.consumer_pos_held = false;
+}
+
 static void ringbuf__consume_first_event(struct ring_buffer *rb,
                                          struct ppm_evt_hdr **event_ptr,
                                          int16_t *buffer_id) {
@@ -282,12 +321,7 @@ static void ringbuf__consume_first_event(struct ring_buffer *rb,
 	int tmp_ring = -1;
 	unsigned long tmp_cons_increment = 0;
 
-	/* If the last consume operation was successful we can push the consumer position */
-	if(g_state.last_ring_read != -1) {
-		struct ring *r = rb->rings[g_state.last_ring_read];
-		g_state.cons_pos[g_state.last_ring_read] += g_state.last_event_size;
-		smp_store_release(r->consumer_pos, g_state.cons_pos[g_state.last_ring_read]);
-	}
+	ringbuf__release_last_event(rb);
 
 	R_D_MSG("\n-----------------------------\nIterate over all the buffers\n");
 	for(uint16_t pos = 0; pos < rb->ring_cnt; pos++) {
@@ -316,7 +350,85 @@ static void ringbuf__consume_first_event(struct ring_buffer *rb,
 	R_D_EVENT(*event_ptr, tmp_ring);
 }
 
+/* Same as `ringbuf__consume_first_event` but the first event of every ring is cached
+ * between two calls. An event stays committed until we move the consumer position, so we
+ * only need to poll again the ring we have just consumed and the rings that were empty:
+ * the producer positions of the other rings are not touched.
+ */
+static void ringbuf__consume_first_cached_event(struct ring_buffer *rb,
+                                                struct ppm_evt_hdr **event_ptr,
+                                                int16_t *buffer_id) {
+	uint64_t min_ts = 0xffffffffffffffffLL;
+	struct ring_head *heads = g_state.ring_heads;
+	int tmp_ring = -1;
+
+	ringbuf__release_last_event(rb);
+	if(g_state.last_ring_read != -1) {
+		heads[g_state.last_ring_read].event = NULL;
+	}
+
+	R_D_MSG("\n-----------------------------\nIterate over all the cached buffers\n");
+	for(uint16_t pos = 0; pos < rb->ring_cnt; pos++) {
+		if(heads[pos].event == NULL) {
+			heads[pos].event = ringbuf__get_first_ring_event(rb->rings[pos], pos);
+			R_D_EVENT(heads[pos].event, pos);
+
+			/* if NULL search for events in another buffer */
+			if(heads[pos].event == NULL) {
+				continue;
+			}
+			heads[pos].ts = heads[pos].event->ts;
+			heads[pos].size = g_state.last_event_size;
+		}
+
+		if(heads[pos].ts < min_ts) {
+			min_ts = heads[pos].ts;
+			tmp_ring = pos;
+			R_D_MSG("Found new min with ts '%ld' on buffer %d\n", min_ts, pos);
+		}
+	}
+
+	*event_ptr = tmp_ring != -1 ? heads[tmp_ring].event : NULL;
+	*buffer_id = tmp_ring;
+	g_state.last_ring_read = tmp_ring;
+	g_state.last_event_size = tmp_ring != -1 ? heads[tmp_ring].size : 0;
+	R_D_MSG("Send event -> ");
+	R_D_EVENT(*event_ptr, tmp_ring);
+}
+
 /* Consume */
 void pman_consume_first_event(void **event_ptr, int16_t *buffer_id) {
+	ringbuf__publish_held_consumer_pos(g_state.rb_manager);
+	if(g_state.incremental_merge) {
+		ringbuf__consume_first_cached_event(g_state.rb_manager,
+		                                    (struct ppm_evt_hdr **)event_ptr,
+		                                    buffer_id);
+		return;
+	}
 	ringbuf__consume_first_event(g_state.rb_manager, (struct ppm_evt_hdr **)event_ptr, buffer_id);
 }
+
+void pman_consume_batch(void **event_ptrs,
+                        int16_t *buffer_ids,
+                        uint32_t max_events,
+                        uint32_t *nevents) {
+	*nevents = 0;
+	while(*nevents < max_events) {
+		pman_consume_first_event(&event_ptrs[*nevents], &buffer_ids[*nevents]);
+		if(event_ptrs[*nevents] == NULL) {
+			break;
+		}
+		(*nevents)++;
+		/* The next iterations must not release the events we have already returned. */
+		g_state.hold_consumer_pos = true;
+	}
+	g_state.hold_consumer_pos = false;
+}
+
+int pman_wait_for_events(int timeout_ms) {
+	struct ring_buffer *rb = g_state.rb_manager;
+	if(epoll_wait(rb->epoll_fd, rb->events, rb->ring_cnt, timeout_ms) < 0 && errno != EINTR) {
+		return errno;
+	}
+	return 0;
+}
@@ -39,6 +39,13 @@ limitations under the License.
 
 struct metrics_v2;
 
+/* First event of a ring buffer, cached between two consume operations. */
+struct ring_head {
+	struct ppm_evt_hdr* event; /* `NULL` if the ring had no events the last time we polled it. */
+	uint64_t ts;               /* timestamp of `event`. */
+	unsigned long size;        /* size of `event`, used to increment the consumer position. */
+};
+
 struct internal_state {
 	struct bpf_probe* skel;         /* bpf skeleton with all programs and maps. */
 	struct ring_buffer* rb_manager; /* ring_buffer manager with all per-CPU ringbufs. */
@@ -58,6 +65,12 @@ struct internal_state {
 	               there were no successful reads. */
 	unsigned long last_event_size; /* Last event correctly read. Could be `0` if there were no
 	                                  successful reads. */
+	bool incremental_merge;        /* If true we poll only the ring we have just consumed and the
+	                                  empty ones, the first event of the others is cached. */
+	struct ring_head* ring_heads;  /* every ringbuf has a cached first event. */
+	bool hold_consumer_pos;        /* If true the consumer positions are moved only locally, the
+	                                  events returned by a batch must stay in the rings. */
+	bool consumer_pos_held;        /* If true some consumer positions still need to be published. */
 
 	/* Stats v2 utilities */
 	int32_t attached_progs_fds[MODERN_BPF_PROG_ATTACHED_MAX]; /* file descriptors of attached
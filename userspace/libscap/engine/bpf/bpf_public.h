@@ -27,6 +27,10 @@ struct scap_bpf_engine_params {
 	                                 ///< note: this buffer will be mapped twice in the process
 	                                 ///< virtual memory, so pay attention to its size.
 	const char* bpf_probe;           ///<  The path to the BPF probe object file.
+	uint32_t wakeup_watermark;  ///< When not `0` the consumer blocks on the per-CPU perf buffers
+	                            ///< instead of sleeping with an exponential backoff, the kernel
+	                            ///< wakes it up every `wakeup_watermark` bytes written into a
+	                            ///< buffer. `0` keeps the sleep backoff.
 };
 
 #ifdef __cplusplus
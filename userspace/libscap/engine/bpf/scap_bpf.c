@@ -1528,6 +1528,12 @@ int32_t scap_bpf_load(struct bpf_engine *handle, const char *bpf_probe, scap_ope
 		        .type = PERF_TYPE_SOFTWARE,
 		        .config = PERF_COUNT_SW_BPF_OUTPUT,
 		};
+		if(bpf_args->wakeup_watermark != 0) {
+			// Wake up the poll waiters every `wakeup_watermark` bytes instead of the
+			// default half buffer.
+			attr.watermark = 1;
+			attr.wakeup_watermark = bpf_args->wakeup_watermark;
+		}
 		int pmu_fd = 0;
 		int ret = 0;
 
@@ -1915,6 +1921,20 @@ static int32_t next(struct scap_engine_handle engine,
 	return ringbuffer_next(&HANDLE(engine)->m_dev_set, pevent, pdevid, pflags);
 }
 
+static int32_t next_batch(struct scap_engine_handle engine,
+                          scap_evt **pevents,
+                          uint16_t *pdevids,
+                          uint32_t *pflags,
+                          uint32_t max_events,
+                          uint32_t *nevents) {
+	return ringbuffer_next_batch(&HANDLE(engine)->m_dev_set,
+	                             pevents,
+	                             pdevids,
+	                             pflags,
+	                             max_events,
+	                             nevents);
+}
+
 static int32_t unsupported_config(struct scap_engine_handle engine, const char *msg) {
 	struct bpf_engine *handle = engine.m_handle;
 
@@ -2040,6 +2060,14 @@ static int32_t init(scap_t *handle, scap_open_args *oargs) {
 		return rc;
 	}
 
+	/* Block on the perf buffers instead of sleeping when they are empty */
+	if(params->wakeup_watermark != 0) {
+		rc = devset_enable_poll(&HANDLE(engine)->m_dev_set);
+		if(rc != SCAP_SUCCESS) {
+			return rc;
+		}
+	}
+
 	/* Store interesting sc codes */
 	memcpy(&HANDLE(engine)->curr_sc_set,
 	       &oargs->ppm_sc_of_interest,
@@ -2102,4 +2130,5 @@ const struct scap_vtable scap_bpf_engine = {
         .get_max_buf_used = get_max_buf_used,
         .get_api_version = scap_bpf_get_api_version,
         .get_schema_version = scap_bpf_get_schema_version,
+        .next_batch = next_batch,
 };
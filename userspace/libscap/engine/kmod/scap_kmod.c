@@ -549,6 +549,20 @@ int32_t scap_kmod_next(struct scap_engine_handle engine,
 	return ringbuffer_next(&HANDLE(engine)->m_dev_set, pevent, pdevid, pflags);
 }
 
+static int32_t scap_kmod_next_batch(struct scap_engine_handle engine,
+                                    scap_evt **pevents,
+                                    uint16_t *pdevids,
+                                    uint32_t *pflags,
+                                    uint32_t max_events,
+                                    uint32_t *nevents) {
+	return ringbuffer_next_batch(&HANDLE(engine)->m_dev_set,
+	                             pevents,
+	                             pdevids,
+	                             pflags,
+	                             max_events,
+	                             nevents);
+}
+
 uint32_t scap_kmod_get_n_devs(struct scap_engine_handle engine) {
 	return HANDLE(engine)->m_dev_set.m_ndevs;
 }
@@ -802,6 +816,7 @@ int32_t scap_kmod_set_snaplen(struct scap_engine_handle engine, uint32_t snaplen
 
 		devset->m_devs[j].m_sn_len = 0;
 	}
+	devset_invalidate_heap(devset);
 	return SCAP_SUCCESS;
 }
 
@@ -866,6 +881,7 @@ int32_t scap_kmod_set_fullcapture_port_range(struct scap_engine_handle engine,
 
 		devset->m_devs[j].m_sn_len = 0;
 	}
+	devset_invalidate_heap(devset);
 
 	return SCAP_SUCCESS;
 }
@@ -894,6 +910,7 @@ int32_t scap_kmod_set_statsd_port(struct scap_engine_handle engine, const uint16
 
 		devset->m_devs[j].m_sn_len = 0;
 	}
+	devset_invalidate_heap(devset);
 
 	return SCAP_SUCCESS;
 }
@@ -1034,4 +1051,5 @@ struct scap_vtable scap_kmod_engine = {
         .get_max_buf_used = scap_kmod_get_max_buf_used,
         .get_api_version = scap_kmod_get_api_version,
         .get_schema_version = scap_kmod_get_schema_version,
+        .next_batch = scap_kmod_next_batch,
 };
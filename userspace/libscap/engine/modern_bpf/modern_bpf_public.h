@@ -37,6 +37,10 @@ struct scap_modern_bpf_engine_params {
 	                           ///< allocated changes according to the `cpus_for_each_buffer` param.
 	                           ///< Please note: this buffer will be mapped twice both kernel and
 	                           ///< userspace-side, so pay attention to its size.
+	uint32_t wakeup_watermark;  ///< [EXPERIMENTAL] When not `0` the consumer blocks on the ring
+	                            ///< buffers instead of sleeping with an exponential backoff, the
+	                            ///< probe wakes it up as soon as a ring buffer holds at least
+	                            ///< `wakeup_watermark` bytes. `0` keeps the sleep backoff.
 };
 
 #ifdef __cplusplus
@@ -18,6 +18,7 @@ limitations under the License.
 #include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/socket.h>
 
 #define HANDLE(engine) ((struct modern_bpf_engine*)(engine.m_handle))
@@ -47,6 +48,22 @@ static void scap_modern_bpf__free_engine(struct scap_engine_handle engine) {
 	free(engine.m_handle);
 }
 
+/* Called when all the ring buffers are empty. */
+static void wait_for_events(struct scap_engine_handle engine) {
+	if(HANDLE(engine)->m_wakeup_watermark != 0) {
+		if(pman_wait_for_events(BUFFER_EMPTY_WAIT_TIME_US_MAX / 1000) == 0) {
+			return;
+		}
+		/* We cannot wait on the ring buffers, fall back to the sleep backoff. */
+		HANDLE(engine)->m_wakeup_watermark = 0;
+		pman_set_wakeup_watermark(0);
+	}
+
+	/* The first time we sleep 500 us, if we have consecutive timeouts we can reach also 30 ms. */
+	usleep(HANDLE(engine)->m_retry_us);
+	HANDLE(engine)->m_retry_us = MIN(HANDLE(engine)->m_retry_us * 2, BUFFER_EMPTY_WAIT_TIME_US_MAX);
+}
+
 /* The third parameter is not the CPU number from which we extract the event but the ring buffer
  * number. For the old BPF probe and the kernel module the number of CPUs is equal to the number of
  * buffers since we always use a per-CPU approach.
@@ -58,11 +75,7 @@ static int32_t scap_modern_bpf__next(struct scap_engine_handle engine,
 	pman_consume_first_event((void**)pevent, (int16_t*)buffer_id);
 
 	if((*pevent) == NULL) {
-		/* The first time we sleep 500 us, if we have consecutive timeouts we can reach also 30 ms.
-		 */
-		usleep(HANDLE(engine)->m_retry_us);
-		HANDLE(engine)->m_retry_us =
-		        MIN(HANDLE(engine)->m_retry_us * 2, BUFFER_EMPTY_WAIT_TIME_US_MAX);
+		wait_for_events(engine);
 		return SCAP_TIMEOUT;
 	} else {
 		HANDLE(engine)->m_retry_us = BUFFER_EMPTY_WAIT_TIME_US_START;
@@ -71,6 +84,24 @@ static int32_t scap_modern_bpf__next(struct scap_engine_handle engine,
 	return SCAP_SUCCESS;
 }
 
+static int32_t scap_modern_bpf__next_batch(struct scap_engine_handle engine,
+                                           scap_evt** pevents,
+                                           uint16_t* buffer_ids,
+                                           uint32_t* pflags,
+                                           uint32_t max_events,
+                                           uint32_t* nevents) {
+	pman_consume_batch((void**)pevents, (int16_t*)buffer_ids, max_events, nevents);
+
+	if((*nevents) == 0) {
+		wait_for_events(engine);
+		return SCAP_TIMEOUT;
+	} else {
+		HANDLE(engine)->m_retry_us = BUFFER_EMPTY_WAIT_TIME_US_START;
+	}
+	memset(pflags, 0, (*nevents) * sizeof(uint32_t));
+	return SCAP_SUCCESS;
+}
+
 static int32_t scap_modern_bpf_start_dropping_mode(struct scap_engine_handle engine,
                                                    uint32_t sampling_ratio) {
 	pman_set_sampling_ratio(sampling_ratio);
@@ -283,6 +314,10 @@ int32_t scap_modern_bpf__init(scap_t* handle, scap_open_args* oargs) {
 		return SCAP_FAILURE;
 	}
 
+	/* Block on the ring buffers instead of sleeping when they are empty */
+	HANDLE(engine)->m_wakeup_watermark = params->wakeup_watermark;
+	pman_set_wakeup_watermark(params->wakeup_watermark);
+
 	/* Store interesting sc codes */
 	memcpy(&HANDLE(engine)->curr_sc_set,
 	       &oargs->ppm_sc_of_interest,
@@ -366,4 +401,5 @@ struct scap_vtable scap_modern_bpf_engine = {
         .get_max_buf_used = noop_get_max_buf_used,
         .get_api_version = scap_modern_bpf__get_api_version,
         .get_schema_version = scap_modern_bpf__get_schema_version,
+        .next_batch = scap_modern_bpf__next_batch,
 };
@@ -28,6 +28,7 @@ struct scap;
 
 struct modern_bpf_engine {
 	unsigned long m_retry_us;           /* Microseconds to wait if all ring buffers are empty */
+	uint32_t m_wakeup_watermark;        /* If not 0 block on the ring buffers instead of sleeping */
 	char* m_lasterr;                    /* Last error caught by the engine */
 	interesting_ppm_sc_set curr_sc_set; /* current ppm_sc */
 	uint64_t m_api_version;
@@ -25,6 +25,12 @@ limitations under the License.
 #include <libscap/scap_savefile.h>
 
 #define READER_BUF_SIZE (1 << 16)  // UINT16_MAX + 1, ie: 65536
+// small enough to keep the events of a batch in cache while they are processed
+#define BATCH_BUF_SIZE READER_BUF_SIZE
+// events decoded ahead by the parallel reader, for each segment: SEGMENT_CHUNKS chunks of
+// SEGMENT_CHUNK_SIZE bytes
+#define SEGMENT_CHUNK_SIZE (1 << 18)
+#define SEGMENT_CHUNKS 4
 
 #define CHECK_READ_SIZE_ERR(read_size, expected_size, error)                           \
 	if(read_size != expected_size) {                                                   \
@@ -100,6 +106,7 @@ typedef struct scap_ifinfo_ipv6_nolinkspeed {
 #pragma pack(pop)
 
 struct scap_platform;
+struct savefile_parallel;
 
 struct savefile_engine {
 	char* m_lasterr;
@@ -108,6 +115,14 @@ struct savefile_engine {
 	bool m_use_last_block_header;
 	char* m_reader_evt_buf;
 	size_t m_reader_evt_buf_size;
+	char* m_batch_buf;  // holds all the events returned by the last next_batch()
+	size_t m_batch_buf_size;
+	int32_t m_pending_res;  // failure hit in the middle of the last batch
 	uint32_t m_last_evt_dump_flags;
+	// First event of a capture that doesn't start from the beginning, returned by the next read
+	struct ppm_evt_hdr* m_pending_evt;
+	uint16_t m_pending_devid;
+	uint32_t m_pending_flags;
 	struct scap_platform* m_platform;
+	struct savefile_parallel* m_parallel;  // set when the capture is read by a pool of workers
 };
@@ -31,6 +31,23 @@ struct scap_savefile_engine_params {
 	                        ///< is leveraged when opening merged files.
 	uint32_t fbuffer_size;  ///< If non-zero, offline captures will read from file using a buffer of
 	                        ///< this size.
+	const char* const* fnames;  ///< If non-NULL, the capture is made of these nfnames files, e.g.
+	                            ///< the ones written by a rotating dumper. fd and fname are ignored.
+	uint32_t nfnames;
+	const uint64_t* segment_offsets;  ///< Offsets of event blocks, in increasing order, that split a
+	                                  ///< single capture file into nsegments + 1 segments.
+	uint32_t nsegments;
+	uint32_t num_workers;  ///< If non-zero, the files and segments are decoded by this many threads
+	                       ///< and their events merged in timestamp order.
+	bool use_mmap;  ///< If true, uncompressed files opened by name are mapped in memory and their
+	                ///< events returned without copying them. Compressed files are read as usual.
+	uint64_t start_ts;       ///< If non-zero, the capture starts at its first event with this
+	                         ///< timestamp or a later one.
+	uint64_t start_evt_num;  ///< If non-zero, the capture starts at the first event preceded by
+	                         ///< at least this many events.
+	const char* index_fname;  ///< If non-NULL, the index written by scap_dump_open_index(), used to
+	                          ///< find start_ts and start_evt_num without reading the capture from
+	                          ///< the start.
 
 	struct scap_platform* platform;
 };
@@ -46,6 +46,14 @@ typedef struct scap_reader {
 	 */
 	int (*read)(struct scap_reader *r, void *buf, uint32_t len);
 
+	/**
+	 * @brief Optional, may be NULL. Returns a pointer to the next len bytes
+	 * of data and moves past them, without copying them. The memory stays
+	 * valid, and writable, until the reader is closed. Returns NULL if fewer
+	 * than len bytes are left.
+	 */
+	void *(*read_direct)(struct scap_reader *r, uint32_t len);
+
 	/**
 	 * @brief Returns the current offset in the data being read.
 	 * On error, returns a negative value and error() can be used to
@@ -97,6 +105,13 @@ scap_reader_t *scap_reader_open_gzfile(gzFile file);
  */
 scap_reader_t *scap_reader_open_buffered(scap_reader_t *reader, uint32_t bufsize, bool own_reader);
 
+/**
+ * @brief Maps the whole file in memory, so that the data can be read without
+ * copying it. Returns NULL if the file is compressed or can't be mapped, in
+ * which case it must be read with the gzfile reader.
+ */
+scap_reader_t *scap_reader_open_mmap(const char *fname);
+
 #ifdef __cplusplus
 }
 #endif
@@ -121,6 +121,7 @@ scap_reader_t* scap_reader_open_buffered(scap_reader_t* reader, uint32_t bufsize
 	scap_reader_t* r = (scap_reader_t*)malloc(sizeof(scap_reader_t));
 	r->handle = h;
 	r->read = &buffered_read;
+	r->read_direct = NULL;
 	r->offset = &buffered_offset;
 	r->tell = &buffered_tell;
 	r->seek = &buffered_seek;
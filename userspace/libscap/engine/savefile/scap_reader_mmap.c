@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/engine/savefile/scap_reader.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Pages of the file that we ask the kernel to read ahead of the cursor
+#define MMAP_READAHEAD_SIZE (8 << 20)
+
+typedef struct reader_handle {
+	uint8_t* m_data;         ///< The mapping of the whole file
+	size_t m_size;           ///< The size of the file
+	size_t m_off;            ///< The cursor position
+	size_t m_readahead_off;  ///< The end of the pages requested ahead
+	int m_errno;             ///< The error of the last operation, if any
+} reader_handle_t;
+
+// Keep between half and a whole window of pages requested ahead of the cursor
+static inline void mmap_readahead(reader_handle_t* h) {
+	if(h->m_off + MMAP_READAHEAD_SIZE / 2 < h->m_readahead_off ||
+	   h->m_readahead_off >= h->m_size) {
+		return;
+	}
+
+	// m_readahead_off is a multiple of the window size, so it's page aligned
+	size_t start = h->m_readahead_off;
+	size_t len = h->m_size - start < MMAP_READAHEAD_SIZE ? h->m_size - start : MMAP_READAHEAD_SIZE;
+	madvise(h->m_data + start, len, MADV_WILLNEED);
+	h->m_readahead_off = start + MMAP_READAHEAD_SIZE;
+}
+
+static int mmap_read(scap_reader_t* r, void* buf, uint32_t len) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+	size_t size = h->m_size - h->m_off < len ? h->m_size - h->m_off : len;
+
+	memcpy(buf, h->m_data + h->m_off, size);
+	h->m_off += size;
+	mmap_readahead(h);
+	return (int)size;
+}
+
+static void* mmap_read_direct(scap_reader_t* r, uint32_t len) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+
+	if(h->m_size - h->m_off < len) {
+		return NULL;
+	}
+
+	void* data = h->m_data + h->m_off;
+	h->m_off += len;
+	mmap_readahead(h);
+	return data;
+}
+
+static int64_t mmap_offset(scap_reader_t* r) {
+	ASSERT(r != NULL);
+	return (int64_t)((reader_handle_t*)r->handle)->m_off;
+}
+
+static int64_t mmap_seek(scap_reader_t* r, int64_t offset, int whence) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+	int64_t off;
+
+	switch(whence) {
+	case SEEK_SET:
+		off = offset;
+		break;
+	case SEEK_CUR:
+		off = (int64_t)h->m_off + offset;
+		break;
+	case SEEK_END:
+		off = (int64_t)h->m_size + offset;
+		break;
+	default:
+		h->m_errno = EINVAL;
+		return -1;
+	}
+
+	if(off < 0 || off > (int64_t)h->m_size) {
+		h->m_errno = EINVAL;
+		return -1;
+	}
+
+	h->m_errno = 0;
+	h->m_off = (size_t)off;
+	h->m_readahead_off = h->m_off - h->m_off % MMAP_READAHEAD_SIZE;
+	mmap_readahead(h);
+	return off;
+}
+
+static const char* mmap_error(scap_reader_t* r, int* errnum) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+	*errnum = h->m_errno;
+	return h->m_errno ? strerror(h->m_errno) : "";
+}
+
+static int mmap_close(scap_reader_t* r) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+	int res = munmap(h->m_data, h->m_size);
+	free(h);
+	free(r);
+	return res;
+}
+
+scap_reader_t* scap_reader_open_mmap(const char* fname) {
+	struct stat st;
+	uint8_t magic[2];
+
+	int fd = open(fname, O_RDONLY);
+	if(fd < 0) {
+		return NULL;
+	}
+
+	// gzip files are left to the gzfile reader
+	if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < (off_t)sizeof(magic) ||
+	   pread(fd, magic, sizeof(magic), 0) != sizeof(magic) ||
+	   (magic[0] == 0x1f && magic[1] == 0x8b)) {
+		close(fd);
+		return NULL;
+	}
+
+	// A private mapping, so that the events can be modified in place like the
+	// ones copied in a buffer
+	void* data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) {
+		return NULL;
+	}
+	madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+	reader_handle_t* h = (reader_handle_t*)calloc(1, sizeof(reader_handle_t));
+	scap_reader_t* r = (scap_reader_t*)malloc(sizeof(scap_reader_t));
+	if(!h || !r) {
+		munmap(data, st.st_size);
+		free(h);
+		free(r);
+		return NULL;
+	}
+	h->m_data = (uint8_t*)data;
+	h->m_size = (size_t)st.st_size;
+	mmap_readahead(h);
+
+	r->handle = h;
+	r->read = &mmap_read;
+	r->read_direct = &mmap_read_direct;
+	r->offset = &mmap_offset;
+	r->tell = &mmap_offset;
+	r->seek = &mmap_seek;
+	r->error = &mmap_error;
+	r->close = &mmap_close;
+	return r;
+}
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -42,6 +43,12 @@ struct iovec {
 
 #include <libscap/strl.h>
 
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define SAVEFILE_PARALLEL_READER
+#define SAVEFILE_MMAP_READER
+#include <pthread.h>
+#endif
+
 //
 // Read the section header block
 //
@@ -1804,17 +1811,82 @@ static int32_t scap_read_init(struct savefile_engine *handle,
 }
 
 //
-// Read an event from disk
+// Skip the section header and the metadata blocks of a trace file, up to its
+// first event block
 //
-static int32_t next(struct scap_engine_handle engine,
-                    scap_evt **pevent,
-                    uint16_t *pdevid,
-                    uint32_t *pflags) {
-	struct savefile_engine *handle = engine.m_handle;
+static int32_t scap_skip_metadata(struct savefile_engine *handle, scap_reader_t *r, char *error) {
+	block_header bh;
+	size_t readsize;
+	int32_t rc;
+
+	if(read_block_header(handle, r, &bh) != sizeof(bh)) {
+		snprintf(error, SCAP_LASTERR_SIZE, "error reading from file (1)");
+		return SCAP_FAILURE;
+	}
+
+	if(bh.block_type != SHB_BLOCK_TYPE) {
+		snprintf(error, SCAP_LASTERR_SIZE, "invalid block type");
+		return SCAP_FAILURE;
+	}
+
+	if((rc = scap_read_section_header(r, error)) != SCAP_SUCCESS) {
+		return rc;
+	}
+
+	while(true) {
+		readsize = read_block_header(handle, r, &bh);
+		if(readsize == 0) {
+			return SCAP_EOF;
+		}
+
+		CHECK_READ_SIZE_ERR(readsize, sizeof(bh), error);
+
+		switch(bh.block_type) {
+		case EV_BLOCK_TYPE:
+		case EV_BLOCK_TYPE_INT:
+		case EV_BLOCK_TYPE_V2:
+		case EVF_BLOCK_TYPE:
+		case EVF_BLOCK_TYPE_V2:
+		case EV_BLOCK_TYPE_V2_LARGE:
+		case EVF_BLOCK_TYPE_V2_LARGE:
+			handle->m_use_last_block_header = true;
+			return SCAP_SUCCESS;
+		default:
+			// Skip the block and its trailer
+			if(bh.block_total_length < sizeof(bh) + 4 ||
+			   r->seek(r, (long)(bh.block_total_length - sizeof(bh)), SEEK_CUR) == -1) {
+				snprintf(error,
+				         SCAP_LASTERR_SIZE,
+				         "corrupted input file. Can't skip block of type %x and size %u.",
+				         (int)bh.block_type,
+				         (unsigned int)bh.block_total_length);
+				return SCAP_FAILURE;
+			}
+			break;
+		}
+	}
+}
+
+//
+// Read an event from disk into buf. On success, *evt_space is set to the
+// number of bytes of buf taken by the event. If the event doesn't fit in
+// buf_size bytes, the block header is pushed back, *evt_space is set to the
+// number of bytes required and SCAP_INPUT_TOO_SMALL is returned. Readers that
+// support read_direct() return the event where they keep it instead, without
+// taking any space from buf.
+//
+static int32_t read_event(struct savefile_engine *handle,
+                          char *buf,
+                          size_t buf_size,
+                          uint32_t *evt_space,
+                          scap_evt **pevent,
+                          uint16_t *pdevid,
+                          uint32_t *pflags) {
 	block_header bh;
 	size_t readsize;
 	uint32_t readlen;
 	size_t hdr_len;
+	char *block;
 	scap_reader_t *r = handle->m_reader;
 
 	ASSERT(r != NULL);
@@ -1895,39 +1967,43 @@ static int32_t next(struct scap_engine_handle engine,
 				         READER_BUF_SIZE);
 				return SCAP_FAILURE;
 			}
-		} else if(readlen > handle->m_reader_evt_buf_size) {
-			// Try to allocate a buffer large enough
-			char *tmp = realloc(handle->m_reader_evt_buf, readlen);
-			if(!tmp) {
-				free(handle->m_reader_evt_buf);
-				handle->m_reader_evt_buf = NULL;
-				snprintf(handle->m_lasterr,
-				         SCAP_LASTERR_SIZE,
-				         "event block length %u greater than read buffer size %zu",
-				         readlen,
-				         handle->m_reader_evt_buf_size);
-				return SCAP_FAILURE;
-			}
-			handle->m_reader_evt_buf = tmp;
-			handle->m_reader_evt_buf_size = readlen;
 		}
 
-		readsize = r->read(r, handle->m_reader_evt_buf, readlen);
-		CHECK_READ_SIZE(readsize, readlen);
+		if(r->read_direct && hdr_len == sizeof(struct ppm_evt_hdr)) {
+			// The event can be used where the reader keeps it, without copying it
+			*evt_space = 0;
+			block = r->read_direct(r, readlen);
+			readsize = block ? readlen : 0;
+			CHECK_READ_SIZE(readsize, readlen);
+		} else {
+			// Old captures need some room to convert their events to the current version
+			*evt_space = readlen;
+			if(hdr_len != sizeof(struct ppm_evt_hdr)) {
+				*evt_space += sizeof(uint32_t);
+			}
+
+			if(*evt_space > buf_size) {
+				handle->m_use_last_block_header = true;
+				return SCAP_INPUT_TOO_SMALL;
+			}
+
+			block = buf;
+			readsize = r->read(r, block, readlen);
+			CHECK_READ_SIZE(readsize, readlen);
+		}
 
 		//
 		// EVF_BLOCK_TYPE has 32 bits of flags
 		//
-		*pdevid = *(uint16_t *)handle->m_reader_evt_buf;
+		memcpy(pdevid, block, sizeof(uint16_t));
 
 		if(bh.block_type == EVF_BLOCK_TYPE || bh.block_type == EVF_BLOCK_TYPE_V2 ||
 		   bh.block_type == EVF_BLOCK_TYPE_V2_LARGE) {
-			memcpy(pflags, handle->m_reader_evt_buf + sizeof(uint16_t), sizeof(uint32_t));
-			*pevent = (struct ppm_evt_hdr *)(handle->m_reader_evt_buf + sizeof(uint16_t) +
-			                                 sizeof(uint32_t));
+			memcpy(pflags, block + sizeof(uint16_t), sizeof(uint32_t));
+			*pevent = (struct ppm_evt_hdr *)(block + sizeof(uint16_t) + sizeof(uint32_t));
 		} else {
 			*pflags = 0;
-			*pevent = (struct ppm_evt_hdr *)(handle->m_reader_evt_buf + sizeof(uint16_t));
+			*pevent = (struct ppm_evt_hdr *)(block + sizeof(uint16_t));
 		}
 
 		if((*pevent)->type >= PPM_EVENT_MAX) {
@@ -1956,7 +2032,7 @@ static int32_t next(struct scap_engine_handle engine,
 
 			memmove((char *)*pevent + sizeof(struct ppm_evt_hdr),
 			        (char *)*pevent + sizeof(struct ppm_evt_hdr) - sizeof(uint32_t),
-			        readlen - ((char *)*pevent - handle->m_reader_evt_buf) -
+			        readlen - ((char *)*pevent - buf) -
 			                (sizeof(struct ppm_evt_hdr) - sizeof(uint32_t)));
 			(*pevent)->len += sizeof(uint32_t);
 
@@ -2014,14 +2090,797 @@ static int32_t next(struct scap_engine_handle engine,
 	return SCAP_SUCCESS;
 }
 
+static scap_reader_t *open_reader(int fd,
+                                  const char *fname,
+                                  uint32_t fbuffer_size,
+                                  bool use_mmap,
+                                  char *error) {
+	gzFile gzfile;
+
+#ifdef SAVEFILE_MMAP_READER
+	if(use_mmap && fd == 0) {
+		// Compressed files, or files that can't be mapped, fall back to zlib
+		scap_reader_t *reader = scap_reader_open_mmap(fname);
+		if(reader) {
+			return reader;
+		}
+	}
+#endif
+
+	if(fd != 0) {
+		gzfile = gzdopen(fd, "rb");
+	} else {
+		gzfile = gzopen(fname, "rb");
+	}
+
+	if(gzfile == NULL) {
+		if(fd != 0) {
+			snprintf(error, SCAP_LASTERR_SIZE, "can't open fd %d", fd);
+		} else {
+			snprintf(error, SCAP_LASTERR_SIZE, "can't open file %s", fname);
+		}
+		return NULL;
+	}
+
+	// Look at the header right away: only then gzseek() knows that a file is
+	// uncompressed and can seek it directly instead of reading up to the offset
+	gzdirect(gzfile);
+
+	scap_reader_t *reader = scap_reader_open_gzfile(gzfile);
+	if(!reader) {
+		gzclose(gzfile);
+		return NULL;
+	}
+
+	if(fbuffer_size > 0) {
+		scap_reader_t *buffered_reader = scap_reader_open_buffered(reader, fbuffer_size, true);
+		if(!buffered_reader) {
+			reader->close(reader);
+			return NULL;
+		}
+		reader = buffered_reader;
+	}
+
+	return reader;
+}
+
+#ifdef SAVEFILE_PARALLEL_READER
+
+//
+// Parallel reader. The capture is split into segments (the files of a
+// rotation, or ranges of event blocks of a single file), each one with its own
+// reader. A pool of workers decodes the segments into rings of chunks, with at
+// most one worker on a segment at a time, and the consumer merges the current
+// events of the segments in timestamp order through a min-heap. The segments
+// of a single file are returned one after the other instead, exactly as the
+// serial reader would.
+//
+
+// An event stored in a chunk, followed by its raw event block unless the
+// reader returned the event in place
+struct chunk_evt {
+	scap_evt *m_evt;
+	uint32_t m_size;  // size of the record, header included
+	uint32_t m_flags;
+	uint16_t m_devid;
+};
+
+struct savefile_chunk {
+	char *m_buf;
+	size_t m_buf_size;
+	size_t m_len;  // bytes of m_buf taken by the events
+};
+
+struct savefile_segment {
+	struct savefile_engine m_state;  // reader and block header of the segment
+	char m_lasterr[SCAP_LASTERR_SIZE];
+	uint64_t m_start;      // if non-zero, offset of the first event block of the segment
+	uint64_t m_end;        // if non-zero, offset of the first event block of the next segment
+	bool m_skip_metadata;  // the headers of the file haven't been read yet
+	int64_t m_base_offset;
+
+	// Protected by the pool lock
+	struct savefile_chunk m_chunks[SEGMENT_CHUNKS];
+	uint32_t m_head;    // first chunk not yet consumed
+	uint32_t m_filled;  // decoded chunks, starting from m_head
+	bool m_busy;        // queued or being decoded by a worker
+	int32_t m_res;      // SCAP_EOF or SCAP_FAILURE once the reader is done
+	int64_t m_offset;   // bytes read from the file so far, for the read progress
+	struct savefile_segment *m_next_job;
+
+	// Owned by the consumer: position of the current event in the head chunk
+	size_t m_pos;
+};
+
+struct savefile_parallel {
+	struct savefile_segment *m_segments;
+	uint32_t m_nsegments;
+	pthread_t *m_threads;
+	uint32_t m_nthreads;
+	pthread_mutex_t m_lock;
+	pthread_cond_t m_job_ready;
+	pthread_cond_t m_chunk_ready;
+	struct savefile_segment *m_jobs_head;
+	struct savefile_segment *m_jobs_tail;
+	bool m_stop;
+	bool m_file_order;
+
+	// Segments that still have events, by timestamp of their current event
+	uint32_t *m_heap;
+	uint32_t m_heap_size;
+	bool m_heap_ready;
+	// The last event returned is the last one of the head chunk of the heap
+	// top, which is released at the next call
+	bool m_release_top;
+	int32_t m_res;
+};
+
+static inline struct chunk_evt *segment_evt(struct savefile_segment *seg) {
+	return (struct chunk_evt *)(seg->m_chunks[seg->m_head].m_buf + seg->m_pos);
+}
+
+static inline scap_evt *chunk_evt_event(struct chunk_evt *rec) {
+	return rec->m_evt;
+}
+
+// Must be called with the pool lock held
+static void queue_job(struct savefile_parallel *p, struct savefile_segment *seg) {
+	seg->m_busy = true;
+	seg->m_next_job = NULL;
+	if(p->m_jobs_tail) {
+		p->m_jobs_tail->m_next_job = seg;
+	} else {
+		p->m_jobs_head = seg;
+	}
+	p->m_jobs_tail = seg;
+	pthread_cond_signal(&p->m_job_ready);
+}
+
+//
+// Decode events into the chunk until it's full. Returns SCAP_SUCCESS if the
+// segment has more events
+//
+static int32_t fill_chunk(struct savefile_segment *seg, struct savefile_chunk *chunk) {
+	struct savefile_engine *state = &seg->m_state;
+	scap_reader_t *r = state->m_reader;
+	const size_t hdr_len = sizeof(struct chunk_evt);
+	uint32_t evt_space;
+	scap_evt *evt;
+	uint16_t devid;
+	uint32_t flags;
+	int32_t res;
+
+	chunk->m_len = 0;
+
+	if(seg->m_skip_metadata) {
+		seg->m_skip_metadata = false;
+		if((res = scap_skip_metadata(state, r, seg->m_lasterr)) != SCAP_SUCCESS) {
+			return res;
+		}
+	}
+
+	if(seg->m_start != 0) {
+		if(r->seek(r, (int64_t)seg->m_start, SEEK_SET) == -1) {
+			snprintf(seg->m_lasterr,
+			         SCAP_LASTERR_SIZE,
+			         "can't seek to segment offset %" PRIu64,
+			         seg->m_start);
+			return SCAP_FAILURE;
+		}
+		seg->m_start = 0;
+		seg->m_base_offset = r->offset(r);
+	}
+
+	while(true) {
+		if(seg->m_end != 0) {
+			int64_t pos = r->tell(r);
+			if(state->m_use_last_block_header) {
+				pos -= sizeof(block_header);
+			}
+			if(pos >= (int64_t)seg->m_end) {
+				return SCAP_EOF;
+			}
+		}
+
+		if(chunk->m_len + hdr_len >= chunk->m_buf_size) {
+			return SCAP_SUCCESS;
+		}
+
+		res = read_event(state,
+		                 chunk->m_buf + chunk->m_len + hdr_len,
+		                 chunk->m_buf_size - chunk->m_len - hdr_len,
+		                 &evt_space,
+		                 &evt,
+		                 &devid,
+		                 &flags);
+		if(res == SCAP_INPUT_TOO_SMALL) {
+			if(chunk->m_len > 0) {
+				// The event will open the next chunk
+				return SCAP_SUCCESS;
+			}
+
+			size_t size = (hdr_len + evt_space + 7) & ~(size_t)7;
+			char *tmp = realloc(chunk->m_buf, size);
+			if(!tmp) {
+				snprintf(seg->m_lasterr,
+				         SCAP_LASTERR_SIZE,
+				         "event block length %u greater than chunk size %zu",
+				         evt_space,
+				         chunk->m_buf_size);
+				return SCAP_FAILURE;
+			}
+			chunk->m_buf = tmp;
+			chunk->m_buf_size = size;
+			continue;
+		}
+
+		if(res == SCAP_UNEXPECTED_BLOCK) {
+			snprintf(seg->m_lasterr,
+			         SCAP_LASTERR_SIZE,
+			         "unexpected block type %u: captures with several sections can't be read in "
+			         "parallel",
+			         (uint32_t)state->m_last_block_header.block_type);
+			return SCAP_FAILURE;
+		}
+
+		if(res != SCAP_SUCCESS) {
+			return res;
+		}
+
+		struct chunk_evt *rec = (struct chunk_evt *)(chunk->m_buf + chunk->m_len);
+		rec->m_size = (uint32_t)((hdr_len + evt_space + 7) & ~(size_t)7);
+		rec->m_flags = flags;
+		rec->m_devid = devid;
+		rec->m_evt = evt;
+		chunk->m_len += rec->m_size;
+	}
+}
+
+static void *segment_worker(void *arg) {
+	struct savefile_parallel *p = arg;
+
+	pthread_mutex_lock(&p->m_lock);
+	while(true) {
+		while(!p->m_stop && p->m_jobs_head == NULL) {
+			pthread_cond_wait(&p->m_job_ready, &p->m_lock);
+		}
+
+		if(p->m_stop) {
+			break;
+		}
+
+		struct savefile_segment *seg = p->m_jobs_head;
+		p->m_jobs_head = seg->m_next_job;
+		if(p->m_jobs_head == NULL) {
+			p->m_jobs_tail = NULL;
+		}
+		struct savefile_chunk *chunk =
+		        &seg->m_chunks[(seg->m_head + seg->m_filled) % SEGMENT_CHUNKS];
+		pthread_mutex_unlock(&p->m_lock);
+
+		int32_t res = fill_chunk(seg, chunk);
+		int64_t offset = seg->m_state.m_reader->offset(seg->m_state.m_reader) - seg->m_base_offset;
+
+		pthread_mutex_lock(&p->m_lock);
+		seg->m_offset = offset;
+		if(chunk->m_len > 0) {
+			seg->m_filled++;
+		}
+		seg->m_busy = false;
+		if(res != SCAP_SUCCESS) {
+			seg->m_res = res;
+		} else if(seg->m_filled < SEGMENT_CHUNKS) {
+			queue_job(p, seg);
+		}
+		pthread_cond_signal(&p->m_chunk_ready);
+	}
+	pthread_mutex_unlock(&p->m_lock);
+
+	return NULL;
+}
+
+//
+// Wait until the segment has a decoded chunk. Returns SCAP_SUCCESS if it has
+// one, otherwise how its reader ended
+//
+static int32_t wait_chunk(struct savefile_parallel *p, struct savefile_segment *seg) {
+	int32_t res = SCAP_SUCCESS;
+
+	pthread_mutex_lock(&p->m_lock);
+	while(seg->m_filled == 0 && seg->m_busy) {
+		pthread_cond_wait(&p->m_chunk_ready, &p->m_lock);
+	}
+	if(seg->m_filled == 0) {
+		res = seg->m_res;
+	}
+	pthread_mutex_unlock(&p->m_lock);
+
+	return res;
+}
+
+static void release_chunk(struct savefile_parallel *p, struct savefile_segment *seg) {
+	pthread_mutex_lock(&p->m_lock);
+	seg->m_head = (seg->m_head + 1) % SEGMENT_CHUNKS;
+	seg->m_filled--;
+	seg->m_pos = 0;
+	if(!seg->m_busy && seg->m_res == SCAP_SUCCESS) {
+		queue_job(p, seg);
+	}
+	pthread_mutex_unlock(&p->m_lock);
+}
+
+// Ties are broken by segment index, i.e. in file order
+static inline bool segment_before(struct savefile_parallel *p, uint32_t a, uint32_t b) {
+	if(p->m_file_order) {
+		return a < b;
+	}
+
+	uint64_t ts_a = chunk_evt_event(segment_evt(&p->m_segments[a]))->ts;
+	uint64_t ts_b = chunk_evt_event(segment_evt(&p->m_segments[b]))->ts;
+	return ts_a < ts_b || (ts_a == ts_b && a < b);
+}
+
+static void heap_sift_down(struct savefile_parallel *p, uint32_t i) {
+	while(true) {
+		uint32_t smallest = i;
+		uint32_t l = 2 * i + 1;
+		uint32_t r = l + 1;
+
+		if(l < p->m_heap_size && segment_before(p, p->m_heap[l], p->m_heap[smallest])) {
+			smallest = l;
+		}
+		if(r < p->m_heap_size && segment_before(p, p->m_heap[r], p->m_heap[smallest])) {
+			smallest = r;
+		}
+		if(smallest == i) {
+			return;
+		}
+
+		uint32_t tmp = p->m_heap[i];
+		p->m_heap[i] = p->m_heap[smallest];
+		p->m_heap[smallest] = tmp;
+		i = smallest;
+	}
+}
+
+static int32_t heap_init(struct savefile_engine *handle, struct savefile_parallel *p) {
+	for(uint32_t i = 0; i < p->m_nsegments; i++) {
+		int32_t res = wait_chunk(p, &p->m_segments[i]);
+		if(res == SCAP_SUCCESS) {
+			p->m_heap[p->m_heap_size++] = i;
+		} else if(res != SCAP_EOF) {
+			strlcpy(handle->m_lasterr, p->m_segments[i].m_lasterr, SCAP_LASTERR_SIZE);
+			return res;
+		}
+	}
+
+	for(uint32_t i = p->m_heap_size / 2; i > 0; i--) {
+		heap_sift_down(p, i - 1);
+	}
+	p->m_heap_ready = true;
+	return SCAP_SUCCESS;
+}
+
+// The head chunk of the heap top was consumed: move on to its next one
+static int32_t heap_next_chunk(struct savefile_engine *handle, struct savefile_parallel *p) {
+	struct savefile_segment *seg = &p->m_segments[p->m_heap[0]];
+
+	release_chunk(p, seg);
+	int32_t res = wait_chunk(p, seg);
+	if(res != SCAP_SUCCESS && res != SCAP_EOF) {
+		strlcpy(handle->m_lasterr, seg->m_lasterr, SCAP_LASTERR_SIZE);
+		return res;
+	}
+
+	if(res == SCAP_EOF) {
+		p->m_heap[0] = p->m_heap[--p->m_heap_size];
+	}
+	heap_sift_down(p, 0);
+	return SCAP_SUCCESS;
+}
+
+static int32_t parallel_next_batch(struct savefile_engine *handle,
+                                   scap_evt **pevents,
+                                   uint16_t *pdevids,
+                                   uint32_t *pflags,
+                                   uint32_t max_events,
+                                   uint32_t *nevents) {
+	struct savefile_parallel *p = handle->m_parallel;
+	int32_t res = SCAP_SUCCESS;
+
+	*nevents = 0;
+	if(p->m_res != SCAP_SUCCESS) {
+		return p->m_res;
+	}
+
+	if(!p->m_heap_ready) {
+		res = heap_init(handle, p);
+	} else if(p->m_release_top) {
+		p->m_release_top = false;
+		res = heap_next_chunk(handle, p);
+	}
+
+	if(res != SCAP_SUCCESS) {
+		p->m_res = res;
+		return res;
+	}
+
+	while(*nevents < max_events && p->m_heap_size > 0) {
+		struct savefile_segment *seg = &p->m_segments[p->m_heap[0]];
+		struct chunk_evt *rec = segment_evt(seg);
+
+		pevents[*nevents] = chunk_evt_event(rec);
+		pdevids[*nevents] = rec->m_devid;
+		pflags[*nevents] = rec->m_flags;
+		(*nevents)++;
+
+		// The returned events must stay valid until the next call, so the
+		// chunk can't be released yet
+		seg->m_pos += rec->m_size;
+		if(seg->m_pos >= seg->m_chunks[seg->m_head].m_len) {
+			p->m_release_top = true;
+			break;
+		}
+		heap_sift_down(p, 0);
+	}
+
+	if(*nevents == 0) {
+		p->m_res = SCAP_EOF;
+		return SCAP_EOF;
+	}
+	return SCAP_SUCCESS;
+}
+
+static int64_t parallel_offset(struct savefile_parallel *p) {
+	int64_t offset = 0;
+
+	pthread_mutex_lock(&p->m_lock);
+	for(uint32_t i = 0; i < p->m_nsegments; i++) {
+		offset += p->m_segments[i].m_offset;
+	}
+	pthread_mutex_unlock(&p->m_lock);
+
+	return offset;
+}
+
+static void close_parallel(struct savefile_parallel *p) {
+	pthread_mutex_lock(&p->m_lock);
+	p->m_stop = true;
+	pthread_cond_broadcast(&p->m_job_ready);
+	pthread_mutex_unlock(&p->m_lock);
+
+	for(uint32_t i = 0; i < p->m_nthreads; i++) {
+		pthread_join(p->m_threads[i], NULL);
+	}
+
+	for(uint32_t i = 0; i < p->m_nsegments; i++) {
+		struct savefile_segment *seg = &p->m_segments[i];
+		if(seg->m_state.m_reader) {
+			seg->m_state.m_reader->close(seg->m_state.m_reader);
+		}
+		for(uint32_t j = 0; j < SEGMENT_CHUNKS; j++) {
+			free(seg->m_chunks[j].m_buf);
+		}
+	}
+
+	pthread_cond_destroy(&p->m_chunk_ready);
+	pthread_cond_destroy(&p->m_job_ready);
+	pthread_mutex_destroy(&p->m_lock);
+	free(p->m_threads);
+	free(p->m_heap);
+	free(p->m_segments);
+	free(p);
+}
+
+//
+// Set up the segments of the capture and start the workers. reader has
+// already gone through the headers of the first file
+//
+static int32_t init_parallel(struct savefile_engine *handle,
+                             struct scap_savefile_engine_params *params,
+                             scap_reader_t *reader,
+                             char *error) {
+	uint32_t nsegments = params->nfnames > 0 ? params->nfnames : params->nsegments + 1;
+	uint32_t nthreads = params->num_workers > 0 ? params->num_workers : 1;
+
+	if(params->nfnames > 0 && params->nsegments > 0) {
+		reader->close(reader);
+		snprintf(error, SCAP_LASTERR_SIZE, "segments can only split a single file");
+		return SCAP_FAILURE;
+	}
+
+	if(params->nsegments > 0 && params->fd != 0) {
+		reader->close(reader);
+		snprintf(error, SCAP_LASTERR_SIZE, "segments can't be read from a file descriptor");
+		return SCAP_FAILURE;
+	}
+
+	struct savefile_parallel *p = calloc(1, sizeof(*p));
+	if(!p) {
+		reader->close(reader);
+		snprintf(error, SCAP_LASTERR_SIZE, "error allocating the parallel reader");
+		return SCAP_FAILURE;
+	}
+	pthread_mutex_init(&p->m_lock, NULL);
+	pthread_cond_init(&p->m_job_ready, NULL);
+	pthread_cond_init(&p->m_chunk_ready, NULL);
+	handle->m_parallel = p;
+
+	p->m_segments = calloc(nsegments, sizeof(struct savefile_segment));
+	p->m_heap = calloc(nsegments, sizeof(uint32_t));
+	p->m_threads = calloc(nthreads < nsegments ? nthreads : nsegments, sizeof(pthread_t));
+	if(!p->m_segments || !p->m_heap || !p->m_threads) {
+		reader->close(reader);
+		snprintf(error, SCAP_LASTERR_SIZE, "error allocating the parallel reader");
+		return SCAP_FAILURE;
+	}
+	p->m_nsegments = nsegments;
+	p->m_file_order = params->nfnames == 0;
+
+	// The first segment continues from the headers of the first file
+	struct savefile_segment *seg = &p->m_segments[0];
+	seg->m_state.m_reader = reader;
+	seg->m_state.m_last_block_header = handle->m_last_block_header;
+	seg->m_state.m_use_last_block_header = handle->m_use_last_block_header;
+	int64_t first_block = reader->tell(reader);
+	if(seg->m_state.m_use_last_block_header) {
+		first_block -= sizeof(block_header);
+	}
+
+	for(uint32_t i = 0; i < nsegments; i++) {
+		seg = &p->m_segments[i];
+		seg->m_state.m_lasterr = seg->m_lasterr;
+		seg->m_res = SCAP_SUCCESS;
+
+		for(uint32_t j = 0; j < SEGMENT_CHUNKS; j++) {
+			seg->m_chunks[j].m_buf = malloc(SEGMENT_CHUNK_SIZE);
+			if(!seg->m_chunks[j].m_buf) {
+				snprintf(error, SCAP_LASTERR_SIZE, "error allocating the segment buffers");
+				return SCAP_FAILURE;
+			}
+			seg->m_chunks[j].m_buf_size = SEGMENT_CHUNK_SIZE;
+		}
+
+		if(i == 0) {
+			continue;
+		}
+
+		const char *fname = params->nfnames > 0 ? params->fnames[i] : params->fname;
+		if(params->nfnames > 0) {
+			seg->m_skip_metadata = true;
+		} else {
+			uint64_t start = params->segment_offsets[i - 1];
+			if(start < (uint64_t)first_block || start <= p->m_segments[i - 1].m_start) {
+				snprintf(error,
+				         SCAP_LASTERR_SIZE,
+				         "invalid segment offset %" PRIu64,
+				         start);
+				return SCAP_FAILURE;
+			}
+			seg->m_start = start;
+			p->m_segments[i - 1].m_end = start;
+		}
+
+		seg->m_state.m_reader =
+		        open_reader(0, fname, params->fbuffer_size, params->use_mmap, error);
+		if(!seg->m_state.m_reader) {
+			return SCAP_FAILURE;
+		}
+	}
+
+	pthread_mutex_lock(&p->m_lock);
+	for(uint32_t i = 0; i < nsegments; i++) {
+		queue_job(p, &p->m_segments[i]);
+	}
+	pthread_mutex_unlock(&p->m_lock);
+
+	for(uint32_t i = 0; i < nthreads && i < nsegments; i++) {
+		if(pthread_create(&p->m_threads[i], NULL, segment_worker, p) != 0) {
+			snprintf(error, SCAP_LASTERR_SIZE, "can't start the savefile reader threads");
+			return SCAP_FAILURE;
+		}
+		p->m_nthreads++;
+	}
+
+	return SCAP_SUCCESS;
+}
+
+#else
+
+static int32_t parallel_next_batch(struct savefile_engine *handle,
+                                   scap_evt **pevents,
+                                   uint16_t *pdevids,
+                                   uint32_t *pflags,
+                                   uint32_t max_events,
+                                   uint32_t *nevents) {
+	return SCAP_FAILURE;
+}
+
+static int64_t parallel_offset(struct savefile_parallel *p) {
+	return -1;
+}
+
+static void close_parallel(struct savefile_parallel *p) {}
+
+static int32_t init_parallel(struct savefile_engine *handle,
+                             struct scap_savefile_engine_params *params,
+                             scap_reader_t *reader,
+                             char *error) {
+	reader->close(reader);
+	snprintf(error, SCAP_LASTERR_SIZE, "parallel reading of captures is not supported");
+	return SCAP_FAILURE;
+}
+
+#endif  // SAVEFILE_PARALLEL_READER
+
+static int32_t next(struct scap_engine_handle engine,
+                    scap_evt **pevent,
+                    uint16_t *pdevid,
+                    uint32_t *pflags) {
+	struct savefile_engine *handle = engine.m_handle;
+	uint32_t evt_space;
+	int32_t res;
+
+	if(handle->m_parallel) {
+		uint32_t nevents;
+		return parallel_next_batch(handle, pevent, pdevid, pflags, 1, &nevents);
+	}
+
+	ASSERT(handle->m_reader != NULL);
+
+	if(handle->m_pending_evt != NULL) {
+		*pevent = handle->m_pending_evt;
+		*pdevid = handle->m_pending_devid;
+		*pflags = handle->m_pending_flags;
+		handle->m_pending_evt = NULL;
+		return SCAP_SUCCESS;
+	}
+
+	if(handle->m_pending_res != SCAP_SUCCESS) {
+		res = handle->m_pending_res;
+		handle->m_pending_res = SCAP_SUCCESS;
+		return res;
+	}
+
+	while((res = read_event(handle,
+	                        handle->m_reader_evt_buf,
+	                        handle->m_reader_evt_buf_size,
+	                        &evt_space,
+	                        pevent,
+	                        pdevid,
+	                        pflags)) == SCAP_INPUT_TOO_SMALL) {
+		// Try to allocate a buffer large enough
+		char *tmp = realloc(handle->m_reader_evt_buf, evt_space);
+		if(!tmp) {
+			free(handle->m_reader_evt_buf);
+			handle->m_reader_evt_buf = NULL;
+			snprintf(handle->m_lasterr,
+			         SCAP_LASTERR_SIZE,
+			         "event block length %u greater than read buffer size %zu",
+			         evt_space,
+			         handle->m_reader_evt_buf_size);
+			handle->m_reader_evt_buf_size = 0;
+			return SCAP_FAILURE;
+		}
+		handle->m_reader_evt_buf = tmp;
+		handle->m_reader_evt_buf_size = evt_space;
+	}
+
+	return res;
+}
+
+//
+// Read as many events as fit in the batch buffer, so that all of them stay
+// valid until the next call
+//
+static int32_t next_batch(struct scap_engine_handle engine,
+                          scap_evt **pevents,
+                          uint16_t *pdevids,
+                          uint32_t *pflags,
+                          uint32_t max_events,
+                          uint32_t *nevents) {
+	struct savefile_engine *handle = engine.m_handle;
+	size_t offset = 0;
+	uint32_t evt_space;
+	int32_t res = SCAP_SUCCESS;
+
+	if(handle->m_parallel) {
+		return parallel_next_batch(handle, pevents, pdevids, pflags, max_events, nevents);
+	}
+
+	ASSERT(handle->m_reader != NULL);
+
+	*nevents = 0;
+	if(handle->m_pending_evt != NULL) {
+		// It lives in the read buffer, that is left alone by the batches
+		pevents[0] = handle->m_pending_evt;
+		pdevids[0] = handle->m_pending_devid;
+		pflags[0] = handle->m_pending_flags;
+		handle->m_pending_evt = NULL;
+		*nevents = 1;
+	}
+
+	if(handle->m_pending_res != SCAP_SUCCESS) {
+		res = handle->m_pending_res;
+		handle->m_pending_res = SCAP_SUCCESS;
+		return res;
+	}
+
+	if(handle->m_batch_buf == NULL) {
+		handle->m_batch_buf = (char *)malloc(BATCH_BUF_SIZE);
+		if(!handle->m_batch_buf) {
+			snprintf(handle->m_lasterr, SCAP_LASTERR_SIZE, "error allocating the batch buffer");
+			return SCAP_FAILURE;
+		}
+		handle->m_batch_buf_size = BATCH_BUF_SIZE;
+	}
+
+	while(*nevents < max_events) {
+		res = read_event(handle,
+		                 handle->m_batch_buf + offset,
+		                 handle->m_batch_buf_size - offset,
+		                 &evt_space,
+		                 &pevents[*nevents],
+		                 &pdevids[*nevents],
+		                 &pflags[*nevents]);
+		if(res == SCAP_INPUT_TOO_SMALL) {
+			if(*nevents > 0) {
+				// The event will open the next batch
+				res = SCAP_SUCCESS;
+				break;
+			}
+
+			// A single large event: grow the buffer to fit it
+			char *tmp = realloc(handle->m_batch_buf, evt_space);
+			if(!tmp) {
+				snprintf(handle->m_lasterr,
+				         SCAP_LASTERR_SIZE,
+				         "event block length %u greater than batch buffer size %zu",
+				         evt_space,
+				         handle->m_batch_buf_size);
+				return SCAP_FAILURE;
+			}
+			handle->m_batch_buf = tmp;
+			handle->m_batch_buf_size = evt_space;
+			continue;
+		}
+
+		if(res != SCAP_SUCCESS) {
+			break;
+		}
+
+		offset += evt_space;
+		(*nevents)++;
+	}
+
+	if(*nevents == 0) {
+		return res;
+	}
+
+	// Return what we have and report the failure at the next call: EOF and
+	// unexpected blocks are hit again by the next read anyway
+	if(res == SCAP_FAILURE) {
+		handle->m_pending_res = res;
+	}
+	return SCAP_SUCCESS;
+}
+
 uint64_t scap_savefile_ftell(struct scap_engine_handle engine) {
 	scap_reader_t *reader = HANDLE(engine)->m_reader;
+	if(!reader) {
+		// Not available when the capture is read in parallel
+		return 0;
+	}
 	return reader->tell(reader);
 }
 
 void scap_savefile_fseek(struct scap_engine_handle engine, uint64_t off) {
 	scap_reader_t *reader = HANDLE(engine)->m_reader;
+	if(!reader) {
+		return;
+	}
 	reader->seek(reader, off, SEEK_SET);
+	HANDLE(engine)->m_pending_res = SCAP_SUCCESS;
 }
 
 static int32_t scap_savefile_init_platform(struct scap_platform *platform,
@@ -2069,6 +2928,101 @@ struct scap_platform *scap_savefile_alloc_platform(proc_entry_callback proc_call
 	return &platform->m_generic;
 }
 
+//
+// Look in the index file for the last checkpoint before the first event with
+// at least start_evt_num events before it and a timestamp of at least start_ts.
+// Returns false if there is none or if the index can't be read: the capture is
+// then read from the beginning.
+//
+static bool find_checkpoint(const char *fname,
+                            uint64_t start_ts,
+                            uint64_t start_evt_num,
+                            index_entry *checkpoint) {
+	block_header bh;
+	section_header_block sh;
+	index_entry entry;
+	bool found = false;
+
+	FILE *f = fopen(fname, "rb");
+	if(f == NULL) {
+		return false;
+	}
+
+	if(fread(&bh, sizeof(bh), 1, f) != 1 || bh.block_type != SHB_BLOCK_TYPE ||
+	   bh.block_total_length < sizeof(bh) + sizeof(sh) ||
+	   fread(&sh, sizeof(sh), 1, f) != 1 || sh.byte_order_magic != SHB_MAGIC ||
+	   fseek(f, bh.block_total_length - sizeof(bh) - sizeof(sh), SEEK_CUR) != 0) {
+		fclose(f);
+		return false;
+	}
+
+	while(fread(&bh, sizeof(bh), 1, f) == 1 && bh.block_total_length >= sizeof(bh)) {
+		uint32_t toread = bh.block_total_length - sizeof(bh);
+
+		if(bh.block_type == IDX_BLOCK_TYPE && toread >= sizeof(entry)) {
+			if(fread(&entry, sizeof(entry), 1, f) != 1) {
+				break;
+			}
+			toread -= sizeof(entry);
+
+			// Events before a checkpoint can have its same timestamp
+			if((start_evt_num != 0 && entry.evt_num > start_evt_num) ||
+			   (start_ts != 0 && entry.ts >= start_ts)) {
+				break;
+			}
+			*checkpoint = entry;
+			found = true;
+		}
+
+		if(fseek(f, toread, SEEK_CUR) != 0) {
+			break;
+		}
+	}
+
+	fclose(f);
+	return found;
+}
+
+//
+// Read up to the first event of a capture that doesn't start from the
+// beginning, and keep it for the next read
+//
+static int32_t skip_to_start(struct scap_engine_handle engine,
+                             uint64_t start_ts,
+                             uint64_t start_evt_num,
+                             const index_entry *checkpoint) {
+	struct savefile_engine *handle = engine.m_handle;
+	uint64_t evt_num = 0;
+	scap_evt *evt;
+	uint16_t devid;
+	uint32_t flags;
+	int32_t res;
+
+	if(checkpoint != NULL) {
+		scap_savefile_fseek(engine, checkpoint->offset);
+		handle->m_use_last_block_header = false;
+		evt_num = checkpoint->evt_num;
+	}
+
+	while((res = next(engine, &evt, &devid, &flags)) == SCAP_SUCCESS) {
+		if(evt_num >= start_evt_num && evt->ts >= start_ts) {
+			handle->m_pending_evt = evt;
+			handle->m_pending_devid = devid;
+			handle->m_pending_flags = flags;
+			return SCAP_SUCCESS;
+		}
+		evt_num++;
+	}
+
+	if(res == SCAP_FAILURE) {
+		return res;
+	}
+
+	// The capture ends, or its next section starts, before the event
+	handle->m_pending_res = res;
+	return SCAP_SUCCESS;
+}
+
 static void *alloc_handle(struct scap *main_handle, char *lasterr_ptr) {
 	struct savefile_engine *engine = calloc(1, sizeof(struct savefile_engine));
 	if(engine) {
@@ -2078,7 +3032,6 @@ static void *alloc_handle(struct scap *main_handle, char *lasterr_ptr) {
 }
 
 static int32_t init(struct scap *main_handle, struct scap_open_args *oargs) {
-	gzFile gzfile;
 	int res;
 	struct savefile_engine *handle = main_handle->m_engine.m_handle;
 	struct scap_savefile_engine_params *params = oargs->engine_params;
@@ -2086,45 +3039,50 @@ static int32_t init(struct scap *main_handle, struct scap_open_args *oargs) {
 	const char *fname = params->fname;
 	uint64_t start_offset = params->start_offset;
 	uint32_t fbuffer_size = params->fbuffer_size;
+	bool parallel = params->nfnames > 0 || params->nsegments > 0 || params->num_workers > 0;
+	bool skip = params->start_ts != 0 || params->start_evt_num != 0;
+	index_entry checkpoint;
+	bool use_checkpoint = false;
 
 	struct scap_platform *platform = params->platform;
 	handle->m_platform = params->platform;
 
-	if(fd != 0) {
-		gzfile = gzdopen(fd, "rb");
-	} else {
-		gzfile = gzopen(fname, "rb");
+	if(params->nfnames > 0) {
+		fd = 0;
+		fname = params->fnames[0];
 	}
 
-	if(gzfile == NULL) {
-		if(fd != 0) {
-			snprintf(main_handle->m_lasterr, SCAP_LASTERR_SIZE, "can't open fd %d", fd);
-		} else {
-			snprintf(main_handle->m_lasterr, SCAP_LASTERR_SIZE, "can't open file %s", fname);
+	if(skip) {
+		if(parallel) {
+			snprintf(main_handle->m_lasterr,
+			         SCAP_LASTERR_SIZE,
+			         "captures read in parallel can't start from a timestamp or an event number");
+			return SCAP_FAILURE;
+		}
+
+		// The checkpoint points to the section with the state of the capture at
+		// its event
+		if(params->index_fname != NULL &&
+		   find_checkpoint(params->index_fname,
+		                   params->start_ts,
+		                   params->start_evt_num,
+		                   &checkpoint)) {
+			use_checkpoint = true;
+			start_offset = checkpoint.section_offset;
 		}
-		return SCAP_FAILURE;
 	}
 
-	scap_reader_t *reader = scap_reader_open_gzfile(gzfile);
+	scap_reader_t *reader =
+	        open_reader(fd, fname, fbuffer_size, params->use_mmap, main_handle->m_lasterr);
 	if(!reader) {
-		gzclose(gzfile);
 		return SCAP_FAILURE;
 	}
 
-	if(fbuffer_size > 0) {
-		scap_reader_t *buffered_reader = scap_reader_open_buffered(reader, fbuffer_size, true);
-		if(!buffered_reader) {
-			reader->close(reader);
-			return SCAP_FAILURE;
-		}
-		reader = buffered_reader;
-	}
-
 	//
 	// If this is a merged file, we might have to move the read offset to the next section
 	//
 	if(start_offset != 0) {
-		scap_fseek(main_handle, start_offset);
+		reader->seek(reader, start_offset, SEEK_SET);
 	}
 
 	handle->m_use_last_block_header = false;
@@ -2142,6 +3100,17 @@ static int32_t init(struct scap *main_handle, struct scap_open_args *oargs) {
 		return res;
 	}
 
+	if(!oargs->import_users) {
+		if(platform->m_userlist != NULL) {
+			scap_free_userlist(platform->m_userlist);
+			platform->m_userlist = NULL;
+		}
+	}
+
+	if(parallel) {
+		return init_parallel(handle, params, reader, main_handle->m_lasterr);
+	}
+
 	handle->m_reader_evt_buf = (char *)malloc(READER_BUF_SIZE);
 	if(!handle->m_reader_evt_buf) {
 		snprintf(main_handle->m_lasterr, SCAP_LASTERR_SIZE, "error allocating the read buffer");
@@ -2150,11 +3119,11 @@ static int32_t init(struct scap *main_handle, struct scap_open_args *oargs) {
 	handle->m_reader_evt_buf_size = READER_BUF_SIZE;
 	handle->m_reader = reader;
 
-	if(!oargs->import_users) {
-		if(platform->m_userlist != NULL) {
-			scap_free_userlist(platform->m_userlist);
-			platform->m_userlist = NULL;
-		}
+	if(skip) {
+		return skip_to_start(main_handle->m_engine,
+		                     params->start_ts,
+		                     params->start_evt_num,
+		                     use_checkpoint ? &checkpoint : NULL);
 	}
 
 	return SCAP_SUCCESS;
@@ -2171,11 +3140,22 @@ static int32_t scap_savefile_close(struct scap_engine_handle engine) {
 		handle->m_reader = NULL;
 	}
 
+	if(handle->m_parallel) {
+		close_parallel(handle->m_parallel);
+		handle->m_parallel = NULL;
+	}
+
 	if(handle->m_reader_evt_buf) {
 		free(handle->m_reader_evt_buf);
 		handle->m_reader_evt_buf = NULL;
 	}
 
+	if(handle->m_batch_buf) {
+		free(handle->m_batch_buf);
+		handle->m_batch_buf = NULL;
+		handle->m_batch_buf_size = 0;
+	}
+
 	return SCAP_SUCCESS;
 }
 
@@ -2184,6 +3164,14 @@ static int32_t scap_savefile_restart_capture(scap_t *handle) {
 	struct scap_platform *platform = engine->m_platform;
 	int32_t res;
 
+	if(engine->m_parallel) {
+		snprintf(handle->m_lasterr,
+		         SCAP_LASTERR_SIZE,
+		         "could not restart capture: captures with several sections can't be read in "
+		         "parallel");
+		return SCAP_FAILURE;
+	}
+
 	scap_platform_close(platform);
 
 	if((res = scap_read_init(engine,
@@ -2204,6 +3192,9 @@ static int32_t scap_savefile_restart_capture(scap_t *handle) {
 }
 
 static int64_t get_readfile_offset(struct scap_engine_handle engine) {
+	if(HANDLE(engine)->m_parallel) {
+		return parallel_offset(HANDLE(engine)->m_parallel);
+	}
 	return HANDLE(engine)->m_reader->offset(HANDLE(engine)->m_reader);
 }
 
@@ -2234,4 +3225,5 @@ struct scap_vtable scap_savefile_engine = {
         .get_max_buf_used = noop_get_max_buf_used,
         .get_api_version = NULL,
         .get_schema_version = NULL,
+        .next_batch = next_batch,
 };
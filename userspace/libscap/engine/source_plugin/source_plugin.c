@@ -266,6 +266,36 @@ static int32_t next(struct scap_engine_handle engine,
 	return SCAP_SUCCESS;
 }
 
+static int32_t next_batch(struct scap_engine_handle engine,
+                          scap_evt** pevents,
+                          uint16_t* pdevids,
+                          uint32_t* pflags,
+                          uint32_t max_events,
+                          uint32_t* nevents) {
+	struct source_plugin_engine* handle = engine.m_handle;
+
+	*nevents = 0;
+	int32_t res = next(engine, &pevents[0], &pdevids[0], &pflags[0]);
+	if(res != SCAP_SUCCESS) {
+		return res;
+	}
+	*nevents = 1;
+
+	/* the events are owned by the plugin until we ask it for the next batch,
+	 * so we stop at the end of the current one */
+	while(*nevents < max_events &&
+	      handle->m_input_plugin_batch_idx < handle->m_input_plugin_batch_nevts) {
+		/* a malformed event is not consumed, the next call will report it */
+		if(next(engine, &pevents[*nevents], &pdevids[*nevents], &pflags[*nevents]) !=
+		   SCAP_SUCCESS) {
+			break;
+		}
+		(*nevents)++;
+	}
+
+	return SCAP_SUCCESS;
+}
+
 static int32_t get_stats(struct scap_engine_handle engine, scap_stats* stats) {
 	struct source_plugin_engine* handle = engine.m_handle;
 	stats->n_evts = handle->m_nevts;
@@ -318,4 +348,5 @@ const struct scap_vtable scap_source_plugin_engine = {
         .get_max_buf_used = noop_get_max_buf_used,
         .get_api_version = NULL,
         .get_schema_version = NULL,
+        .next_batch = next_batch,
 };
@@ -39,6 +39,7 @@ limitations under the License.
 #define NUM_EVENTS_OPTION "--num_events"
 #define EVENT_TYPE_OPTION "--evt_type"
 #define BUFFER_OPTION "--buffer_dim"
+#define WAKEUP_WATERMARK_OPTION "--wakeup_watermark"
 #define SIMPLE_SET_OPTION "--simple_set"
 #define CPUS_FOR_EACH_BUFFER_MODE "--cpus_for_buf"
 #define ALL_AVAILABLE_CPUS_MODE "--available_cpus"
@@ -515,6 +516,10 @@ void print_help() {
 	       "no print)\n",
 	       EVENT_TYPE_OPTION);
 	printf("'%s <dim>': dimension in bytes of a single per CPU buffer.\n", BUFFER_OPTION);
+	printf("'%s <bytes>': [BPF AND MODERN PROBE ONLY] block on the buffers and wake up when one "
+	       "of them holds `bytes` bytes, instead of sleeping when they are empty. (default: 0, "
+	       "sleep)\n",
+	       WAKEUP_WATERMARK_OPTION);
 	printf("[MODERN PROBE ONLY, EXPERIMENTAL]\n");
 	printf("'%s <cpus_for_each_buffer>': allocate a ring buffer for every `cpus_for_each_buffer` "
 	       "CPUs.\n",
@@ -665,6 +670,15 @@ void parse_CLI_options(int argc, char** argv) {
 			bpf_params.buffer_bytes_dim = buffer_bytes_dim;
 			modern_bpf_params.buffer_bytes_dim = buffer_bytes_dim;
 		}
+		if(!strcmp(argv[i], WAKEUP_WATERMARK_OPTION)) {
+			if(!(i + 1 < argc)) {
+				printf("\nYou need to specify also the wakeup watermark in bytes! Bye!\n");
+				exit(EXIT_FAILURE);
+			}
+			uint32_t wakeup_watermark = strtoul(argv[++i], NULL, 10);
+			bpf_params.wakeup_watermark = wakeup_watermark;
+			modern_bpf_params.wakeup_watermark = wakeup_watermark;
+		}
 		if(!strcmp(argv[i], PPM_SC_OPTION)) {
 			if(!(i + 1 < argc)) {
 				print_supported_sc();
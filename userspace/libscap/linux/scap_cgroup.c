@@ -447,10 +447,14 @@ static int32_t get_cgroup_subsystems_v2(struct scap_cgroup_interface* cgi,
                                         const char* cgroup_mount) {
 	if(cgi->m_use_cache) {
 		struct scap_cgroup_cache* cached;
+		pthread_mutex_lock(&cgi->m_cache_lock);
 		HASH_FIND_STR(cgi->m_cache, cgroup_mount, cached);
-
 		if(cached != NULL) {
 			*subsystems = cached->subsystems;
+		}
+		pthread_mutex_unlock(&cgi->m_cache_lock);
+
+		if(cached != NULL) {
 			return SCAP_SUCCESS;
 		}
 	}
@@ -505,8 +509,15 @@ static int32_t get_cgroup_subsystems_v2(struct scap_cgroup_interface* cgi,
 			snprintf(cached->path, sizeof(cached->path), "%s", cgroup_mount);
 			memcpy(&cached->subsystems, subsystems, sizeof(cached->subsystems));
 
-			HASH_ADD_STR(cgi->m_cache, path, cached);
-			if(uth_status != SCAP_SUCCESS) {
+			struct scap_cgroup_cache* existing;
+			pthread_mutex_lock(&cgi->m_cache_lock);
+			// another thread may have cached the same mount in the meantime
+			HASH_FIND_STR(cgi->m_cache, cgroup_mount, existing);
+			if(existing == NULL) {
+				HASH_ADD_STR(cgi->m_cache, path, cached);
+			}
+			pthread_mutex_unlock(&cgi->m_cache_lock);
+			if(existing != NULL || uth_status != SCAP_SUCCESS) {
 				free(cached);
 			}
 		}
@@ -597,6 +608,7 @@ int32_t scap_cgroup_interface_init(struct scap_cgroup_interface* cgi,
 
 	cgi->m_use_cache = true;
 	cgi->m_cache = NULL;
+	pthread_mutex_init(&cgi->m_cache_lock, NULL);
 	cgi->m_subsystems_v1.len = 0;
 	cgi->m_subsystems_v2.len = 0;
 	cgi->m_mounts_v1.len = 0;
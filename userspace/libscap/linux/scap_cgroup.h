@@ -18,6 +18,7 @@ limitations under the License.
 
 #pragma once
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -44,6 +45,7 @@ struct scap_cgroup_interface {
 
 	bool m_use_cache;
 	struct scap_cgroup_cache* m_cache;
+	pthread_mutex_t m_cache_lock;  // the parallel /proc scan shares the cache between threads
 
 	// the cgroups of the current process, as seen from the host cgroupns
 	// empty if:
@@ -1156,6 +1156,91 @@ char *decode_st_mode(struct stat *sb) {
 		break;
 	}
 }
+//
+// Get the network namespace of the process in procdir, 0 (i.e. global) if not available
+//
+static uint64_t scap_fd_get_net_ns(const char *procdir) {
+	char f_name[SCAP_MAX_PATH_SIZE];
+	char link_name[SCAP_MAX_PATH_SIZE];
+	uint64_t net_ns = 0;
+	ssize_t r;
+
+	snprintf(f_name, sizeof(f_name), "%sns/net", procdir);
+	r = readlink(f_name, link_name, sizeof(link_name) - 1);
+	if(r > 0) {
+		link_name[r] = '\0';
+		sscanf(link_name, "net:[%" PRIi64 "]", &net_ns);
+	}
+	return net_ns;
+}
+
+//
+// Read the details of the fd linked at f_name, whose target was stat'ed in sb,
+// and report it to the proclist callback
+//
+static int32_t scap_fd_handle_fd(struct scap_proclist *proclist,
+                                 char *f_name,
+                                 const struct stat *sb,
+                                 scap_threadinfo *tinfo,
+                                 scap_fdinfo *fdi,
+                                 char *procdir,
+                                 uint64_t net_ns,
+                                 struct scap_ns_socket_list **sockets_by_ns,
+                                 char *error) {
+	switch(sb->st_mode & S_IFMT) {
+	case S_IFIFO:
+		fdi->type = SCAP_FD_FIFO;
+		return scap_fd_handle_pipe(proclist, f_name, tinfo, fdi, error);
+	case S_IFREG:
+	case S_IFBLK:
+	case S_IFCHR:
+	case S_IFLNK:
+		fdi->type = SCAP_FD_FILE_V2;
+		fdi->ino = sb->st_ino;
+		return scap_fd_handle_regular_file(proclist, f_name, tinfo, fdi, procdir, error);
+	case S_IFDIR:
+		fdi->type = SCAP_FD_DIRECTORY;
+		fdi->ino = sb->st_ino;
+		return scap_fd_handle_regular_file(proclist, f_name, tinfo, fdi, procdir, error);
+	case S_IFSOCK:
+		fdi->type = SCAP_FD_UNKNOWN;
+		return scap_fd_handle_socket(proclist,
+		                             f_name,
+		                             tinfo,
+		                             fdi,
+		                             procdir,
+		                             net_ns,
+		                             sockets_by_ns,
+		                             error);
+	default:
+		fdi->type = SCAP_FD_UNSUPPORTED;
+		fdi->ino = sb->st_ino;
+		return scap_fd_handle_regular_file(proclist, f_name, tinfo, fdi, procdir, error);
+	}
+}
+
+//
+// In a lazy scan the fds are only classified by the type of their inode:
+// the socket family and the anon inode kind need the details of the fd
+//
+static scap_fd_type scap_fd_type_from_mode(mode_t mode) {
+	switch(mode & S_IFMT) {
+	case S_IFIFO:
+		return SCAP_FD_FIFO;
+	case S_IFREG:
+	case S_IFBLK:
+	case S_IFCHR:
+	case S_IFLNK:
+		return SCAP_FD_FILE_V2;
+	case S_IFDIR:
+		return SCAP_FD_DIRECTORY;
+	case S_IFSOCK:
+		return SCAP_FD_UNKNOWN;
+	default:
+		return SCAP_FD_UNSUPPORTED;
+	}
+}
+
 //
 // Scan the directory containing the fd's of a proc /proc/x/fd
 //
@@ -1171,12 +1256,10 @@ int32_t scap_fd_scan_fd_dir(struct scap_linux_platform *linux_platform,
 	int32_t res = SCAP_SUCCESS;
 	char fd_dir_name[SCAP_MAX_PATH_SIZE];
 	char f_name[SCAP_MAX_PATH_SIZE];
-	char link_name[SCAP_MAX_PATH_SIZE];
 	struct stat sb;
 	uint64_t fd;
 	scap_fdinfo fdi = {};
 	uint64_t net_ns;
-	ssize_t r;
 	uint32_t fd_added = 0;
 
 	if(num_fds_ret != NULL) {
@@ -1190,20 +1273,7 @@ int32_t scap_fd_scan_fd_dir(struct scap_linux_platform *linux_platform,
 		return SCAP_NOTFOUND;
 	}
 
-	//
-	// Get the network namespace of the process
-	//
-	snprintf(f_name, sizeof(f_name), "%sns/net", procdir);
-	r = readlink(f_name, link_name, sizeof(link_name) - 1);
-	if(r <= 0) {
-		//
-		// No network namespace available. Assume global
-		//
-		net_ns = 0;
-	} else {
-		link_name[r] = '\0';
-		sscanf(link_name, "net:[%" PRIi64 "]", &net_ns);
-	}
+	net_ns = linux_platform->m_proc_scan_lazy_fds ? 0 : scap_fd_get_net_ns(procdir);
 
 	while((dir_entry_p = readdir(dir_p)) != NULL &&
 	      (linux_platform->m_fd_lookup_limit == 0 ||
@@ -1221,42 +1291,30 @@ int32_t scap_fd_scan_fd_dir(struct scap_linux_platform *linux_platform,
 			continue;
 		}
 
-		switch(sb.st_mode & S_IFMT) {
-		case S_IFIFO:
-			fdi.type = SCAP_FD_FIFO;
-			res = scap_fd_handle_pipe(proclist, f_name, tinfo, &fdi, error);
-			break;
-		case S_IFREG:
-		case S_IFBLK:
-		case S_IFCHR:
-		case S_IFLNK:
-			fdi.type = SCAP_FD_FILE_V2;
-			fdi.ino = sb.st_ino;
-			res = scap_fd_handle_regular_file(proclist, f_name, tinfo, &fdi, procdir, error);
-			break;
-		case S_IFDIR:
-			fdi.type = SCAP_FD_DIRECTORY;
+		// In a lazy scan, skip the links and the socket tables: the consumer
+		// reads the details of the fds it needs with scap_get_fdinfo()
+		if(linux_platform->m_proc_scan_lazy_fds) {
+			fdi.type = scap_fd_type_from_mode(sb.st_mode);
 			fdi.ino = sb.st_ino;
-			res = scap_fd_handle_regular_file(proclist, f_name, tinfo, &fdi, procdir, error);
-			break;
-		case S_IFSOCK:
-			fdi.type = SCAP_FD_UNKNOWN;
-			res = scap_fd_handle_socket(proclist,
-			                            f_name,
-			                            tinfo,
-			                            &fdi,
-			                            procdir,
-			                            net_ns,
-			                            sockets_by_ns,
-			                            error);
-			break;
-		default:
-			fdi.type = SCAP_FD_UNSUPPORTED;
-			fdi.ino = sb.st_ino;
-			res = scap_fd_handle_regular_file(proclist, f_name, tinfo, &fdi, procdir, error);
-			break;
+			proclist->m_proc_callback(proclist->m_proc_callback_context,
+			                          error,
+			                          tinfo->tid,
+			                          tinfo,
+			                          &fdi,
+			                          NULL);
+			++fd_added;
+			continue;
 		}
 
+		res = scap_fd_handle_fd(proclist,
+		                        f_name,
+		                        &sb,
+		                        tinfo,
+		                        &fdi,
+		                        procdir,
+		                        net_ns,
+		                        sockets_by_ns,
+		                        error);
 		if(SCAP_SUCCESS != res) {
 			break;
 		} else {
@@ -1271,3 +1329,68 @@ int32_t scap_fd_scan_fd_dir(struct scap_linux_platform *linux_platform,
 
 	return res;
 }
+
+struct scap_single_fd {
+	scap_fdinfo *fdi;
+	bool found;
+};
+
+static int32_t single_fd_proc_callback(void *context,
+                                       char *error,
+                                       int64_t tid,
+                                       scap_threadinfo *tinfo,
+                                       scap_fdinfo *fdinfo,
+                                       scap_threadinfo **new_tinfo) {
+	struct scap_single_fd *out = (struct scap_single_fd *)context;
+
+	if(fdinfo != NULL) {
+		memcpy(out->fdi, fdinfo, sizeof(*fdinfo));
+		out->found = true;
+	}
+	return SCAP_SUCCESS;
+}
+
+//
+// Read the details of a single fd (`fdi->fd`) of the process in procdir
+//
+int32_t scap_fd_read_fd(char *procdir, int64_t pid, scap_fdinfo *fdi, char *error) {
+	char f_name[SCAP_MAX_PATH_SIZE];
+	struct stat sb;
+	scap_fdinfo work_fdi = {};
+	struct scap_proclist single_fd_proclist;
+	struct scap_single_fd out = {.fdi = fdi, .found = false};
+	struct scap_ns_socket_list *sockets_by_ns = NULL;
+
+	// The fd handlers only need the tid of the owner
+	scap_threadinfo tinfo;
+	tinfo.tid = pid;
+	tinfo.pid = pid;
+
+	snprintf(f_name, sizeof(f_name), "%sfd/%" PRId64, procdir, fdi->fd);
+	if(stat(f_name, &sb) == -1) {
+		scap_errprintf(error, errno, "can't stat %s", f_name);
+		return SCAP_NOTFOUND;
+	}
+
+	init_proclist(&single_fd_proclist, single_fd_proc_callback, &out);
+	work_fdi.fd = fdi->fd;
+
+	int32_t res = scap_fd_handle_fd(&single_fd_proclist,
+	                                f_name,
+	                                &sb,
+	                                &tinfo,
+	                                &work_fdi,
+	                                procdir,
+	                                S_ISSOCK(sb.st_mode) ? scap_fd_get_net_ns(procdir) : 0,
+	                                &sockets_by_ns,
+	                                error);
+	if(sockets_by_ns != NULL) {
+		scap_fd_free_ns_sockets_list(&sockets_by_ns);
+	}
+
+	if(res == SCAP_SUCCESS && !out.found) {
+		scap_errprintf(error, 0, "can't read the details of %s", f_name);
+		return SCAP_NOTFOUND;
+	}
+	return res;
+}
@@ -54,6 +54,10 @@ int32_t scap_linux_proc_get(struct scap_platform* platform,
                             bool scan_sockets);
 int32_t scap_linux_refresh_proc_table(struct scap_platform* platform,
                                       struct scap_proclist* proclist);
+int32_t scap_linux_scan_proc_table(struct scap_linux_platform* linux_platform,
+                                   struct scap_proclist* proclist,
+                                   char* procdirname,
+                                   char* error);
 bool scap_linux_is_thread_alive(struct scap_platform* platform,
                                 int64_t pid,
                                 int64_t tid,
@@ -62,6 +66,10 @@ int32_t scap_linux_getpid_global(struct scap_platform* platform, int64_t* pid, c
 int32_t scap_linux_get_threadlist(struct scap_platform* platform,
                                   struct ppm_proclist_info** procinfo_p,
                                   char* lasterr);
+int32_t scap_linux_get_fdinfo(struct scap_platform* platform,
+                              int64_t pid,
+                              struct scap_fdinfo* fdinfo,
+                              char* lasterr);
 int32_t scap_linux_get_fdlist(struct scap_platform* platform,
                               struct scap_threadinfo* tinfo,
                               char* lasterr);
@@ -70,6 +78,7 @@ int32_t scap_linux_get_fdlist(struct scap_platform* platform,
 int32_t scap_fd_read_sockets(char* procdir, struct scap_ns_socket_list* sockets, char* error);
 void scap_fd_free_ns_sockets_list(struct scap_ns_socket_list** sockets);
 // read the file descriptors for a given process directory
+int32_t scap_fd_read_fd(char* procdir, int64_t pid, scap_fdinfo* fdi, char* error);
 int32_t scap_fd_scan_fd_dir(struct scap_linux_platform* linux_platform,
                             struct scap_proclist* proclist,
                             char* procdir,
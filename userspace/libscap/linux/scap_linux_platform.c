@@ -60,6 +60,8 @@ int32_t scap_linux_init_platform(struct scap_platform* platform,
 	linux_platform->m_engine = engine;
 	linux_platform->m_proc_scan_timeout_ms = oargs->proc_scan_timeout_ms;
 	linux_platform->m_proc_scan_log_interval_ms = oargs->proc_scan_log_interval_ms;
+	linux_platform->m_proc_scan_num_threads = oargs->proc_scan_num_threads;
+	linux_platform->m_proc_scan_lazy_fds = oargs->proc_scan_lazy_fds;
 	linux_platform->m_log_fn = oargs->log_fn;
 
 	if(scap_os_get_machine_info(&platform->m_machine_info, lasterr) != SCAP_SUCCESS) {
@@ -117,6 +119,7 @@ static const struct scap_platform_vtable scap_linux_platform_vtable = {
         .get_global_pid = scap_linux_getpid_global,
         .get_threadlist = scap_linux_get_threadlist,
         .get_fdlist = scap_linux_get_fdlist,
+        .get_fdinfo = scap_linux_get_fdinfo,
         .close_platform = scap_linux_close_platform,
         .free_platform = scap_linux_free_platform,
 };
@@ -91,6 +91,8 @@ struct scap_linux_platform {
 	// /proc scan parameters
 	uint64_t m_proc_scan_timeout_ms;
 	uint64_t m_proc_scan_log_interval_ms;
+	uint32_t m_proc_scan_num_threads;
+	bool m_proc_scan_lazy_fds;
 
 	falcosecurity_log_fn m_log_fn;
 
@@ -29,6 +29,7 @@ limitations under the License.
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <pthread.h>
 
 #include <libscap/linux/unixid.h>
 #include <libscap/scap.h>
@@ -501,6 +502,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	size_t exe_len;
 	int32_t res = SCAP_SUCCESS;
 	struct stat dirstat;
+	char fill_error[SCAP_LASTERR_SIZE] = "";  // not the platform lasterr, we can run on many threads
 
 	memset(&tinfo, 0, sizeof(scap_threadinfo));
 
@@ -646,24 +648,24 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// set the current working directory of the process
 	//
-	if(SCAP_FAILURE == scap_proc_fill_cwd(linux_platform->m_lasterr, dir_name, &tinfo)) {
+	if(SCAP_FAILURE == scap_proc_fill_cwd(fill_error, dir_name, &tinfo)) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill cwd for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
 	//
 	// extract the user id and ppid from /proc/pid/status
 	//
 	if(SCAP_FAILURE ==
-	   scap_proc_fill_info_from_stats(linux_platform->m_lasterr, dir_name, &tinfo)) {
+	   scap_proc_fill_info_from_stats(fill_error, dir_name, &tinfo)) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill uid and pid for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
 	//
@@ -674,21 +676,21 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 		                      0,
 		                      "can't fill flimit for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
 	if(scap_cgroup_get_thread(&linux_platform->m_cgroups,
 	                          dir_name,
 	                          &tinfo.cgroups,
-	                          linux_platform->m_lasterr) == SCAP_FAILURE) {
+	                          fill_error) == SCAP_FAILURE) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill cgroups for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
-	if(scap_proc_fill_pidns_start_ts(linux_platform->m_lasterr, &tinfo, dir_name) == SCAP_FAILURE) {
+	if(scap_proc_fill_pidns_start_ts(fill_error, &tinfo, dir_name) == SCAP_FAILURE) {
 		// ignore errors
 		// the thread may not have /proc visible so we shouldn't kill the scan if this fails
 	}
@@ -706,23 +708,23 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// set the current root of the process
 	//
-	if(SCAP_FAILURE == scap_proc_fill_root(linux_platform->m_lasterr, &tinfo, dir_name)) {
+	if(SCAP_FAILURE == scap_proc_fill_root(fill_error, &tinfo, dir_name)) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill root for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
 	//
 	// set the loginuid
 	//
-	if(SCAP_FAILURE == scap_proc_fill_loginuid(linux_platform->m_lasterr, &tinfo, dir_name)) {
+	if(SCAP_FAILURE == scap_proc_fill_loginuid(fill_error, &tinfo, dir_name)) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill loginuid for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
 	// Container start time for host processes will be equal to when the
@@ -748,7 +750,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 		tinfo.flags = PPM_CL_CLONE_THREAD | PPM_CL_CLONE_FILES;
 	}
 
-	if(SCAP_FAILURE == scap_proc_fill_exe_ino_ctime_mtime(linux_platform->m_lasterr,
+	if(SCAP_FAILURE == scap_proc_fill_exe_ino_ctime_mtime(fill_error,
 	                                                      &tinfo,
 	                                                      dir_name,
 	                                                      target_name)) {
@@ -756,10 +758,10 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 		                      0,
 		                      "can't fill exe writable access for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
-	if(SCAP_FAILURE == scap_proc_fill_exe_writable(linux_platform->m_lasterr,
+	if(SCAP_FAILURE == scap_proc_fill_exe_writable(fill_error,
 	                                               &tinfo,
 	                                               tinfo.uid,
 	                                               tinfo.gid,
@@ -769,7 +771,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 		                      0,
 		                      "can't fill exe writable access for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      fill_error);
 	}
 
 	scap_threadinfo* new_tinfo = &tinfo;
@@ -858,6 +860,139 @@ int32_t scap_proc_read_thread(struct scap_linux_platform* linux_platform,
 	return res;
 }
 
+//
+// Progress of the top-level /proc scan, used to log it and to enforce the scan timeout
+//
+struct scap_proc_scan_progress {
+	bool do_timing;
+	uint64_t monotonic_ts_context;
+	uint64_t start_ts_ms;
+	uint64_t last_log_ts_ms;
+	uint64_t last_proc_ts_ms;
+	uint64_t min_proc_time_ms;
+	uint64_t max_proc_time_ms;
+	uint64_t num_procs_processed;
+	uint64_t total_num_fds;
+	uint64_t last_tid_processed;
+};
+
+static void proc_scan_progress_init(struct scap_linux_platform* linux_platform,
+                                    struct scap_proc_scan_progress* progress,
+                                    bool top_level) {
+	// Do timing tracking only if:
+	// - this is the top-level call
+	// - one or both of the timing parameters is configured to non-zero
+	progress->do_timing =
+	        top_level &&
+	        ((linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) ||
+	         (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE));
+	progress->monotonic_ts_context = SCAP_GET_CUR_TS_MS_CONTEXT_INIT;
+	progress->start_ts_ms = 0;
+	progress->last_log_ts_ms = 0;
+	progress->last_proc_ts_ms = 0;
+	progress->min_proc_time_ms = UINT64_MAX;
+	progress->max_proc_time_ms = 0;
+	progress->num_procs_processed = 0;
+	progress->total_num_fds = 0;
+	progress->last_tid_processed = 0;
+
+	if(progress->do_timing) {
+		progress->start_ts_ms = scap_get_monotonic_ts_ms(&progress->monotonic_ts_context);
+		progress->last_log_ts_ms = progress->start_ts_ms;
+		progress->last_proc_ts_ms = progress->start_ts_ms;
+	}
+}
+
+//
+// Account for a successfully processed process and perform timing processing if configured.
+// Returns true if the scan timeout expired.
+//
+static bool proc_scan_progress_add(struct scap_linux_platform* linux_platform,
+                                   struct scap_proc_scan_progress* progress,
+                                   uint64_t tid,
+                                   uint64_t num_fds) {
+	progress->last_tid_processed = tid;
+	progress->num_procs_processed++;
+	progress->total_num_fds += num_fds;
+
+	if(!progress->do_timing) {
+		return false;
+	}
+
+	uint64_t cur_ts_ms = scap_get_monotonic_ts_ms(&progress->monotonic_ts_context);
+	uint64_t total_elapsed_time_ms = cur_ts_ms - progress->start_ts_ms;
+
+	uint64_t this_proc_elapsed_time_ms = cur_ts_ms - progress->last_proc_ts_ms;
+	progress->last_proc_ts_ms = cur_ts_ms;
+
+	if(this_proc_elapsed_time_ms < progress->min_proc_time_ms) {
+		progress->min_proc_time_ms = this_proc_elapsed_time_ms;
+	}
+	if(this_proc_elapsed_time_ms > progress->max_proc_time_ms) {
+		progress->max_proc_time_ms = this_proc_elapsed_time_ms;
+	}
+
+	if(linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) {
+		uint64_t log_elapsed_time_ms = cur_ts_ms - progress->last_log_ts_ms;
+		if(log_elapsed_time_ms >= linux_platform->m_proc_scan_log_interval_ms) {
+			scap_debug_log(linux_platform,
+			               "scap_proc_scan: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, "
+			               "last pid %ld, num_fds %ld",
+			               progress->num_procs_processed,
+			               total_elapsed_time_ms,
+			               (total_elapsed_time_ms / (uint64_t)progress->num_procs_processed),
+			               progress->min_proc_time_ms,
+			               progress->max_proc_time_ms,
+			               progress->last_tid_processed,
+			               progress->total_num_fds);
+			progress->last_log_ts_ms = cur_ts_ms;
+		}
+	}
+
+	return linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE &&
+	       total_elapsed_time_ms >= linux_platform->m_proc_scan_timeout_ms;
+}
+
+static void proc_scan_progress_done(struct scap_linux_platform* linux_platform,
+                                    struct scap_proc_scan_progress* progress,
+                                    bool timeout_expired) {
+	if(!progress->do_timing) {
+		return;
+	}
+
+	uint64_t cur_ts_ms = scap_get_monotonic_ts_ms(&progress->monotonic_ts_context);
+	uint64_t total_elapsed_time_ms = cur_ts_ms - progress->start_ts_ms;
+	uint64_t avg_proc_time_ms = (progress->num_procs_processed != 0)
+	                                    ? (total_elapsed_time_ms / progress->num_procs_processed)
+	                                    : 0;
+
+	if(timeout_expired) {
+		scap_debug_log(linux_platform,
+		               "scap_proc_scan TIMEOUT (%ld ms): %ld proc in %ld ms, "
+		               "avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
+		               linux_platform->m_proc_scan_timeout_ms,
+		               progress->num_procs_processed,
+		               total_elapsed_time_ms,
+		               avg_proc_time_ms,
+		               progress->min_proc_time_ms,
+		               progress->max_proc_time_ms,
+		               progress->last_tid_processed,
+		               progress->total_num_fds);
+	} else if((linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) &&
+	          (progress->num_procs_processed != 0)) {
+		scap_debug_log(linux_platform,
+		               "scap_proc_scan DONE: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last "
+		               "pid %ld, num_fds %ld",
+		               progress->num_procs_processed,
+		               total_elapsed_time_ms,
+		               avg_proc_time_ms,
+		               progress->min_proc_time_ms,
+		               progress->max_proc_time_ms,
+		               progress->last_tid_processed,
+		               progress->total_num_fds);
+	}
+}
+
 //
 // Scan a directory containing multiple processes under /proc
 //
@@ -873,9 +1008,7 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 	int32_t res = SCAP_SUCCESS;
 	char childdir[SCAP_MAX_PATH_SIZE];
 
-	uint64_t num_procs_processed = 0;
-	uint64_t total_num_fds = 0;
-	uint64_t last_tid_processed = 0;
+	struct scap_proc_scan_progress progress;
 	struct scap_ns_socket_list* sockets_by_ns = NULL;
 
 	dir_p = opendir(procdirname);
@@ -885,25 +1018,7 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		return SCAP_NOTFOUND;
 	}
 
-	// Do timing tracking only if:
-	// - this is the top-level call (parenttid == -1)
-	// - one or both of the timing parameters is configured to non-zero
-	bool do_timing = (parenttid == -1) &&
-	                 ((linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) ||
-	                  (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE));
-	uint64_t monotonic_ts_context = SCAP_GET_CUR_TS_MS_CONTEXT_INIT;
-	uint64_t start_ts_ms = 0;
-	uint64_t last_log_ts_ms = 0;
-	uint64_t last_proc_ts_ms = 0;
-	uint64_t cur_ts_ms = 0;
-	uint64_t min_proc_time_ms = UINT64_MAX;
-	uint64_t max_proc_time_ms = 0;
-
-	if(do_timing) {
-		start_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-		last_log_ts_ms = start_ts_ms;
-		last_proc_ts_ms = start_ts_ms;
-	}
+	proc_scan_progress_init(linux_platform, &progress, parenttid == -1);
 
 	bool timeout_expired = false;
 	while(!timeout_expired) {
@@ -985,88 +1100,338 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		}
 
 		// TID successfully processed.
-		last_tid_processed = tid;
-		num_procs_processed++;
-		total_num_fds += num_fds_this_proc;
-
-		// After successful processing of a process at the top level,
-		// perform timing processing if configured.
-		if(do_timing) {
-			cur_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-			uint64_t total_elapsed_time_ms = cur_ts_ms - start_ts_ms;
+		timeout_expired = proc_scan_progress_add(linux_platform, &progress, tid, num_fds_this_proc);
+	}
 
-			uint64_t this_proc_elapsed_time_ms = cur_ts_ms - last_proc_ts_ms;
-			last_proc_ts_ms = cur_ts_ms;
+	proc_scan_progress_done(linux_platform, &progress, timeout_expired);
 
-			if(this_proc_elapsed_time_ms < min_proc_time_ms) {
-				min_proc_time_ms = this_proc_elapsed_time_ms;
-			}
-			if(this_proc_elapsed_time_ms > max_proc_time_ms) {
-				max_proc_time_ms = this_proc_elapsed_time_ms;
-			}
+	closedir(dir_p);
+	if(sockets_by_ns != NULL && sockets_by_ns != (void*)-1) {
+		scap_fd_free_ns_sockets_list(&sockets_by_ns);
+	}
+	return res;
+}
 
-			if(linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) {
-				uint64_t log_elapsed_time_ms = cur_ts_ms - last_log_ts_ms;
-				if(log_elapsed_time_ms >= linux_platform->m_proc_scan_log_interval_ms) {
-					scap_debug_log(linux_platform,
-					               "scap_proc_scan: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, "
-					               "last pid %ld, num_fds %ld",
-					               num_procs_processed,
-					               total_elapsed_time_ms,
-					               (total_elapsed_time_ms / (uint64_t)num_procs_processed),
-					               min_proc_time_ms,
-					               max_proc_time_ms,
-					               last_tid_processed,
-					               total_num_fds);
-					last_log_ts_ms = cur_ts_ms;
-				}
+//
+// A process explored by a worker of the parallel /proc scan. The worker buffers
+// what the scan finds (the process first, then its fds and its tasks) and the main
+// thread replays it into the real proclist, in the order of the /proc entries,
+// so the callbacks are never invoked concurrently.
+//
+struct scap_proc_scan_job {
+	uint64_t tid;
+	int32_t res;
+	uint64_t num_fds;
+	bool oom;
+	bool done;  // protected by the pool lock
+	scap_threadinfo* tinfos;
+	uint32_t num_tinfos;
+	uint32_t tinfos_size;
+	scap_fdinfo* fdinfos;
+	uint32_t num_fdinfos;
+	uint32_t fdinfos_size;
+};
+
+struct scap_proc_scan_pool {
+	struct scap_linux_platform* linux_platform;
+	char* procdirname;
+	uint64_t* tids;
+	uint32_t num_tids;
+	// Ring of jobs: the job for `tids[i]` lives in `jobs[i % num_jobs]`,
+	// so workers can only run `num_jobs` processes ahead of the replay
+	struct scap_proc_scan_job* jobs;
+	uint32_t num_jobs;
+	pthread_mutex_t lock;
+	pthread_cond_t job_done;
+	pthread_cond_t slot_free;
+	uint32_t next_tid;
+	uint32_t num_replayed;
+	bool stop;
+};
+
+static int32_t proc_scan_job_callback(void* context,
+                                      char* error,
+                                      int64_t tid,
+                                      scap_threadinfo* tinfo,
+                                      scap_fdinfo* fdinfo,
+                                      scap_threadinfo** new_tinfo) {
+	struct scap_proc_scan_job* job = (struct scap_proc_scan_job*)context;
+
+	if(fdinfo != NULL) {
+		if(job->num_fdinfos == job->fdinfos_size) {
+			uint32_t size = job->fdinfos_size ? job->fdinfos_size * 2 : 64;
+			scap_fdinfo* fdinfos = realloc(job->fdinfos, size * sizeof(scap_fdinfo));
+			if(fdinfos == NULL) {
+				job->oom = true;
+				return SCAP_FAILURE;
 			}
+			job->fdinfos = fdinfos;
+			job->fdinfos_size = size;
+		}
+		job->fdinfos[job->num_fdinfos++] = *fdinfo;
+		return SCAP_SUCCESS;
+	}
 
-			if(linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) {
-				if(total_elapsed_time_ms >= linux_platform->m_proc_scan_timeout_ms) {
-					timeout_expired = true;
-				}
+	//
+	// The fds of a process are scanned before its tasks are added, so the process
+	// entry is not moved by a realloc while the fd scan still points to it
+	//
+	if(job->num_tinfos == job->tinfos_size) {
+		uint32_t size = job->tinfos_size ? job->tinfos_size * 2 : 4;
+		scap_threadinfo* tinfos = realloc(job->tinfos, size * sizeof(scap_threadinfo));
+		if(tinfos == NULL) {
+			job->oom = true;
+			if(new_tinfo) {
+				*new_tinfo = tinfo;
 			}
+			return SCAP_FAILURE;
 		}
+		job->tinfos = tinfos;
+		job->tinfos_size = size;
+	}
+	job->tinfos[job->num_tinfos] = *tinfo;
+	if(new_tinfo) {
+		*new_tinfo = &job->tinfos[job->num_tinfos];
 	}
+	job->num_tinfos++;
+	return SCAP_SUCCESS;
+}
 
-	if(do_timing) {
-		cur_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-		uint64_t total_elapsed_time_ms = cur_ts_ms - start_ts_ms;
-		uint64_t avg_proc_time_ms =
-		        (num_procs_processed != 0) ? (total_elapsed_time_ms / num_procs_processed) : 0;
+static void proc_scan_job_run(struct scap_proc_scan_pool* pool,
+                              struct scap_proc_scan_job* job,
+                              uint64_t tid,
+                              struct scap_ns_socket_list** sockets_by_ns) {
+	struct scap_proclist job_proclist;
+	char add_error[SCAP_LASTERR_SIZE];
+	char childdir[SCAP_MAX_PATH_SIZE];
 
-		if(timeout_expired) {
-			scap_debug_log(linux_platform,
-			               "scap_proc_scan TIMEOUT (%ld ms): %ld proc in %ld ms, "
-			               "avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
-			               linux_platform->m_proc_scan_timeout_ms,
-			               num_procs_processed,
-			               total_elapsed_time_ms,
-			               avg_proc_time_ms,
-			               min_proc_time_ms,
-			               max_proc_time_ms,
-			               last_tid_processed,
-			               total_num_fds);
-		} else if((linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) &&
-		          (num_procs_processed != 0)) {
-			scap_debug_log(linux_platform,
-			               "scap_proc_scan DONE: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last "
-			               "pid %ld, num_fds %ld",
-			               num_procs_processed,
-			               total_elapsed_time_ms,
-			               avg_proc_time_ms,
-			               min_proc_time_ms,
-			               max_proc_time_ms,
-			               last_tid_processed,
-			               total_num_fds);
+	init_proclist(&job_proclist, proc_scan_job_callback, job);
+	job->tid = tid;
+	job->num_fds = 0;
+	job->oom = false;
+	job->num_tinfos = 0;
+	job->num_fdinfos = 0;
+
+	job->res = scap_proc_add_from_proc(pool->linux_platform,
+	                                   &job_proclist,
+	                                   tid,
+	                                   pool->procdirname,
+	                                   sockets_by_ns,
+	                                   &job->num_fds,
+	                                   add_error);
+	if(job->res != SCAP_SUCCESS || pool->linux_platform->m_minimal_scan) {
+		return;
+	}
+
+	//
+	// The job proclist is always empty, so the task scan can't find duplicates
+	// here: they are checked during the replay
+	//
+	snprintf(childdir, sizeof(childdir), "%s/%u/task", pool->procdirname, (int)tid);
+	_scap_proc_scan_proc_dir_impl(pool->linux_platform, &job_proclist, childdir, tid, add_error);
+}
+
+static void* proc_scan_worker(void* arg) {
+	struct scap_proc_scan_pool* pool = (struct scap_proc_scan_pool*)arg;
+	struct scap_ns_socket_list* sockets_by_ns = NULL;
+
+	pthread_mutex_lock(&pool->lock);
+	while(true) {
+		while(!pool->stop && pool->next_tid < pool->num_tids &&
+		      pool->next_tid >= pool->num_replayed + pool->num_jobs) {
+			pthread_cond_wait(&pool->slot_free, &pool->lock);
 		}
+		if(pool->stop || pool->next_tid == pool->num_tids) {
+			break;
+		}
+
+		uint32_t idx = pool->next_tid++;
+		struct scap_proc_scan_job* job = &pool->jobs[idx % pool->num_jobs];
+		pthread_mutex_unlock(&pool->lock);
+
+		proc_scan_job_run(pool, job, pool->tids[idx], &sockets_by_ns);
+
+		pthread_mutex_lock(&pool->lock);
+		job->done = true;
+		pthread_cond_signal(&pool->job_done);
 	}
+	pthread_mutex_unlock(&pool->lock);
 
-	closedir(dir_p);
 	if(sockets_by_ns != NULL && sockets_by_ns != (void*)-1) {
 		scap_fd_free_ns_sockets_list(&sockets_by_ns);
 	}
+	return NULL;
+}
+
+//
+// Feed the entries buffered by a job to the real proclist, exactly as the serial scan
+// would have done
+//
+static int32_t proc_scan_job_replay(struct scap_proclist* proclist,
+                                    struct scap_proc_scan_job* job,
+                                    char* error) {
+	scap_threadinfo* tinfo;
+
+	if(job->oom) {
+		return scap_errprintf(error,
+		                      0,
+		                      "can't allocate the scan buffers for tid %" PRIu64,
+		                      job->tid);
+	}
+
+	for(uint32_t i = 0; i < job->num_tinfos; i++) {
+		HASH_FIND_INT64(proclist->m_proclist, &job->tinfos[i].tid, tinfo);
+		if(tinfo != NULL) {
+			ASSERT(false);
+			return scap_errprintf(error, 0, "duplicate process %" PRIu64, job->tinfos[i].tid);
+		}
+
+		scap_threadinfo* new_tinfo = &job->tinfos[i];
+		proclist->m_proc_callback(proclist->m_proc_callback_context,
+		                          error,
+		                          job->tinfos[i].tid,
+		                          &job->tinfos[i],
+		                          NULL,
+		                          &new_tinfo);
+
+		// The fds belong to the process, i.e. the first entry
+		for(uint32_t j = 0; i == 0 && j < job->num_fdinfos; j++) {
+			proclist->m_proc_callback(proclist->m_proc_callback_context,
+			                          error,
+			                          new_tinfo->tid,
+			                          new_tinfo,
+			                          &job->fdinfos[j],
+			                          NULL);
+		}
+	}
+
+	return SCAP_SUCCESS;
+}
+
+//
+// Scan the top-level /proc directory with `m_proc_scan_num_threads` workers
+//
+static int32_t _scap_proc_scan_proc_dir_parallel(struct scap_linux_platform* linux_platform,
+                                                 struct scap_proclist* proclist,
+                                                 char* procdirname,
+                                                 char* error) {
+	DIR* dir_p;
+	struct dirent* dir_entry_p;
+	int32_t res = SCAP_SUCCESS;
+	struct scap_proc_scan_pool pool = {
+	        .linux_platform = linux_platform,
+	        .procdirname = procdirname,
+	};
+	uint32_t tids_size = 0;
+
+	dir_p = opendir(procdirname);
+	if(dir_p == NULL) {
+		scap_errprintf(error, errno, "error opening the %s directory", procdirname);
+		return SCAP_NOTFOUND;
+	}
+
+	//
+	// Collect the tids first, so that the workers can shard them and the replay
+	// follows the directory order
+	//
+	while((dir_entry_p = readdir(dir_p)) != NULL) {
+		if(strspn(dir_entry_p->d_name, "0123456789") != strlen(dir_entry_p->d_name)) {
+			continue;
+		}
+
+		if(pool.num_tids == tids_size) {
+			tids_size = tids_size ? tids_size * 2 : 1024;
+			uint64_t* tids = realloc(pool.tids, tids_size * sizeof(uint64_t));
+			if(tids == NULL) {
+				free(pool.tids);
+				closedir(dir_p);
+				return scap_errprintf(error, 0, "can't allocate the /proc scan tid list");
+			}
+			pool.tids = tids;
+		}
+		pool.tids[pool.num_tids++] = atoi(dir_entry_p->d_name);
+	}
+	closedir(dir_p);
+
+	uint32_t num_threads = MIN(linux_platform->m_proc_scan_num_threads, pool.num_tids);
+	pool.num_jobs = num_threads * 16;
+	pool.jobs = calloc(pool.num_jobs, sizeof(struct scap_proc_scan_job));
+	pthread_t* threads = calloc(num_threads, sizeof(pthread_t));
+	if(num_threads == 0 || pool.jobs == NULL || threads == NULL) {
+		free(pool.jobs);
+		free(threads);
+		free(pool.tids);
+		if(num_threads == 0) {
+			return SCAP_SUCCESS;
+		}
+		return scap_errprintf(error, 0, "can't allocate the /proc scan workers");
+	}
+
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.job_done, NULL);
+	pthread_cond_init(&pool.slot_free, NULL);
+
+	uint32_t num_started = 0;
+	int create_err = 0;
+	for(; num_started < num_threads; num_started++) {
+		create_err = pthread_create(&threads[num_started], NULL, proc_scan_worker, &pool);
+		if(create_err != 0) {
+			break;
+		}
+	}
+
+	struct scap_proc_scan_progress progress;
+	proc_scan_progress_init(linux_platform, &progress, true);
+
+	bool timeout_expired = false;
+	if(num_started == 0) {
+		res = scap_errprintf(error, create_err, "can't start the /proc scan workers");
+	}
+
+	pthread_mutex_lock(&pool.lock);
+	while(res == SCAP_SUCCESS && !timeout_expired && pool.num_replayed < pool.num_tids) {
+		struct scap_proc_scan_job* job = &pool.jobs[pool.num_replayed % pool.num_jobs];
+		while(!job->done) {
+			pthread_cond_wait(&pool.job_done, &pool.lock);
+		}
+		pthread_mutex_unlock(&pool.lock);
+
+		res = proc_scan_job_replay(proclist, job, error);
+
+		//
+		// As in the serial scan, processes that could not be read are dropped
+		// and don't count as processed
+		//
+		if(res == SCAP_SUCCESS && job->res == SCAP_SUCCESS) {
+			timeout_expired =
+			        proc_scan_progress_add(linux_platform, &progress, job->tid, job->num_fds);
+		}
+
+		pthread_mutex_lock(&pool.lock);
+		job->done = false;
+		pool.num_replayed++;
+		pthread_cond_broadcast(&pool.slot_free);
+	}
+	pool.stop = true;
+	pthread_cond_broadcast(&pool.slot_free);
+	pthread_mutex_unlock(&pool.lock);
+
+	for(uint32_t i = 0; i < num_started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	proc_scan_progress_done(linux_platform, &progress, timeout_expired);
+
+	pthread_cond_destroy(&pool.slot_free);
+	pthread_cond_destroy(&pool.job_done);
+	pthread_mutex_destroy(&pool.lock);
+	for(uint32_t i = 0; i < pool.num_jobs; i++) {
+		free(pool.jobs[i].tinfos);
+		free(pool.jobs[i].fdinfos);
+	}
+	free(pool.jobs);
+	free(threads);
+	free(pool.tids);
 	return res;
 }
 
@@ -1174,12 +1539,24 @@ int32_t scap_linux_refresh_proc_table(struct scap_platform* platform,
 	}
 
 	snprintf(procdirname, sizeof(procdirname), "%s/proc", scap_get_host_root());
+	return scap_linux_scan_proc_table(linux_platform,
+	                                  proclist,
+	                                  procdirname,
+	                                  linux_platform->m_lasterr);
+}
+
+int32_t scap_linux_scan_proc_table(struct scap_linux_platform* linux_platform,
+                                   struct scap_proclist* proclist,
+                                   char* procdirname,
+                                   char* error) {
+	int32_t ret;
+
 	scap_cgroup_enable_cache(&linux_platform->m_cgroups);
-	int32_t ret = _scap_proc_scan_proc_dir_impl(linux_platform,
-	                                            proclist,
-	                                            procdirname,
-	                                            -1,
-	                                            linux_platform->m_lasterr);
+	if(linux_platform->m_proc_scan_num_threads > 1) {
+		ret = _scap_proc_scan_proc_dir_parallel(linux_platform, proclist, procdirname, error);
+	} else {
+		ret = _scap_proc_scan_proc_dir_impl(linux_platform, proclist, procdirname, -1, error);
+	}
 	scap_cgroup_clear_cache(&linux_platform->m_cgroups);
 	return ret;
 }
@@ -1323,3 +1700,13 @@ int32_t scap_linux_get_fdlist(struct scap_platform* platform,
 	}
 	return res;
 }
+
+int32_t scap_linux_get_fdinfo(struct scap_platform* platform,
+                              int64_t pid,
+                              struct scap_fdinfo* fdinfo,
+                              char* lasterr) {
+	char proc_dir[SCAP_MAX_PATH_SIZE];
+
+	snprintf(proc_dir, sizeof(proc_dir), "%s/proc/%" PRId64 "/", scap_get_host_root(), pid);
+	return scap_fd_read_fd(proc_dir, pid, fdinfo, lasterr);
+}
@@ -20,6 +20,7 @@ limitations under the License.
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <poll.h>
 
 #include <libscap/strl.h>
 #include <libscap/scap.h>
@@ -34,6 +35,16 @@ int32_t devset_init(struct scap_device_set *devset, size_t num_devs, char *laste
 		return SCAP_FAILURE;
 	}
 
+	devset->m_heap = (struct scap_device_heap_entry *)calloc(devset->m_ndevs,
+	                                                         sizeof(struct scap_device_heap_entry));
+	if(!devset->m_heap) {
+		free(devset->m_devs);
+		devset->m_devs = NULL;
+		strlcpy(lasterr, "error allocating the device merge heap", SCAP_LASTERR_SIZE);
+		return SCAP_FAILURE;
+	}
+	devset_invalidate_heap(devset);
+
 	for(size_t j = 0; j < num_devs; ++j) {
 		devset->m_devs[j].m_buffer = INVALID_MAPPING;
 		devset->m_devs[j].m_bufinfo = INVALID_MAPPING;
@@ -45,6 +56,7 @@ int32_t devset_init(struct scap_device_set *devset, size_t num_devs, char *laste
 	}
 	devset->m_buffer_empty_wait_time_us = BUFFER_EMPTY_WAIT_TIME_US_START;
 	devset->m_lasterr = lasterr;
+	devset->m_pollfds = NULL;
 
 	return SCAP_SUCCESS;
 }
@@ -67,4 +79,25 @@ void devset_free(struct scap_device_set *devset) {
 		devset_close_device(dev);
 	}
 	free(devset->m_devs);
+	free(devset->m_heap);
+	free(devset->m_pollfds);
+	devset->m_pollfds = NULL;
+}
+
+int32_t devset_enable_poll(struct scap_device_set *devset) {
+	struct pollfd *pollfds = (struct pollfd *)calloc(devset->m_ndevs, sizeof(struct pollfd));
+	if(!pollfds) {
+		strlcpy(devset->m_lasterr, "error allocating the device poll set", SCAP_LASTERR_SIZE);
+		return SCAP_FAILURE;
+	}
+
+	for(uint32_t j = 0; j < devset->m_ndevs; j++) {
+		ASSERT(devset->m_devs[j].m_fd != INVALID_FD);
+		pollfds[j].fd = devset->m_devs[j].m_fd;
+		pollfds[j].events = POLLIN;
+	}
+
+	free(devset->m_pollfds);
+	devset->m_pollfds = pollfds;
+	return SCAP_SUCCESS;
 }
@@ -18,6 +18,7 @@ limitations under the License.
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
@@ -36,6 +37,7 @@ limitations under the License.
 #define BUFFER_EMPTY_THRESHOLD_B 20000
 
 struct ppm_ring_buffer_info;
+struct pollfd;
 struct udig_ring_buffer_status;
 
 //
@@ -60,17 +62,48 @@ typedef struct scap_device {
 	};
 } scap_device;
 
+//
+// Entry of the min-heap used to merge the device blocks in timestamp order.
+// The timestamp of the next event is cached here so that comparisons don't
+// touch the ring buffer memory.
+//
+struct scap_device_heap_entry {
+	uint64_t m_ts;
+	uint32_t m_devid;
+};
+
 struct scap_device_set {
 	scap_device* m_devs;
 	uint32_t m_ndevs;
 	uint64_t m_buffer_empty_wait_time_us;
 	char* m_lasterr;
+	struct scap_device_heap_entry* m_heap;  // one slot per device with a non-empty block
+	uint32_t m_heap_size;
+	bool m_heap_valid;  // false until the heap is built from the blocks of the last refill
+	bool m_heap_root_served;  // the root device served the last event and must be re-keyed
+	struct pollfd* m_pollfds;  // one entry per device when blocking on the device fds, NULL
+	                           // when waiting for new data with the sleep backoff
 };
 
 int32_t devset_init(struct scap_device_set* devset, size_t num_devs, char* lasterr);
 void devset_close_device(struct scap_device* dev);
 void devset_free(struct scap_device_set* devset);
 
+/* Wait for new data by polling the `m_fd` of every device instead of sleeping with an
+ * exponential backoff. Only engines whose device fds signal `POLLIN` when new data is
+ * available can use it, the others keep the sleep backoff.
+ */
+int32_t devset_enable_poll(struct scap_device_set* devset);
+
+/* Force the next `ringbuffer_next` to rebuild the merge heap from scratch.
+ * Needs to be called every time the device blocks are modified outside of `ringbuffer_next`.
+ */
+static inline void devset_invalidate_heap(struct scap_device_set* devset) {
+	devset->m_heap_size = 0;
+	devset->m_heap_valid = false;
+	devset->m_heap_root_served = false;
+}
+
 static inline void devset_munmap(void* addr, size_t size) {
 	if(addr != INVALID_MAPPING) {
 		int ret = munmap(addr, size);
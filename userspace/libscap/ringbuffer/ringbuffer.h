@@ -18,6 +18,9 @@ limitations under the License.
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <poll.h>
 
 #include <libscap/ringbuffer/devset.h>
 #include <libscap/ringbuffer/ringbuffer_dump.h>
@@ -135,14 +138,38 @@ static inline bool are_buffers_empty(struct scap_device_set* devset) {
 	return true;
 }
 
+/* Block until one of the devices signals new data or `BUFFER_EMPTY_WAIT_TIME_US_MAX` expires.
+ * Returns false if the devices cannot be polled, in this case the poll set is dropped and the
+ * caller falls back to the sleep backoff.
+ */
+static inline bool wait_for_buffers(struct scap_device_set* devset) {
+	int ret = poll(devset->m_pollfds, devset->m_ndevs, BUFFER_EMPTY_WAIT_TIME_US_MAX / 1000);
+	bool failed = ret < 0 && errno != EINTR;
+	for(uint32_t j = 0; ret > 0 && j < devset->m_ndevs; j++) {
+		failed = failed || (devset->m_pollfds[j].revents & POLLNVAL);
+	}
+
+	if(failed) {
+		free(devset->m_pollfds);
+		devset->m_pollfds = NULL;
+		return false;
+	}
+	return true;
+}
+
 static inline int32_t refill_read_buffers(struct scap_device_set* devset) {
 	uint32_t j;
 	uint32_t ndevs = devset->m_ndevs;
 
 	if(are_buffers_empty(devset)) {
-		sleep_ms(devset->m_buffer_empty_wait_time_us / 1000);
-		devset->m_buffer_empty_wait_time_us =
-		        MIN(devset->m_buffer_empty_wait_time_us * 2, BUFFER_EMPTY_WAIT_TIME_US_MAX);
+		/* With a poll set the producers wake us up, otherwise we sleep with an exponential
+		 * backoff: the first time 500 us, with consecutive empty refills up to 30 ms.
+		 */
+		if(devset->m_pollfds == NULL || !wait_for_buffers(devset)) {
+			sleep_ms(devset->m_buffer_empty_wait_time_us / 1000);
+			devset->m_buffer_empty_wait_time_us = MIN(devset->m_buffer_empty_wait_time_us * 2,
+			                                          BUFFER_EMPTY_WAIT_TIME_US_MAX);
+		}
 	} else {
 		devset->m_buffer_empty_wait_time_us = BUFFER_EMPTY_WAIT_TIME_US_START;
 	}
@@ -178,6 +205,144 @@ static inline void ringbuffer_advance_to_evt(scap_device* dev, scap_evt* event)
 }
 #endif
 
+/* The heap is ordered by timestamp, ties are broken by device id so that we
+ * return the events in the same order of a linear scan over the devices.
+ */
+static inline bool ringbuffer_heap_less(const struct scap_device_heap_entry* a,
+                                        const struct scap_device_heap_entry* b) {
+	return a->m_ts < b->m_ts || (a->m_ts == b->m_ts && a->m_devid < b->m_devid);
+}
+
+static inline void ringbuffer_heap_sift_down(struct scap_device_set* devset, uint32_t pos) {
+	struct scap_device_heap_entry* heap = devset->m_heap;
+	uint32_t size = devset->m_heap_size;
+	struct scap_device_heap_entry entry = heap[pos];
+
+	while(true) {
+		uint32_t child = 2 * pos + 1;
+		if(child >= size) {
+			break;
+		}
+
+		if(child + 1 < size && ringbuffer_heap_less(&heap[child + 1], &heap[child])) {
+			child++;
+		}
+
+		if(!ringbuffer_heap_less(&heap[child], &entry)) {
+			break;
+		}
+
+		heap[pos] = heap[child];
+		pos = child;
+	}
+
+	heap[pos] = entry;
+}
+
+/* Read the timestamp of the next event in the device block, checking that the event
+ * fits in the remaining part of the block.
+ */
+static inline int32_t ringbuffer_heap_peek(struct scap_device_set* devset,
+                                           scap_device* dev,
+                                           uint64_t* ts) {
+	scap_evt* pe = NEXT_EVENT(dev);
+
+	/* if the event length is greater than the remaining size in our block there is
+	 * something wrong! */
+	if(pe->len > dev->m_sn_len) {
+		snprintf(devset->m_lasterr, SCAP_LASTERR_SIZE, "scap_next buffer corruption");
+		dump_ringbuffer(dev);
+
+		/* if you get the following assertion, first recompile the driver and `libscap` */
+		ASSERT(false);
+		return SCAP_FAILURE;
+	}
+
+	*ts = pe->ts;
+	return SCAP_SUCCESS;
+}
+
+/* Release a device whose block has been fully consumed.
+ *
+ * `dev->m_sn_len` and `dev->m_lastreadsize` initially contain the dimension
+ * of the full buffer block we have read in `refill_read_buffers`.
+ * The difference is that `dev->m_sn_len` is decreased at every new event
+ * that we read while `dev->m_lastreadsize` preserve the block dimension since
+ * it will be used to move the consumer position in `ADVANCE_TAIL`.
+ *
+ * If we don't have data from this ring, but we are still occupying, free the
+ * resources for the producer rather than sitting on them.
+ *
+ * Please note: this is the unique point in which we move the consumer position.
+ * We move the consumer position only when we have consumed all the block
+ * previously read in `refill_read_buffers`. This could be quite dangerous if we
+ * read huge blocks because we have to read the entire block before increasing
+ * the consumer!
+ *
+ * Note that even if we have consumed the entire block for this buffer we don't refill
+ * it immediately but we wait for all other buffers!
+ */
+static inline void ringbuffer_release_block(scap_device* dev) {
+	if(dev->m_lastreadsize > 0) {
+		ADVANCE_TAIL(dev);
+	}
+}
+
+/* Build the heap with all the devices that have a non-empty block. */
+static inline int32_t ringbuffer_heap_build(struct scap_device_set* devset) {
+	uint32_t j;
+	uint32_t ndevs = devset->m_ndevs;
+
+	devset->m_heap_size = 0;
+	devset->m_heap_root_served = false;
+
+	for(j = 0; j < ndevs; j++) {
+		scap_device* dev = &(devset->m_devs[j]);
+
+		if(dev->m_sn_len == 0) {
+			ringbuffer_release_block(dev);
+			continue;
+		}
+
+		struct scap_device_heap_entry* entry = &devset->m_heap[devset->m_heap_size];
+		if(ringbuffer_heap_peek(devset, dev, &entry->m_ts) != SCAP_SUCCESS) {
+			devset->m_heap_size = 0;
+			return SCAP_FAILURE;
+		}
+		entry->m_devid = j;
+		devset->m_heap_size++;
+	}
+
+	for(j = devset->m_heap_size / 2; j > 0; j--) {
+		ringbuffer_heap_sift_down(devset, j - 1);
+	}
+
+	devset->m_heap_valid = true;
+	return SCAP_SUCCESS;
+}
+
+/* Re-key the root of the heap after its device served an event: only the
+ * device that just advanced needs to be compared again.
+ */
+static inline int32_t ringbuffer_heap_update_root(struct scap_device_set* devset) {
+	scap_device* dev = &devset->m_devs[devset->m_heap[0].m_devid];
+
+	devset->m_heap_root_served = false;
+
+	if(dev->m_sn_len == 0) {
+		ringbuffer_release_block(dev);
+		devset->m_heap[0] = devset->m_heap[--devset->m_heap_size];
+	} else if(ringbuffer_heap_peek(devset, dev, &devset->m_heap[0].m_ts) != SCAP_SUCCESS) {
+		devset_invalidate_heap(devset);
+		return SCAP_FAILURE;
+	}
+
+	if(devset->m_heap_size > 1) {
+		ringbuffer_heap_sift_down(devset, 0);
+	}
+	return SCAP_SUCCESS;
+}
+
 /**
  * \brief Get next event in the ringbuffer
  *
@@ -189,6 +354,10 @@ static inline void ringbuffer_advance_to_evt(scap_device* dev, scap_evt* event)
  * that buffer, and wait for all the other buffer blocks to be read.
  * - When we have consumed all the blocks we are ready to read again a new block for every buffer
  *
+ * The blocks are merged through a min-heap keyed by the timestamp of their next event: the heap
+ * is built once per refill, then every call only re-compares the device that served the previous
+ * event, so the cost per event is O(log(ndevs)) instead of O(ndevs).
+ *
  * Possible pain points:
  * - if the buffers are not full enough we sleep and this could be dangerous in this situation!
  * - we increase the consumer position only when we have consumed the entire block, but if the block
@@ -205,87 +374,81 @@ static inline int32_t ringbuffer_next(struct scap_device_set* devset,
                                       scap_evt** pevent,
                                       uint16_t* pdevid,
                                       uint32_t* pflags) {
-	uint32_t j;
-	uint64_t min_ts = 0xffffffffffffffffLL;
-	scap_evt* pe = NULL;
-	uint32_t ndevs = devset->m_ndevs;
+	int32_t res = SCAP_SUCCESS;
 
 	*pdevid = 65535;
 
-	for(j = 0; j < ndevs; j++) {
-		scap_device* dev = &(devset->m_devs[j]);
-
-		/* `dev->m_sn_len` and `dev->m_lastreadsize` initially contain the dimension
-		 * of the full buffer block we have read in `refill_read_buffers`.
-		 * The difference is that `dev->m_sn_len` is decreased at every new event
-		 * that we read while `dev->m_lastreadsize` preserve the block dimension since
-		 * it will be used to move the consumer position in `ADVANCE_TAIL`.
-		 *
-		 * Note that even if we have consumed the entire block for this buffer we don't refill
-		 * it immediately but we wait for all other buffers!
-		 */
-		if(dev->m_sn_len == 0) {
-			/* If we don't have data from this ring, but we are
-			 * still occupying, free the resources for the
-			 * producer rather than sitting on them.
-			 *
-			 * Please note: this is the unique point in which
-			 * we move the consumer position. We move the consumer
-			 * position only when we have consumed all the block
-			 * previously read in `refill_read_buffers`.
-			 *
-			 * This could be quite dangerous if we read huge blocks
-			 * because we have to read the entire block before increasing
-			 * the consumer!
-			 *
-			 * `dev->m_lastreadsize` this contains the full length of the entire
-			 * block we have just consumed.
-			 */
-			if(dev->m_lastreadsize > 0) {
-				ADVANCE_TAIL(dev);
-			}
-
-			continue;
-		}
-
-		/* Get the next event from the block */
-		pe = NEXT_EVENT(dev);
-
-		/* Search the event with the lower timestamp */
-		if(pe->ts < min_ts) {
-			/* if the event length is greater than the remaining size in our block there is
-			 * something wrong! */
-			if(pe->len > dev->m_sn_len) {
-				snprintf(devset->m_lasterr, SCAP_LASTERR_SIZE, "scap_next buffer corruption");
-				dump_ringbuffer(dev);
-
-				/* if you get the following assertion, first recompile the driver and `libscap` */
-				ASSERT(false);
-				return SCAP_FAILURE;
-			}
-
-			*pevent = pe;
-			*pdevid = j;
-			min_ts = pe->ts;
-		}
+	/* The event returned by the previous call lives in the block of the root device:
+	 * we can move past it only now that the caller is done with it.
+	 */
+	if(!devset->m_heap_valid) {
+		res = ringbuffer_heap_build(devset);
+	} else if(devset->m_heap_root_served) {
+		res = ringbuffer_heap_update_root(devset);
 	}
 
-	if(*pdevid != 65535) {
-		/* Check from which buffer we have read and move the position inside
-		 * the block with `ADVANCE_TO_EVT`
-		 */
-		struct scap_device* dev = &devset->m_devs[*pdevid];
-		ADVANCE_TO_EVT(dev, (*pevent));
+	if(res != SCAP_SUCCESS) {
+		return res;
+	}
 
-		// we don't really store the flags in the ringbuffer anywhere
-		*pflags = 0;
-		return SCAP_SUCCESS;
-	} else {
+	if(devset->m_heap_size == 0) {
 		/* If there are enough new data read again one block for every buffer
 		 * otherwise sleep!
 		 */
+		devset_invalidate_heap(devset);
 		return refill_read_buffers(devset);
 	}
+
+	/* Move the position inside the block of the device with the lowest timestamp
+	 * with `ADVANCE_TO_EVT`
+	 */
+	struct scap_device* dev = &devset->m_devs[devset->m_heap[0].m_devid];
+	*pevent = NEXT_EVENT(dev);
+	*pdevid = (uint16_t)devset->m_heap[0].m_devid;
+	ADVANCE_TO_EVT(dev, (*pevent));
+	devset->m_heap_root_served = true;
+
+	// we don't really store the flags in the ringbuffer anywhere
+	*pflags = 0;
+	return SCAP_SUCCESS;
+}
+
+/* Return up to `max_events` events in timestamp order. All of them must stay
+ * valid until the next call, so the batch ends as soon as serving one more
+ * event would release a block: that is when the root device has run out of
+ * events in its current block, or when all blocks need a refill.
+ */
+static inline int32_t ringbuffer_next_batch(struct scap_device_set* devset,
+                                            scap_evt** pevents,
+                                            uint16_t* pdevids,
+                                            uint32_t* pflags,
+                                            uint32_t max_events,
+                                            uint32_t* nevents) {
+	*nevents = 0;
+
+	int32_t res = ringbuffer_next(devset, &pevents[0], &pdevids[0], &pflags[0]);
+	if(res != SCAP_SUCCESS) {
+		return res;
+	}
+	*nevents = 1;
+
+	while(*nevents < max_events) {
+		struct scap_device* dev = &devset->m_devs[devset->m_heap[0].m_devid];
+		if(dev->m_sn_len == 0) {
+			break;
+		}
+
+		/* Errors are sticky (e.g. a corrupted event): the next call reports them. */
+		if(ringbuffer_next(devset,
+		                   &pevents[*nevents],
+		                   &pdevids[*nevents],
+		                   &pflags[*nevents]) != SCAP_SUCCESS) {
+			break;
+		}
+		(*nevents)++;
+	}
+
+	return SCAP_SUCCESS;
 }
 
 static inline uint64_t ringbuffer_get_max_buf_used(struct scap_device_set* devset) {
@@ -224,6 +224,43 @@ int32_t scap_next(scap_t* handle, scap_evt** pevent, uint16_t* pdevid, uint32_t*
 	return res;
 }
 
+int32_t scap_next_batch(scap_t* handle,
+                        scap_evt** pevents,
+                        uint16_t* pdevids,
+                        uint32_t* pflags,
+                        uint32_t max_events,
+                        uint32_t* nevents) {
+	int32_t res = SCAP_FAILURE;
+	*nevents = 0;
+	if(!handle || !handle->m_vtable) {
+		return SCAP_FAILURE;
+	}
+
+	if(max_events == 0) {
+		return SCAP_SUCCESS;
+	}
+
+	if(handle->m_vtable->next_batch) {
+		res = handle->m_vtable->next_batch(handle->m_engine,
+		                                   pevents,
+		                                   pdevids,
+		                                   pflags,
+		                                   max_events,
+		                                   nevents);
+	} else {
+		res = handle->m_vtable->next(handle->m_engine, &pevents[0], &pdevids[0], &pflags[0]);
+		if(res == SCAP_SUCCESS) {
+			*nevents = 1;
+		}
+	}
+
+	if(res == SCAP_SUCCESS) {
+		handle->m_evtcnt += *nevents;
+	}
+
+	return res;
+}
+
 //
 // Return the number of dropped events for the given handle.
 //
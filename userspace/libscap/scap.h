@@ -564,6 +564,33 @@ uint64_t scap_max_buf_used(scap_t* handle);
 */
 int32_t scap_next(scap_t* handle, scap_evt** pevent, uint16_t* pcpuid, uint32_t* pflags);
 
+/*!
+  \brief Get up to max_events events from the given capture instance in a single call
+
+  \param handle Handle to the capture instance.
+  \param pevents [out] User-provided array of at least max_events entries that will be filled
+  with the addresses of the events.
+  \param pdevids [out] User-provided array of at least max_events entries that will be filled
+  with the IDs of the devices where the events were captured.
+  \param pflags [out] User-provided array of at least max_events entries that will be filled
+  with the flags of the events.
+  \param max_events The maximum number of events to return.
+  \param nevents [out] The number of events actually returned.
+
+  \return The same values as \ref scap_next. On SCAP_SUCCESS at least one event is returned
+  (unless max_events is 0); an error that occurs after the first event ends the batch and is
+  reported by the following call.
+
+  \note All the returned events stay valid until the next call to \ref scap_next or
+  scap_next_batch. Engines that don't support batching return one event per call.
+*/
+int32_t scap_next_batch(scap_t* handle,
+                        scap_evt** pevents,
+                        uint16_t* pdevids,
+                        uint32_t* pflags,
+                        uint32_t max_events,
+                        uint32_t* nevents);
+
 /*!
   \brief Get the length of an event
 
@@ -46,6 +46,9 @@ typedef struct scap_open_args {
 	uint64_t proc_scan_timeout_ms;  //< Timeout in msec, after which so-far-successful scan of /proc
 	                                // should be cut short with success return
 	uint64_t proc_scan_log_interval_ms;  //< Interval for logging progress messages from /proc scan
+	uint32_t proc_scan_num_threads;  //< Number of threads scanning /proc, 0 or 1 for a serial scan
+	bool proc_scan_lazy_fds;  //< Only record the number and inode type of the fds found in /proc,
+	                          // the details are read on demand with scap_get_fdinfo()
 	void* engine_params;                 ///< engine-specific params.
 } scap_open_args;
 
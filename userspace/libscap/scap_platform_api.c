@@ -149,3 +149,15 @@ int32_t scap_get_fdlist(struct scap_platform* platform,
 	snprintf(error, SCAP_LASTERR_SIZE, "operation not supported");
 	return SCAP_FAILURE;
 }
+
+int32_t scap_get_fdinfo(struct scap_platform* platform,
+                        int64_t pid,
+                        struct scap_fdinfo* fdinfo,
+                        char* error) {
+	if(platform && platform->m_vtable->get_fdinfo) {
+		return platform->m_vtable->get_fdinfo(platform, pid, fdinfo, error);
+	}
+
+	snprintf(error, SCAP_LASTERR_SIZE, "operation not supported");
+	return SCAP_FAILURE;
+}
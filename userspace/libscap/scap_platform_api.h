@@ -34,6 +34,7 @@ struct scap_addrlist;
 struct _scap_machine_info;
 struct scap_platform;
 struct scap_threadinfo;
+struct scap_fdinfo;
 typedef struct _scap_agent_info scap_agent_info;
 
 /*!
@@ -113,6 +114,17 @@ struct ppm_proclist_info* scap_get_threadlist(struct scap_platform* platform, ch
 */
 int32_t scap_get_fdlist(struct scap_platform* platform, struct scap_threadinfo* tinfo, char* error);
 
+/*!
+  \brief Get the details of a single file descriptor (fdinfo->fd) of a given pid,
+  e.g. of an fd found by a /proc scan with `proc_scan_lazy_fds`.
+
+  \return SCAP_SUCCESS, SCAP_NOTFOUND if the fd is gone or SCAP_FAILURE.
+*/
+int32_t scap_get_fdinfo(struct scap_platform* platform,
+                        int64_t pid,
+                        struct scap_fdinfo* fdinfo,
+                        char* error);
+
 #ifdef __cplusplus
 };
 #endif
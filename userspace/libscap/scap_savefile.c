@@ -36,6 +36,13 @@ struct iovec {
 #include <libscap/scap_savefile.h>
 #include <libscap/strl.h>
 
+#if defined(USE_ZLIB) && !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define SCAP_DUMP_PIPELINE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#endif
+
 const char *scap_dump_getlasterr(scap_dumper_t *d) {
 	return d ? d->m_lasterr : "null dumper";
 }
@@ -46,11 +53,325 @@ const char *scap_dump_getlasterr(scap_dumper_t *d) {
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef SCAP_DUMP_PIPELINE
+
+//
+// Parallel compressed writer. The data of the dump is copied into chunks that
+// a pool of workers compresses into independent gzip members, whose
+// concatenation is a valid gzip file. The worker that completes the next chunk
+// in file order writes it, and the ones after it that are ready, so that the
+// file grows with large sequential writes. The producer only blocks when all
+// the chunks are in flight.
+//
+
+struct dump_chunk {
+	uint8_t *m_buf;  // uncompressed data, DUMP_CHUNK_SIZE bytes
+	size_t m_len;
+	uint8_t *m_out;  // compressed gzip member
+	size_t m_out_size;
+	size_t m_out_len;
+	uint64_t m_seq;  // position of the chunk in the file
+	struct dump_chunk *m_next;
+};
+
+struct scap_dump_pipeline {
+	int m_fd;
+	struct dump_chunk *m_chunks;
+	uint32_t m_nchunks;
+	pthread_t *m_threads;
+	uint32_t m_nthreads;
+
+	// Owned by the producer
+	struct dump_chunk *m_cur;  // chunk being filled
+	uint64_t m_offset;         // uncompressed bytes written so far
+
+	// Protected by the lock
+	pthread_mutex_t m_lock;
+	pthread_cond_t m_job_ready;
+	pthread_cond_t m_chunk_written;
+	struct dump_chunk *m_free;
+	struct dump_chunk *m_jobs_head;
+	struct dump_chunk *m_jobs_tail;
+	struct dump_chunk **m_done;  // compressed chunks waiting to be written, by m_seq % m_nchunks
+	uint64_t m_next_seq;         // sequence number of the next chunk queued
+	uint64_t m_next_write;       // sequence number of the next chunk written
+	uint64_t m_written;          // compressed bytes written to the file
+	bool m_writing;
+	bool m_stop;
+	int m_errno;  // first error hit by the workers
+};
+
+#define DUMP_CHUNK_SIZE (1 << 20)
+
+static int compress_chunk(z_stream *zs, struct dump_chunk *chunk) {
+	size_t bound;
+
+	if(deflateReset(zs) != Z_OK) {
+		return EINVAL;
+	}
+
+	bound = deflateBound(zs, chunk->m_len);
+	if(bound > chunk->m_out_size) {
+		uint8_t *tmp = (uint8_t *)realloc(chunk->m_out, bound);
+		if(tmp == NULL) {
+			return ENOMEM;
+		}
+		chunk->m_out = tmp;
+		chunk->m_out_size = bound;
+	}
+
+	zs->next_in = chunk->m_buf;
+	zs->avail_in = chunk->m_len;
+	zs->next_out = chunk->m_out;
+	zs->avail_out = chunk->m_out_size;
+	if(deflate(zs, Z_FINISH) != Z_STREAM_END) {
+		return EINVAL;
+	}
+	chunk->m_out_len = chunk->m_out_size - zs->avail_out;
+	return 0;
+}
+
+static int write_all(int fd, const uint8_t *buf, size_t len) {
+	while(len > 0) {
+		ssize_t res = write(fd, buf, len);
+		if(res < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return errno;
+		}
+		buf += res;
+		len -= res;
+	}
+	return 0;
+}
+
+static void *dump_worker(void *arg) {
+	struct scap_dump_pipeline *p = arg;
+	z_stream zs = {0};
+	// windowBits + 16 writes a gzip header and trailer around the deflate stream
+	bool zs_ok = deflateInit2(&zs,
+	                          Z_DEFAULT_COMPRESSION,
+	                          Z_DEFLATED,
+	                          MAX_WBITS + 16,
+	                          8,
+	                          Z_DEFAULT_STRATEGY) == Z_OK;
+
+	pthread_mutex_lock(&p->m_lock);
+	while(true) {
+		while(!p->m_stop && p->m_jobs_head == NULL) {
+			pthread_cond_wait(&p->m_job_ready, &p->m_lock);
+		}
+
+		if(p->m_jobs_head == NULL) {
+			break;
+		}
+
+		struct dump_chunk *chunk = p->m_jobs_head;
+		p->m_jobs_head = chunk->m_next;
+		if(p->m_jobs_head == NULL) {
+			p->m_jobs_tail = NULL;
+		}
+		pthread_mutex_unlock(&p->m_lock);
+
+		int err = zs_ok ? compress_chunk(&zs, chunk) : ENOMEM;
+
+		pthread_mutex_lock(&p->m_lock);
+		if(err != 0 && p->m_errno == 0) {
+			p->m_errno = err;
+		}
+		p->m_done[chunk->m_seq % p->m_nchunks] = chunk;
+
+		while(!p->m_writing && p->m_done[p->m_next_write % p->m_nchunks] != NULL) {
+			struct dump_chunk *next = p->m_done[p->m_next_write % p->m_nchunks];
+			p->m_done[p->m_next_write % p->m_nchunks] = NULL;
+			p->m_writing = true;
+			pthread_mutex_unlock(&p->m_lock);
+
+			err = p->m_errno == 0 ? write_all(p->m_fd, next->m_out, next->m_out_len) : 0;
+
+			pthread_mutex_lock(&p->m_lock);
+			if(err != 0 && p->m_errno == 0) {
+				p->m_errno = err;
+			}
+			p->m_writing = false;
+			p->m_written += next->m_out_len;
+			p->m_next_write++;
+			next->m_next = p->m_free;
+			p->m_free = next;
+			pthread_cond_broadcast(&p->m_chunk_written);
+		}
+	}
+	pthread_mutex_unlock(&p->m_lock);
+
+	if(zs_ok) {
+		deflateEnd(&zs);
+	}
+	return NULL;
+}
+
+static void pipeline_submit(struct scap_dump_pipeline *p) {
+	struct dump_chunk *chunk = p->m_cur;
+	p->m_cur = NULL;
+
+	pthread_mutex_lock(&p->m_lock);
+	chunk->m_seq = p->m_next_seq++;
+	chunk->m_next = NULL;
+	if(p->m_jobs_tail) {
+		p->m_jobs_tail->m_next = chunk;
+	} else {
+		p->m_jobs_head = chunk;
+	}
+	p->m_jobs_tail = chunk;
+	pthread_cond_signal(&p->m_job_ready);
+	pthread_mutex_unlock(&p->m_lock);
+}
+
+static int pipeline_write(struct scap_dump_pipeline *p, const void *buf, unsigned len) {
+	const uint8_t *src = buf;
+	unsigned left = len;
+
+	while(left > 0) {
+		if(p->m_cur == NULL) {
+			pthread_mutex_lock(&p->m_lock);
+			while(p->m_free == NULL && p->m_errno == 0) {
+				pthread_cond_wait(&p->m_chunk_written, &p->m_lock);
+			}
+			if(p->m_errno != 0) {
+				pthread_mutex_unlock(&p->m_lock);
+				return -1;
+			}
+			p->m_cur = p->m_free;
+			p->m_free = p->m_cur->m_next;
+			pthread_mutex_unlock(&p->m_lock);
+			p->m_cur->m_len = 0;
+		}
+
+		size_t n = DUMP_CHUNK_SIZE - p->m_cur->m_len;
+		n = n < left ? n : left;
+		memcpy(p->m_cur->m_buf + p->m_cur->m_len, src, n);
+		p->m_cur->m_len += n;
+		src += n;
+		left -= n;
+
+		if(p->m_cur->m_len == DUMP_CHUNK_SIZE) {
+			pipeline_submit(p);
+		}
+	}
+
+	p->m_offset += len;
+	return len;
+}
+
+//
+// Write everything that was written so far to the file. Returns the first
+// error hit by the workers, if any
+//
+static int pipeline_drain(struct scap_dump_pipeline *p) {
+	int err;
+
+	if(p->m_cur != NULL && p->m_cur->m_len > 0) {
+		pipeline_submit(p);
+	}
+
+	pthread_mutex_lock(&p->m_lock);
+	while(p->m_next_write != p->m_next_seq) {
+		pthread_cond_wait(&p->m_chunk_written, &p->m_lock);
+	}
+	err = p->m_errno;
+	pthread_mutex_unlock(&p->m_lock);
+	return err;
+}
+
+static int pipeline_close(struct scap_dump_pipeline *p) {
+	int err = pipeline_drain(p);
+
+	pthread_mutex_lock(&p->m_lock);
+	p->m_stop = true;
+	pthread_cond_broadcast(&p->m_job_ready);
+	pthread_mutex_unlock(&p->m_lock);
+	for(uint32_t i = 0; i < p->m_nthreads; i++) {
+		pthread_join(p->m_threads[i], NULL);
+	}
+
+	if(p->m_fd >= 0 && close(p->m_fd) != 0 && err == 0) {
+		err = errno;
+	}
+
+	for(uint32_t i = 0; p->m_chunks != NULL && i < p->m_nchunks; i++) {
+		free(p->m_chunks[i].m_buf);
+		free(p->m_chunks[i].m_out);
+	}
+	pthread_mutex_destroy(&p->m_lock);
+	pthread_cond_destroy(&p->m_job_ready);
+	pthread_cond_destroy(&p->m_chunk_written);
+	free(p->m_chunks);
+	free(p->m_done);
+	free(p->m_threads);
+	free(p);
+	return err;
+}
+
+// Takes ownership of fd
+static struct scap_dump_pipeline *pipeline_open(int fd, uint32_t num_workers, char *lasterr) {
+	struct scap_dump_pipeline *p = calloc(1, sizeof(*p));
+	if(p == NULL) {
+		snprintf(lasterr, SCAP_LASTERR_SIZE, "error allocating the dump pipeline");
+		close(fd);
+		return NULL;
+	}
+
+	p->m_fd = fd;
+	pthread_mutex_init(&p->m_lock, NULL);
+	pthread_cond_init(&p->m_job_ready, NULL);
+	pthread_cond_init(&p->m_chunk_written, NULL);
+
+	// Enough chunks to keep all the workers busy while the producer fills more
+	p->m_nchunks = 2 * num_workers + 2;
+	p->m_chunks = calloc(p->m_nchunks, sizeof(struct dump_chunk));
+	p->m_done = calloc(p->m_nchunks, sizeof(struct dump_chunk *));
+	p->m_threads = calloc(num_workers, sizeof(pthread_t));
+	if(p->m_chunks == NULL || p->m_done == NULL || p->m_threads == NULL) {
+		snprintf(lasterr, SCAP_LASTERR_SIZE, "error allocating the dump pipeline");
+		pipeline_close(p);
+		return NULL;
+	}
+
+	for(uint32_t i = 0; i < p->m_nchunks; i++) {
+		p->m_chunks[i].m_buf = malloc(DUMP_CHUNK_SIZE);
+		if(p->m_chunks[i].m_buf == NULL) {
+			snprintf(lasterr, SCAP_LASTERR_SIZE, "error allocating the dump pipeline");
+			pipeline_close(p);
+			return NULL;
+		}
+		p->m_chunks[i].m_next = p->m_free;
+		p->m_free = &p->m_chunks[i];
+	}
+
+	for(uint32_t i = 0; i < num_workers; i++) {
+		if(pthread_create(&p->m_threads[i], NULL, dump_worker, p) != 0) {
+			snprintf(lasterr, SCAP_LASTERR_SIZE, "can't start the dump threads");
+			pipeline_close(p);
+			return NULL;
+		}
+		p->m_nthreads++;
+	}
+
+	return p;
+}
+
+#endif  // SCAP_DUMP_PIPELINE
+
 //
 // Write data into a dump file
 //
 static int scap_dump_write(scap_dumper_t *d, void *buf, unsigned len) {
 	if(d->m_type == DT_FILE) {
+#ifdef SCAP_DUMP_PIPELINE
+		if(d->m_pipeline != NULL) {
+			return pipeline_write(d->m_pipeline, buf, len);
+		}
+#endif
 		return gzwrite(d->m_f, buf, len);
 	} else {
 		if(d->m_targetbufcurpos + len >= d->m_targetbufend) {
@@ -1052,6 +1373,10 @@ static scap_dumper_t *scap_dump_open_gzfile(struct scap_platform *platform,
 	res->m_targetbuf = NULL;
 	res->m_targetbufcurpos = NULL;
 	res->m_targetbufend = NULL;
+	res->m_nevts = 0;
+	res->m_index = NULL;
+	res->m_index_interval = 0;
+	res->m_pipeline = NULL;
 
 	if(scap_setup_dump(res, platform, fname) != SCAP_SUCCESS) {
 		strlcpy(lasterr, res->m_lasterr, SCAP_LASTERR_SIZE);
@@ -1144,6 +1469,67 @@ scap_dumper_t *scap_dump_open_fd(struct scap_platform *platform,
 	return scap_dump_open_gzfile(platform, f, "", lasterr);
 }
 
+//
+// Open a "savefile" for writing, compressed by a pool of threads
+//
+scap_dumper_t *scap_dump_open_parallel(struct scap_platform *platform,
+                                       const char *fname,
+                                       uint32_t num_workers,
+                                       char *lasterr) {
+#ifdef SCAP_DUMP_PIPELINE
+	if(num_workers == 0) {
+		snprintf(lasterr, SCAP_LASTERR_SIZE, "the dump needs at least one compression thread");
+		return NULL;
+	}
+
+	int fd;
+	if(fname[0] == '-' && fname[1] == '\0') {
+		fd = dup(STDOUT_FILENO);
+		fname = "standard output";
+	} else {
+		fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	}
+
+	if(fd < 0) {
+		snprintf(lasterr, SCAP_LASTERR_SIZE, "can't open %s", fname);
+		return NULL;
+	}
+
+	scap_dumper_t *res = (scap_dumper_t *)malloc(sizeof(scap_dumper_t));
+	if(res == NULL) {
+		snprintf(lasterr, SCAP_LASTERR_SIZE, "scap_dump_open_parallel memory allocation failure");
+		close(fd);
+		return NULL;
+	}
+
+	res->m_f = NULL;
+	res->m_type = DT_FILE;
+	res->m_targetbuf = NULL;
+	res->m_targetbufcurpos = NULL;
+	res->m_targetbufend = NULL;
+	res->m_nevts = 0;
+	res->m_index = NULL;
+	res->m_index_interval = 0;
+	res->m_pipeline = pipeline_open(fd, num_workers, lasterr);
+	if(res->m_pipeline == NULL) {
+		free(res);
+		return NULL;
+	}
+
+	if(scap_setup_dump(res, platform, fname) != SCAP_SUCCESS) {
+		strlcpy(lasterr, res->m_lasterr, SCAP_LASTERR_SIZE);
+		pipeline_close(res->m_pipeline);
+		free(res);
+		return NULL;
+	}
+
+	return res;
+#else
+	snprintf(lasterr, SCAP_LASTERR_SIZE, "parallel compression is not supported");
+	return NULL;
+#endif
+}
+
 //
 // Open a memory "savefile"
 //
@@ -1162,6 +1548,10 @@ scap_dumper_t *scap_memory_dump_open(struct scap_platform *platform,
 	res->m_targetbuf = targetbuf;
 	res->m_targetbufcurpos = targetbuf;
 	res->m_targetbufend = targetbuf + targetbufsize;
+	res->m_nevts = 0;
+	res->m_index = NULL;
+	res->m_index_interval = 0;
+	res->m_pipeline = NULL;
 
 	if(scap_setup_dump(res, platform, "") != SCAP_SUCCESS) {
 		strlcpy(lasterr, res->m_lasterr, SCAP_LASTERR_SIZE);
@@ -1186,14 +1576,71 @@ scap_dumper_t *scap_managedbuf_dump_create() {
 	res->m_targetbuf = (uint8_t *)malloc(PPM_DUMPER_MANAGED_BUF_SIZE);
 	res->m_targetbufcurpos = res->m_targetbuf;
 	res->m_targetbufend = res->m_targetbuf + PPM_DUMPER_MANAGED_BUF_SIZE;
+	res->m_nevts = 0;
+	res->m_index = NULL;
+	res->m_index_interval = 0;
+	res->m_pipeline = NULL;
 
 	return res;
 }
 
+//
+// Open the index file of a "savefile" opened with scap_dump_open
+//
+int32_t scap_dump_open_index(scap_dumper_t *d, const char *fname, uint32_t interval) {
+	block_header bh;
+	section_header_block sh;
+	uint32_t bt;
+
+	if(d->m_type != DT_FILE || d->m_index != NULL || interval == 0) {
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "can't write an index for this dumper");
+		return SCAP_FAILURE;
+	}
+
+	FILE *f = fopen(fname, "wb");
+	if(f == NULL) {
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "can't open %s", fname);
+		return SCAP_FAILURE;
+	}
+
+	bh.block_type = SHB_BLOCK_TYPE;
+	bh.block_total_length = sizeof(block_header) + sizeof(section_header_block) + 4;
+
+	sh.byte_order_magic = SHB_MAGIC;
+	sh.major_version = CURRENT_MAJOR_VERSION;
+	sh.minor_version = CURRENT_MINOR_VERSION;
+	sh.section_length = 0xffffffffffffffffLL;
+
+	bt = bh.block_total_length;
+
+	if(fwrite(&bh, sizeof(bh), 1, f) != 1 || fwrite(&sh, sizeof(sh), 1, f) != 1 ||
+	   fwrite(&bt, sizeof(bt), 1, f) != 1) {
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error writing to file %s", fname);
+		fclose(f);
+		return SCAP_FAILURE;
+	}
+
+	d->m_index = f;
+	d->m_index_interval = interval;
+	return SCAP_SUCCESS;
+}
+
 //
 // Close a "savefile" opened with scap_dump_open
 //
 void scap_dump_close(scap_dumper_t *d) {
+	if(d->m_index != NULL) {
+		fclose(d->m_index);
+	}
+
+#ifdef SCAP_DUMP_PIPELINE
+	if(d->m_pipeline != NULL) {
+		pipeline_close(d->m_pipeline);
+		free(d);
+		return;
+	}
+#endif
+
 	if(d->m_type == DT_FILE) {
 		gzclose(d->m_f);
 	} else if(d->m_type == DT_MANAGED_BUF) {
@@ -1207,6 +1654,16 @@ void scap_dump_close(scap_dumper_t *d) {
 // Return the current size of a tracefile
 //
 int64_t scap_dump_get_offset(scap_dumper_t *d) {
+#ifdef SCAP_DUMP_PIPELINE
+	if(d->m_pipeline != NULL) {
+		// What has been compressed and written so far
+		pthread_mutex_lock(&d->m_pipeline->m_lock);
+		int64_t written = d->m_pipeline->m_written;
+		pthread_mutex_unlock(&d->m_pipeline->m_lock);
+		return written;
+	}
+#endif
+
 	if(d->m_type == DT_FILE) {
 		return gzoffset(d->m_f);
 	} else {
@@ -1215,6 +1672,12 @@ int64_t scap_dump_get_offset(scap_dumper_t *d) {
 }
 
 int64_t scap_dump_ftell(scap_dumper_t *d) {
+#ifdef SCAP_DUMP_PIPELINE
+	if(d->m_pipeline != NULL) {
+		return d->m_pipeline->m_offset;
+	}
+#endif
+
 	if(d->m_type == DT_FILE) {
 		return gztell(d->m_f);
 	} else {
@@ -1223,11 +1686,50 @@ int64_t scap_dump_ftell(scap_dumper_t *d) {
 }
 
 void scap_dump_flush(scap_dumper_t *d) {
+	if(d->m_index != NULL) {
+		fflush(d->m_index);
+	}
+
+#ifdef SCAP_DUMP_PIPELINE
+	if(d->m_pipeline != NULL) {
+		pipeline_drain(d->m_pipeline);
+		return;
+	}
+#endif
+
 	if(d->m_type == DT_FILE) {
 		gzflush(d->m_f, Z_FULL_FLUSH);
 	}
 }
 
+//
+// Add the event that is about to be written to the index
+//
+static int32_t scap_dump_checkpoint(scap_dumper_t *d, scap_evt *e) {
+	block_header bh;
+	index_entry entry;
+	uint32_t bt;
+
+	bh.block_type = IDX_BLOCK_TYPE;
+	bh.block_total_length = sizeof(block_header) + sizeof(index_entry) + 4;
+
+	entry.offset = scap_dump_ftell(d);
+	entry.ts = e->ts;
+	entry.evt_num = d->m_nevts;
+	entry.section_offset = 0;  // the dumper writes a single section
+
+	bt = bh.block_total_length;
+
+	if(fwrite(&bh, sizeof(bh), 1, d->m_index) != 1 ||
+	   fwrite(&entry, sizeof(entry), 1, d->m_index) != 1 ||
+	   fwrite(&bt, sizeof(bt), 1, d->m_index) != 1) {
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error writing to the index file");
+		return SCAP_FAILURE;
+	}
+
+	return SCAP_SUCCESS;
+}
+
 //
 // Write an event to a dump file
 //
@@ -1237,6 +1739,13 @@ int32_t scap_dump(scap_dumper_t *d, scap_evt *e, uint16_t cpuid, uint32_t flags)
 	bool large_payload = flags & SCAP_DF_LARGE;
 
 	flags &= ~SCAP_DF_LARGE;
+
+	if(d->m_index != NULL && d->m_nevts % d->m_index_interval == 0) {
+		if(scap_dump_checkpoint(d, e) != SCAP_SUCCESS) {
+			return SCAP_FAILURE;
+		}
+	}
+
 	if(flags == 0) {
 		//
 		// Write the section header
@@ -1281,5 +1790,6 @@ int32_t scap_dump(scap_dumper_t *d, scap_evt *e, uint16_t cpuid, uint32_t flags)
 	fflush(f);
 #endif
 
+	d->m_nevts++;
 	return SCAP_SUCCESS;
 }
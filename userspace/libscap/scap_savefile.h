@@ -160,4 +160,20 @@ typedef struct _section_header_block {
 
 #define EVF_BLOCK_TYPE_V2_LARGE 0x222
 
+///////////////////////////////////////////////////////////////////////////////
+// INDEX BLOCK
+///////////////////////////////////////////////////////////////////////////////
+// Index files are written next to a capture: a section header block followed
+// by index blocks, each one holding a checkpoint of the capture. Checkpoints are
+// appended in the order of the events, so they are sorted by offset, event
+// number and, as long as the capture is, by timestamp.
+#define IDX_BLOCK_TYPE 0x223
+
+typedef struct _index_entry {
+	uint64_t offset;          // position of the event block in the uncompressed capture
+	uint64_t ts;              // timestamp of the event
+	uint64_t evt_num;         // number of event blocks that precede it in the capture
+	uint64_t section_offset;  // position of the section whose tables describe the state
+} index_entry;
+
 #pragma pack(pop)
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include <libscap/scap_const.h>
 #include <libscap/scap_zlib.h>
@@ -29,6 +30,7 @@ extern "C" {
 #endif
 
 struct scap_platform;
+struct scap_dump_pipeline;
 
 typedef enum ppm_dumper_type {
 	DT_FILE = 0,
@@ -46,6 +48,11 @@ typedef struct scap_dumper {
 	uint8_t *m_targetbufcurpos;
 	uint8_t *m_targetbufend;
 	char m_lasterr[SCAP_LASTERR_SIZE];
+	uint64_t m_nevts;           // events written so far
+	FILE *m_index;              // index file, if any
+	uint32_t m_index_interval;  // events between two checkpoints of the index
+	// Set when the file is compressed by a pool of threads
+	struct scap_dump_pipeline *m_pipeline;
 } scap_dumper_t;
 
 struct scap_threadinfo;
@@ -115,6 +122,44 @@ scap_dumper_t *scap_dump_open_fd(struct scap_platform *platform,
                                  bool skip_proc_scan,
                                  char *lasterr);
 
+/*!
+  \brief Open a trace file for writing, compressed by a pool of threads
+
+  The events are copied into chunks that are compressed in the background into
+  independent gzip members, which make a valid gzip file once concatenated, and
+  written with large sequential writes. scap_dump() only blocks when all the
+  chunks are waiting to be compressed or written.
+
+  \param platform The platform whose tables are written in the file.
+  \param fname The name of the trace file.
+  \param num_workers The number of compression threads.
+
+  \return Dump handle that can be used to identify this specific dump instance.
+*/
+scap_dumper_t *scap_dump_open_parallel(struct scap_platform *platform,
+                                       const char *fname,
+                                       uint32_t num_workers,
+                                       char *lasterr);
+
+/*!
+  \brief Write an index of a trace file to a separate file, while the events are dumped.
+
+  The index records a checkpoint every interval events, with the position, the
+  timestamp and the number of the event, that allows to start reading the trace
+  file from a timestamp or an event number without reading it from the start.
+  Should be called right after opening the dumper, so that the first event is a
+  checkpoint.
+
+  \param d The dump handle, returned by \ref scap_dump_open
+  \param fname The name of the index file.
+  \param interval The number of events between two checkpoints.
+
+  \return SCAP_SUCCESS if the call is successful.
+   On Failure, SCAP_FAILURE is returned and scap_dump_getlasterr() can be used to obtain
+   the cause of the error.
+*/
+int32_t scap_dump_open_index(scap_dumper_t *d, const char *fname, uint32_t interval);
+
 /*!
   \brief Close a trace file.
 
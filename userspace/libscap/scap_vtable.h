@@ -266,6 +266,34 @@ struct scap_vtable {
 	 * @return the schema version
 	 */
 	uint64_t (*get_schema_version)(struct scap_engine_handle engine);
+
+	/**
+	 * @brief fetch up to max_events events in one call (optional)
+	 * @param engine wraps the pointer to the engine-specific handle
+	 * @param pevents [out] array of at least max_events entries where the
+	 *                event pointers get stored
+	 * @param pdevids [out] array of at least max_events entries where the
+	 *                device IDs get stored
+	 * @param pflags [out] array of at least max_events entries where the
+	 *               event flags get stored
+	 * @param max_events the maximum number of events to return
+	 * @param nevents [out] the number of events actually returned
+	 * @return SCAP_SUCCESS or a failure code, same as next()
+	 *
+	 * On SCAP_SUCCESS at least one event is returned. An error hit after
+	 * the first event ends the batch early and is reported by the
+	 * following call instead.
+	 *
+	 * All the returned events must remain valid at least until the next
+	 * call to next() or next_batch(). Engines that can't provide this
+	 * leave the pointer NULL and scap_next_batch() falls back to next().
+	 */
+	int32_t (*next_batch)(struct scap_engine_handle engine,
+	                      scap_evt** pevents,
+	                      uint16_t* pdevids,
+	                      uint32_t* pflags,
+	                      uint32_t max_events,
+	                      uint32_t* nevents);
 };
 
 #ifdef __cplusplus
@@ -27,26 +27,31 @@ void sinsp_dns_resolver::refresh(uint64_t erase_timeout,
 	while(true) {
 		if(!manager.m_cache.empty()) {
 			std::list<std::string> to_delete;
+			bool changed = false;
 
 			uint64_t ts = sinsp_utils::get_current_time_ns();
 
 			for(auto &it : manager.m_cache) {
 				const std::string &name = it.first;
 				sinsp_dns_manager::dns_info &info = it.second;
+				uint64_t last_used_ts = info.m_name->m_last_used_ts.load(std::memory_order_relaxed);
 
-				if((ts > info.m_last_used_ts) && (ts - info.m_last_used_ts) > erase_timeout) {
+				if((ts > last_used_ts) && (ts - last_used_ts) > erase_timeout) {
 					// remove the entry if it's hasn't been used for a whole hour
 					to_delete.push_back(name);
 				} else if(ts > (info.m_last_resolve_ts + info.m_timeout)) {
 					sinsp_dns_manager::dns_info refreshed_info = manager.resolve(name, ts);
-					refreshed_info.m_timeout = base_refresh_timeout;
-					refreshed_info.m_last_resolve_ts = info.m_last_resolve_ts = ts;
+					info.m_last_resolve_ts = ts;
 
 					// dns_info::operator!= will check if some
 					// v4 or v6 addresses are changed from the
 					// last resolution
 					if(refreshed_info != info) {
-						info = refreshed_info;
+						std::lock_guard<std::mutex> lock(manager.m_erase_mutex);
+						info.m_v4_addrs = std::move(refreshed_info.m_v4_addrs);
+						info.m_v6_addrs = std::move(refreshed_info.m_v6_addrs);
+						info.m_timeout = base_refresh_timeout;
+						changed = true;
 					} else if(info.m_timeout < max_refresh_timeout) {
 						// double the timeout until 320 secs
 						info.m_timeout <<= 1;
@@ -59,6 +64,11 @@ void sinsp_dns_resolver::refresh(uint64_t erase_timeout,
 					manager.m_cache.unsafe_erase(name);
 				}
 				manager.m_erase_mutex.unlock();
+				changed = true;
+			}
+			if(changed) {
+				manager.m_index_dirty = true;
+				manager.refresh_index();
 			}
 		}
 
@@ -97,6 +107,34 @@ inline sinsp_dns_manager::dns_info sinsp_dns_manager::resolve(const std::string
 	}
 	return dinfo;
 }
+
+void sinsp_dns_manager::refresh_index() {
+	std::lock_guard<std::mutex> lock(m_erase_mutex);
+	if(!m_index_dirty.exchange(false)) {
+		return;
+	}
+
+	// when an address belongs to more than one name, the lowest one wins so
+	// that the result does not depend on the order of the cache
+	auto index = std::make_shared<reverse_index>();
+	for(auto &it : m_cache) {
+		const dns_info &info = it.second;
+		for(uint32_t addr : info.m_v4_addrs) {
+			auto &entry = index->m_v4[addr];
+			if(!entry || info.m_name->m_name < entry->m_name) {
+				entry = info.m_name;
+			}
+		}
+		for(const ipv6addr &addr : info.m_v6_addrs) {
+			auto &entry = index->m_v6[addr];
+			if(!entry || info.m_name->m_name < entry->m_name) {
+				entry = info.m_name;
+			}
+		}
+	}
+
+	std::atomic_store(&m_index, std::shared_ptr<const reverse_index>(std::move(index)));
+}
 #endif
 
 bool sinsp_dns_manager::match(const char *name, int af, void *addr, uint64_t ts) {
@@ -113,15 +151,20 @@ bool sinsp_dns_manager::match(const char *name, int af, void *addr, uint64_t ts)
 
 	m_erase_mutex.lock();
 
-	if(m_cache.find(sname) == m_cache.end()) {
+	auto it = m_cache.find(sname);
+	if(it == m_cache.end()) {
 		dns_info dinfo = resolve(sname, ts);
 		dinfo.m_timeout = m_base_refresh_timeout;
 		dinfo.m_last_resolve_ts = ts;
-		m_cache[sname] = dinfo;
+		dinfo.m_name = std::make_shared<dns_name>(sname, ts);
+		it = m_cache.insert({sname, dinfo}).first;
+		// the reverse index gets rebuilt by the next lookup by address, so
+		// that adding many names in a row only pays for it once
+		m_index_dirty = true;
 	}
 
-	m_cache[sname].m_last_used_ts = ts;
-	dns_info &dinfo = m_cache[sname];
+	dns_info &dinfo = it->second;
+	dinfo.m_name->m_last_used_ts.store(ts, std::memory_order_relaxed);
 
 	m_erase_mutex.unlock();
 
@@ -140,28 +183,31 @@ std::string sinsp_dns_manager::name_of(int af, void *addr, uint64_t ts) {
 	std::string ret;
 
 #if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
-	if(!m_cache.empty()) {
-		m_erase_mutex.lock();
-		for(auto &it : m_cache) {
-			const std::string &name = it.first;
-			sinsp_dns_manager::dns_info &info = it.second;
+	if(m_index_dirty.load(std::memory_order_acquire)) {
+		refresh_index();
+	}
 
-			if(af == AF_INET6) {
-				ipv6addr v6;
-				memcpy(v6.m_b, addr, sizeof(ipv6addr));
-				if(info.m_v6_addrs.find(v6) != info.m_v6_addrs.end()) {
-					info.m_last_used_ts = ts;
-					ret = name;
-					break;
-				}
-			} else if(af == AF_INET &&
-			          info.m_v4_addrs.find(*(uint32_t *)addr) != info.m_v4_addrs.end()) {
-				info.m_last_used_ts = ts;
-				ret = name;
-				break;
+	std::shared_ptr<const reverse_index> index = std::atomic_load(&m_index);
+	if(index) {
+		const std::shared_ptr<dns_name> *entry = nullptr;
+		if(af == AF_INET6) {
+			ipv6addr v6;
+			memcpy(v6.m_b, addr, sizeof(ipv6addr));
+			auto it = index->m_v6.find(v6);
+			if(it != index->m_v6.end()) {
+				entry = &it->second;
+			}
+		} else if(af == AF_INET) {
+			auto it = index->m_v4.find(*(uint32_t *)addr);
+			if(it != index->m_v4.end()) {
+				entry = &it->second;
 			}
 		}
-		m_erase_mutex.unlock();
+
+		if(entry) {
+			(*entry)->m_last_used_ts.store(ts, std::memory_order_relaxed);
+			ret = (*entry)->m_name;
+		}
 	}
 #endif
 	return ret;
@@ -23,12 +23,14 @@ limitations under the License.
 #include <sys/socket.h>
 #include <netdb.h>
 #endif
+#include <atomic>
 #include <string>
 #include <thread>
 #include <chrono>
 #include <future>
 #include <mutex>
 #include <memory>
+#include <unordered_map>
 #if !defined(__EMSCRIPTEN__)
 #include "tbb/concurrent_unordered_map.h"
 #endif
@@ -69,7 +71,8 @@ private:
 	sinsp_dns_manager():
 	        m_erase_timeout(3600 * ONE_SECOND_IN_NS),
 	        m_base_refresh_timeout(10 * ONE_SECOND_IN_NS),
-	        m_max_refresh_timeout(320 * ONE_SECOND_IN_NS) {};
+	        m_max_refresh_timeout(320 * ONE_SECOND_IN_NS),
+	        m_index_dirty(false) {};
 
 	~sinsp_dns_manager() { cleanup(); }
 
@@ -77,6 +80,15 @@ private:
 	void operator=(sinsp_dns_manager const &) = delete;
 
 #if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+	// shared by a cache entry and the reverse index, so that lookups by
+	// address can mark the name as used without locking the cache
+	struct dns_name {
+		dns_name(const std::string &name, uint64_t ts): m_name(name), m_last_used_ts(ts) {}
+
+		const std::string m_name;
+		std::atomic<uint64_t> m_last_used_ts;
+	};
+
 	struct dns_info {
 		bool operator==(const dns_info &other) const {
 			return m_v4_addrs == other.m_v4_addrs && m_v6_addrs == other.m_v6_addrs;
@@ -85,15 +97,36 @@ private:
 
 		uint64_t m_timeout;
 		uint64_t m_last_resolve_ts;
-		uint64_t m_last_used_ts;
+		std::shared_ptr<dns_name> m_name;
 		std::set<uint32_t> m_v4_addrs;
 		std::set<ipv6addr> m_v6_addrs;
 	};
 
+	struct ipv6addr_hash {
+		size_t operator()(const ipv6addr &addr) const {
+			uint64_t hi = ((uint64_t)addr.m_b[0] << 32) | addr.m_b[1];
+			uint64_t lo = ((uint64_t)addr.m_b[2] << 32) | addr.m_b[3];
+			return std::hash<uint64_t>()(hi ^ (lo * 0x9e3779b97f4a7c15ULL));
+		}
+	};
+
+	// Maps every resolved address to the name it belongs to. It is never
+	// modified once published: a new one replaces it whenever the cache
+	// changes, so lookups only need to grab a reference to the current one.
+	struct reverse_index {
+		std::unordered_map<uint32_t, std::shared_ptr<dns_name>> m_v4;
+		std::unordered_map<ipv6addr, std::shared_ptr<dns_name>, ipv6addr_hash> m_v6;
+	};
+
 	static inline dns_info resolve(const std::string &name, uint64_t ts);
 
+	// rebuilds the reverse index if the cache changed since the last time
+	void refresh_index();
+
 	typedef tbb::concurrent_unordered_map<std::string, dns_info> c_dns_table;
 	c_dns_table m_cache;
+
+	std::shared_ptr<const reverse_index> m_index;
 #endif
 
 	// tbb concurrent unordered map is not thread-safe for deletions,
@@ -110,5 +143,8 @@ private:
 	uint64_t m_base_refresh_timeout;
 	uint64_t m_max_refresh_timeout;
 
+	// set when names or addresses are added to or removed from m_cache
+	std::atomic<bool> m_index_dirty;
+
 	friend sinsp_dns_resolver;
 };
@@ -26,12 +26,16 @@ sinsp_dumper::sinsp_dumper() {
 	m_target_memory_buffer = NULL;
 	m_target_memory_buffer_size = 0;
 	m_nevts = 0;
+	m_index_interval = 0;
+	m_compression_threads = 0;
 }
 
 sinsp_dumper::sinsp_dumper(uint8_t* target_memory_buffer, uint64_t target_memory_buffer_size) {
 	m_dumper = NULL;
 	m_target_memory_buffer = target_memory_buffer;
 	m_target_memory_buffer_size = target_memory_buffer_size;
+	m_index_interval = 0;
+	m_compression_threads = 0;
 }
 
 sinsp_dumper::~sinsp_dumper() {
@@ -51,6 +55,11 @@ void sinsp_dumper::open(sinsp* inspector, const std::string& filename, bool comp
 		                                 m_target_memory_buffer,
 		                                 m_target_memory_buffer_size,
 		                                 error);
+	} else if(compress && m_compression_threads > 0) {
+		m_dumper = scap_dump_open_parallel(inspector->get_scap_platform(),
+		                                   filename.c_str(),
+		                                   m_compression_threads,
+		                                   error);
 	} else {
 		auto compress_mode = compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE;
 		m_dumper = scap_dump_open(inspector->get_scap_platform(),
@@ -63,6 +72,14 @@ void sinsp_dumper::open(sinsp* inspector, const std::string& filename, bool comp
 		throw sinsp_exception(error);
 	}
 
+	if(!m_index_filename.empty() &&
+	   scap_dump_open_index(m_dumper, m_index_filename.c_str(), m_index_interval) !=
+	           SCAP_SUCCESS) {
+		std::string err = scap_dump_getlasterr(m_dumper);
+		close();
+		throw sinsp_exception(err);
+	}
+
 	inspector->m_thread_manager->dump_threads_to_file(m_dumper);
 	inspector->m_container_manager.dump_containers(*this);
 	inspector->m_usergroup_manager.dump_users_groups(*this);
@@ -70,6 +87,15 @@ void sinsp_dumper::open(sinsp* inspector, const std::string& filename, bool comp
 	m_nevts = 0;
 }
 
+void sinsp_dumper::set_index(const std::string& filename, uint32_t interval) {
+	m_index_filename = filename;
+	m_index_interval = interval;
+}
+
+void sinsp_dumper::set_compression_threads(uint32_t num_threads) {
+	m_compression_threads = num_threads;
+}
+
 void sinsp_dumper::fdopen(sinsp* inspector, int fd, bool compress) {
 	char error[SCAP_LASTERR_SIZE];
 	if(inspector->get_scap_handle() == NULL) {
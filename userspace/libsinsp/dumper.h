@@ -72,6 +72,25 @@ public:
 
 	void fdopen(sinsp* inspector, int fd, bool compress);
 
+	/*!
+	  \brief Makes the next file opened be indexed: a checkpoint is written to
+	   the index file every interval events, so that reading the file can start
+	   from a timestamp or an event number with sinsp::set_savefile_start().
+	   Must be called before open().
+
+	  \param filename The name of the index file, empty to stop indexing.
+
+	  \param interval The number of events between two checkpoints.
+	*/
+	void set_index(const std::string& filename, uint32_t interval = 4096);
+
+	/*!
+	  \brief Makes the next compressed file opened be compressed by this many
+	   threads in the background, instead of the thread calling dump(). Value of
+	   0 (default) compresses on the calling thread. Must be called before open().
+	*/
+	void set_compression_threads(uint32_t num_threads);
+
 	/*!
 	  \brief Closes the dump file.
 	*/
@@ -126,6 +145,9 @@ private:
 	uint8_t* m_target_memory_buffer;
 	uint64_t m_target_memory_buffer_size;
 	uint64_t m_nevts;
+	std::string m_index_filename;
+	uint32_t m_index_interval;
+	uint32_t m_compression_threads;
 };
 
 /*@}*/
@@ -21,6 +21,8 @@ limitations under the License.
 #include <libsinsp/eventformatter.h>
 #include <libsinsp/filter/parser.h>
 
+#include <algorithm>
+
 static constexpr const char* s_not_available_str = "<NA>";
 
 sinsp_evt_formatter::sinsp_evt_formatter(sinsp* inspector, filter_check_list& available_checks):
@@ -51,6 +53,8 @@ void sinsp_evt_formatter::set_format(output_format of, const std::string& fmt) {
 	}
 
 	m_output_tokens.clear();
+	m_output_tokenlens.clear();
+	m_resolution_tokens.clear();
 	m_output_format = of;
 
 	//
@@ -192,6 +196,25 @@ void sinsp_evt_formatter::set_format(output_format of, const std::string& fmt) {
 		m_output_tokens.emplace_back(chk);
 		m_output_tokenlens.push_back(0);
 	}
+
+	// plan the keys of the streaming JSON output in the same order in which
+	// they are written by jsoncpp, and escape them once
+	std::vector<const resolution_token*> sorted;
+	for(const auto& t : m_resolution_tokens) {
+		sorted.push_back(&t);
+	}
+	std::stable_sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+		return a->name < b->name;
+	});
+	m_json_keys.clear();
+	for(size_t i = 0; i < sorted.size(); i++) {
+		if(i > 0 && sorted[i]->name == sorted[i - 1]->name) {
+			continue;
+		}
+		m_json_keys.emplace_back(Json::valueToQuotedString(sorted[i]->name.c_str()) + ":",
+		                         sorted[i]->token,
+		                         sorted[i]->has_transformers);
+	}
 }
 
 bool sinsp_evt_formatter::resolve_tokens(sinsp_evt* evt,
@@ -234,6 +257,10 @@ bool sinsp_evt_formatter::tostring_withformat(sinsp_evt* evt,
                                               output_format of) {
 	output.clear();
 
+	if(of == OF_JSON && m_streaming_json) {
+		return tostring_json(evt, output);
+	}
+
 	if(of == OF_JSON) {
 		bool retval = true;
 		for(const auto& t : m_resolution_tokens) {
@@ -247,7 +274,7 @@ bool sinsp_evt_formatter::tostring_withformat(sinsp_evt* evt,
 				retval = false;
 				break;
 			}
-			m_root[t.name] = t.token->tojson(evt);
+			m_root[t.name] = std::move(json_value);
 		}
 		output = m_writer.write(m_root);
 		output = output.substr(0, output.size() - 1);
@@ -267,9 +294,10 @@ bool sinsp_evt_formatter::tostring_withformat(sinsp_evt* evt,
 
 		uint32_t tks = m_output_tokenlens[j];
 		if(tks != 0) {
-			std::string sstr(str);
-			sstr.resize(tks, ' ');
-			output += sstr;
+			// truncate or pad the value to the token length
+			size_t len = strnlen(str, tks);
+			output.append(str, len);
+			output.append(tks - len, ' ');
 		} else {
 			output += str;
 		}
@@ -278,6 +306,31 @@ bool sinsp_evt_formatter::tostring_withformat(sinsp_evt* evt,
 	return true;
 }
 
+bool sinsp_evt_formatter::tostring_json(sinsp_evt* evt, std::string& output) {
+	bool retval = true;
+	bool empty = true;
+	for(const auto& k : m_json_keys) {
+		if(k.has_transformers && !m_resolve_transformed_fields) {
+			continue;
+		}
+
+		auto size = output.size();
+		output += empty ? '{' : ',';
+		output += k.prefix;
+		if(!k.token->append_json(evt, output)) {
+			if(m_require_all_values) {
+				output.resize(size);
+				retval = false;
+				break;
+			}
+			output += "null";
+		}
+		empty = false;
+	}
+	output += empty ? "null" : "}";
+	return retval;
+}
+
 bool sinsp_evt_formatter::tostring(sinsp_evt* evt, std::string& res) {
 	return tostring_withformat(evt, res, m_output_format);
 }
@@ -294,6 +347,12 @@ void sinsp_evt_formatter_factory::set_output_format(sinsp_evt_formatter::output_
 	m_output_format = of;
 }
 
+void sinsp_evt_formatter_factory::set_streaming_json(bool v) {
+	m_formatters.clear();
+
+	m_streaming_json = v;
+}
+
 std::shared_ptr<sinsp_evt_formatter> sinsp_evt_formatter_factory::create_formatter(
         const std::string& format) {
 	auto it = m_formatters.find(format);
@@ -305,6 +364,7 @@ std::shared_ptr<sinsp_evt_formatter> sinsp_evt_formatter_factory::create_formatt
 	auto ret = std::make_shared<sinsp_evt_formatter>(m_inspector, m_available_checks);
 
 	ret->set_format(m_output_format, format);
+	ret->set_streaming_json(m_streaming_json);
 	m_formatters[format] = ret;
 
 	return ret;
@@ -107,6 +107,18 @@ public:
 
 	inline void set_resolve_transformed_fields(bool v) { m_resolve_transformed_fields = v; }
 
+	/**
+	 * \brief If true, JSON outputs are written straight into the output
+	 * string by a streaming writer, following a plan of keys sorted and
+	 * escaped once when setting the format, instead of building a JSON
+	 * document for each event. The outputs are the same, except that when
+	 * all the values are required and one is missing the output stops at
+	 * the missing value in key order.
+	 */
+	inline bool get_streaming_json() const { return m_streaming_json; }
+
+	inline void set_streaming_json(bool v) { m_streaming_json = v; }
+
 private:
 	using token_t = std::shared_ptr<sinsp_filter_check>;
 
@@ -121,6 +133,20 @@ private:
 		        has_transformers(h) {}
 	};
 
+	// a key of the JSON output, with its quoted name followed by ':'
+	struct json_key {
+		std::string prefix;
+		token_t token;
+		bool has_transformers = false;
+
+		json_key(std::string p, token_t t, bool h):
+		        prefix(std::move(p)),
+		        token(std::move(t)),
+		        has_transformers(h) {}
+	};
+
+	bool tostring_json(sinsp_evt *evt, std::string &output);
+
 	output_format m_output_format;
 
 	// vector of (full string of the token, filtercheck) pairs
@@ -128,10 +154,12 @@ private:
 	std::vector<token_t> m_output_tokens;
 	std::vector<uint32_t> m_output_tokenlens;
 	std::vector<resolution_token> m_resolution_tokens;
+	std::vector<json_key> m_json_keys;
 	sinsp *m_inspector = nullptr;
 	filter_check_list &m_available_checks;
 	bool m_require_all_values = false;
 	bool m_resolve_transformed_fields = false;
+	bool m_streaming_json = false;
 
 	Json::Value m_root;
 	Json::FastWriter m_writer;
@@ -144,6 +172,8 @@ public:
 
 	virtual void set_output_format(sinsp_evt_formatter::output_format of);
 
+	virtual void set_streaming_json(bool v);
+
 	virtual std::shared_ptr<sinsp_evt_formatter> create_formatter(const std::string &format);
 
 protected:
@@ -153,4 +183,5 @@ protected:
 	sinsp *m_inspector;
 	filter_check_list &m_available_checks;
 	sinsp_evt_formatter::output_format m_output_format;
+	bool m_streaming_json = false;
 };
@@ -365,7 +365,7 @@ inline const std::shared_ptr<sinsp_fdinfo>& sinsp_fdtable::add_ref(
 				m_sinsp_stats_v2->m_n_added_fds++;
 			}
 
-			return m_table.emplace(fd, std::move(fdinfo)).first->second;
+			return m_table.emplace(fd, libsinsp::make_slab_shared(std::move(fdinfo))).first->second;
 		} else {
 			return m_nullptr_ret;
 		}
@@ -383,7 +383,7 @@ inline const std::shared_ptr<sinsp_fdinfo>& sinsp_fdtable::add_ref(
 			fdinfo->m_flags &= ~sinsp_fdinfo::FLAGS_CLOSE_IN_PROGRESS;
 			fdinfo->m_flags |= sinsp_fdinfo::FLAGS_CLOSE_CANCELED;
 
-			m_table[CANCELED_FD_NUMBER] = it->second->clone();
+			m_table[CANCELED_FD_NUMBER] = libsinsp::make_slab_shared(it->second->clone());
 		} else {
 			//
 			// This can happen if:
@@ -403,7 +403,7 @@ inline const std::shared_ptr<sinsp_fdinfo>& sinsp_fdtable::add_ref(
 		// Replace the fd as a struct copy
 		//
 		m_last_accessed_fd = -1;
-		it->second = std::move(fdinfo);
+		it->second = libsinsp::make_slab_shared(std::move(fdinfo));
 		return it->second;
 	}
 }
@@ -21,6 +21,7 @@ limitations under the License.
 #include <libscap/scap.h>
 #include <libsinsp/tuples.h>
 #include <libsinsp/sinsp_public.h>
+#include <libsinsp/slab_allocator.h>
 #include <libsinsp/state/table.h>
 
 #include <unordered_map>
@@ -108,6 +109,9 @@ public:
 		FLAGS_CONNECTION_FAILED = (1 << 16),
 		FLAGS_OVERLAY_UPPER = (1 << 17),
 		FLAGS_OVERLAY_LOWER = (1 << 18),
+		// Found by a lazy /proc scan, only the type of the inode is known
+		// until sinsp_threadinfo::get_fd() resolves it
+		FLAGS_DEFERRED = (1 << 19),
 	};
 
 	sinsp_fdinfo(const std::shared_ptr<libsinsp::state::dynamic_struct::field_infos>& dyn_fields =
@@ -119,6 +123,12 @@ public:
 
 	virtual ~sinsp_fdinfo() = default;
 
+	// fds are opened and closed all the time, so their entries come from a pool
+	static void* operator new(size_t size) { return libsinsp::slab_new<sinsp_fdinfo>(size); }
+	static void operator delete(void* p, size_t size) {
+		libsinsp::slab_delete<sinsp_fdinfo>(p, size);
+	}
+
 	libsinsp::state::static_struct::field_infos static_fields() const override;
 
 	virtual std::unique_ptr<sinsp_fdinfo> clone() const {
@@ -276,6 +286,8 @@ public:
 		return (m_flags & FLAGS_OVERLAY_LOWER) == FLAGS_OVERLAY_LOWER;
 	}
 
+	inline bool is_deferred() const { return (m_flags & FLAGS_DEFERRED) == FLAGS_DEFERRED; }
+
 	void add_filename_raw(std::string_view rawpath);
 
 	void add_filename(std::string_view fullpath);
@@ -28,7 +28,9 @@ limitations under the License.
 //
 
 #include <algorithm>
+#include <cstring>
 #include <iomanip>
+#include <map>
 
 #include <libsinsp/sinsp.h>
 #include <libsinsp/sinsp_int.h>
@@ -47,6 +49,10 @@ void sinsp_filter_expression::add_check(std::unique_ptr<sinsp_filter_check> chk)
 }
 
 bool sinsp_filter_expression::compare(sinsp_evt* evt) {
+	if(m_sample_period != 0) {
+		return compare_sampled(evt);
+	}
+
 	bool res = true;
 
 	sinsp_filter_check* chk = nullptr;
@@ -125,6 +131,139 @@ int32_t sinsp_filter_expression::get_expr_boolop() const {
 	return b0;
 }
 
+uint32_t sinsp_filter_expression::get_cost() const {
+	uint32_t cost = 0;
+	for(const auto& c : m_checks) {
+		cost += c->get_cost();
+	}
+	return cost;
+}
+
+void sinsp_filter_expression::reorder_checks(uint64_t sample_period) {
+	for(auto& c : m_checks) {
+		auto expr = dynamic_cast<sinsp_filter_expression*>(c.get());
+		if(expr != nullptr) {
+			expr->reorder_checks(sample_period);
+		}
+	}
+
+	auto op = get_expr_boolop();
+	if(m_checks.size() < 2 || (op != BO_AND && op != BO_OR)) {
+		return;
+	}
+
+	m_sampled_boolop = (boolop)op;
+	m_stats.assign(m_checks.size(), check_stats());
+	m_sample_period = sample_period;
+	m_num_compare = 0;
+	sort_checks();
+}
+
+bool sinsp_filter_expression::compare_sampled(sinsp_evt* evt) {
+	// the result of a check that short-circuits the evaluation
+	bool decisive = m_sampled_boolop == BO_OR;
+
+	bool res = !decisive;
+	auto size = m_checks.size();
+	for(size_t j = 0; j < size; j++) {
+		auto chk = m_checks[j].get();
+		res = chk->compare(evt);
+		if(chk->m_boolop & BO_NOT) {
+			res = !res;
+		}
+		m_stats[j].m_num_compare++;
+		if(res == decisive) {
+			m_stats[j].m_num_decisive++;
+			break;
+		}
+	}
+
+	if(++m_num_compare >= m_sample_period) {
+		m_num_compare = 0;
+		sort_checks();
+	}
+	return res;
+}
+
+void sinsp_filter_expression::sort_checks() {
+	// the checks are ranked by their cost over the estimated probability of
+	// short-circuiting the expression, which is 1/2 before any evaluation
+	auto size = m_checks.size();
+	std::vector<double> rank(size);
+	std::vector<size_t> order(size);
+	for(size_t j = 0; j < size; j++) {
+		auto& s = m_stats[j];
+		rank[j] = m_checks[j]->get_cost() * double(s.m_num_compare + 2) /
+		          double(s.m_num_decisive + 1);
+		order[j] = j;
+	}
+	std::stable_sort(order.begin(), order.end(), [&rank](size_t a, size_t b) {
+		return rank[a] < rank[b];
+	});
+
+	std::vector<std::unique_ptr<sinsp_filter_check>> checks(size);
+	std::vector<check_stats> stats(size);
+	for(size_t j = 0; j < size; j++) {
+		checks[j] = std::move(m_checks[order[j]]);
+
+		// halve the samples, so that the order follows the changes in the
+		// events being filtered
+		stats[j].m_num_compare = m_stats[order[j]].m_num_compare / 2;
+		stats[j].m_num_decisive = m_stats[order[j]].m_num_decisive / 2;
+
+		// only the first check has no boolean operator, besides 'not'
+		auto negated = (boolop)(checks[j]->m_boolop & BO_NOT);
+		checks[j]->m_boolop = (boolop)(j == 0 ? negated : m_sampled_boolop | negated);
+	}
+	m_checks = std::move(checks);
+	m_stats = std::move(stats);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// sinsp_filter_multi_match implementation
+///////////////////////////////////////////////////////////////////////////////
+sinsp_filter_multi_match::sinsp_filter_multi_match(std::unique_ptr<sinsp_filter_check> field):
+        m_field(std::move(field)) {}
+
+void sinsp_filter_multi_match::add_values(cmpop op, const filter_value_t* values, size_t count) {
+	for(size_t i = 0; i < count; i++) {
+		// like flt_compare(), only consider the values up to their terminator
+		std::string_view v((const char*)values[i].first,
+		                   strnlen((const char*)values[i].first, values[i].second));
+		switch(op) {
+		case CO_EQ:
+		case CO_IN:
+			m_matcher.add_equals(v);
+			break;
+		case CO_STARTSWITH:
+			m_matcher.add_prefix(v);
+			break;
+		case CO_CONTAINS:
+			m_matcher.add_substring(v);
+			break;
+		default:
+			ASSERT(false);
+			throw sinsp_exception("operator '" + std::to_string(op) +
+			                      "' can't be merged with other checks");
+		}
+	}
+}
+
+bool sinsp_filter_multi_match::compare_nocache(sinsp_evt* evt) {
+	m_extracted_values.clear();
+	if(!m_field->extract(evt, m_extracted_values, false)) {
+		return false;
+	}
+
+	for(const auto& v : m_extracted_values) {
+		auto len = v.len == 0 ? strlen((const char*)v.ptr) : strnlen((const char*)v.ptr, v.len);
+		if(m_matcher.match(std::string_view((const char*)v.ptr, len))) {
+			return true;
+		}
+	}
+	return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // sinsp_filter implementation
 ///////////////////////////////////////////////////////////////////////////////
@@ -221,6 +360,10 @@ std::unique_ptr<sinsp_filter> sinsp_filter_compiler::compile() {
 		throw e;
 	}
 
+	if(m_reorder_checks) {
+		m_filter->m_filter->reorder_checks(m_reorder_sample_period);
+	}
+
 	// return compiled filter
 	return std::move(m_filter);
 }
@@ -248,8 +391,20 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::or_expr* e) {
 		m_filter->push_expression(m_last_boolop);
 		m_last_boolop = BO_NONE;
 	}
-	for(auto& c : e->children) {
-		c->accept(this);
+
+	// checks merged with others replace the first of them and
+	// the other ones are skipped
+	std::vector<std::unique_ptr<sinsp_filter_check>> merged(e->children.size());
+	std::vector<bool> skipped(e->children.size(), false);
+	merge_or_checks(e, merged, skipped);
+
+	for(size_t i = 0; i < e->children.size(); i++) {
+		if(merged[i]) {
+			merged[i]->m_boolop = m_last_boolop;
+			m_filter->add_check(std::move(merged[i]));
+		} else if(!skipped[i]) {
+			e->children[i]->accept(this);
+		}
 		m_last_boolop = BO_OR;
 	}
 	if(nested) {
@@ -570,6 +725,121 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::field_transformer
 	}
 }
 
+void sinsp_filter_compiler::merge_or_checks(
+        const libsinsp::filter::ast::or_expr* e,
+        std::vector<std::unique_ptr<sinsp_filter_check>>& merged,
+        std::vector<bool>& skipped) {
+	using namespace libsinsp::filter::ast;
+
+	// group the string comparisons of a field with constant values,
+	// in the order in which they appear
+	std::map<std::string, std::vector<size_t>> groups;
+	for(size_t i = 0; i < e->children.size(); i++) {
+		auto check = dynamic_cast<const binary_check_expr*>(e->children[i].get());
+		if(check == nullptr) {
+			continue;
+		}
+
+		auto field = dynamic_cast<const field_expr*>(check->left.get());
+		if(field == nullptr || (dynamic_cast<const value_expr*>(check->right.get()) == nullptr &&
+		                        dynamic_cast<const list_expr*>(check->right.get()) == nullptr)) {
+			continue;
+		}
+
+		auto op = str_to_cmpop(check->op);
+		if(op == CO_EQ || op == CO_IN || op == CO_CONTAINS || op == CO_STARTSWITH) {
+			groups[create_filtercheck_name(field->field, field->arg)].push_back(i);
+		}
+	}
+
+	for(const auto& [field, indexes] : groups) {
+		std::vector<const binary_check_expr*> checks;
+		size_t num_values = 0;
+		for(auto i : indexes) {
+			auto check = static_cast<const binary_check_expr*>(e->children[i].get());
+			auto list = dynamic_cast<const list_expr*>(check->right.get());
+			num_values += list ? list->values.size() : 1;
+			checks.push_back(check);
+		}
+
+		if(checks.size() < 2 || num_values < s_min_multi_match_values) {
+			continue;
+		}
+
+		auto multi_match = create_multi_match(field, checks);
+		if(multi_match == nullptr) {
+			continue;
+		}
+
+		merged[indexes[0]] = std::move(multi_match);
+		for(size_t i = 1; i < indexes.size(); i++) {
+			skipped[indexes[i]] = true;
+		}
+	}
+}
+
+std::unique_ptr<sinsp_filter_check> sinsp_filter_compiler::create_multi_match(
+        const std::string& field,
+        const std::vector<const libsinsp::filter::ast::binary_check_expr*>& checks) {
+	using namespace libsinsp::filter::ast;
+
+	// let the checks be compiled one by one if they are not plain string
+	// comparisons, they will report any error on the way
+	auto chk = m_factory->new_filtercheck(field);
+	if(chk == nullptr || chk->parse_field_name(field, true, true) == -1) {
+		return nullptr;
+	}
+
+	auto info = chk->get_field_info();
+	if(info->is_list() || chk->has_custom_compare() ||
+	   (info->m_type != PT_CHARBUF && info->m_type != PT_FSPATH && info->m_type != PT_FSRELPATH)) {
+		return nullptr;
+	}
+
+	// install cache on the field extraction, shared with the other checks on it
+	sinsp_filter_cache_factory::node_info_t node_info;
+	node_info.m_field = chk->get_transformed_field_info();
+	auto metrics = m_cache_factory->new_metrics(checks[0]->left.get(), node_info);
+	chk->m_cache_metrics = metrics;
+	chk->m_extract_cache = m_cache_factory->new_extract_cache(checks[0]->left.get(), node_info);
+	if(info->is_ptr_unstable() && chk->m_extract_cache) {
+		chk->add_transformer(filter_transformer_type::FTR_STORAGE);
+	}
+
+	// read the values of all the checks, and remember which operator
+	// each of them is compared with
+	std::vector<std::pair<cmpop, size_t>> ops;
+	for(auto check : checks) {
+		m_pos = check->get_pos();
+		auto op = str_to_cmpop(check->op);
+		chk->m_cmpop = op;
+		check_op_type_compatibility(*chk);
+
+		m_field_values.clear();
+		check->right->accept(this);
+
+		// note: values are stored as for '=', and only kept by the check
+		// until they are all added to the matcher
+		chk->m_cmpop = CO_EQ;
+		for(const auto& v : m_field_values) {
+			check_value_and_add_warnings(op, check->right->get_pos(), v);
+			add_filtercheck_value(chk.get(), chk->get_filter_values().size(), v);
+		}
+		ops.emplace_back(op, m_field_values.size());
+	}
+
+	const auto& values = chk->get_filter_values();
+	auto ret = std::make_unique<sinsp_filter_multi_match>(std::move(chk));
+	size_t first = 0;
+	for(const auto& [op, count] : ops) {
+		ret->add_values(op, values.data() + first, count);
+		first += count;
+	}
+	ret->build();
+	ret->m_cache_metrics = metrics;
+	return ret;
+}
+
 std::string sinsp_filter_compiler::create_filtercheck_name(const std::string& name,
                                                            const std::string& arg) {
 	// The filtercheck factories parse the name + arg as a whole.
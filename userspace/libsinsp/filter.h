@@ -21,6 +21,7 @@ limitations under the License.
 #include <libsinsp/filter_check_list.h>
 #include <libsinsp/sinsp_filtercheck.h>
 #include <libsinsp/filter/parser.h>
+#include <libsinsp/multi_string_matcher.h>
 
 #include <set>
 #include <string>
@@ -56,6 +57,11 @@ public:
 
 	bool compare(sinsp_evt*) override;
 
+	//
+	// The cost of an expression is the one of evaluating all its checks.
+	//
+	uint32_t get_cost() const override;
+
 	void add_check(std::unique_ptr<sinsp_filter_check> chk);
 
 	//
@@ -66,8 +72,81 @@ public:
 	//
 	int32_t get_expr_boolop() const;
 
+	//
+	// Reorders the checks of this expression and of the nested ones by
+	// increasing cost, so that the cheapest ones short-circuit the evaluation
+	// of the most expensive ones. If sample_period is not zero, the checks
+	// are ordered again every sample_period evaluations of the expression,
+	// considering how often each of them decided its result.
+	//
+	// Checks must not be added to the expression after calling this.
+	//
+	void reorder_checks(uint64_t sample_period = 0);
+
 	sinsp_filter_expression* m_parent = nullptr;
 	std::vector<std::unique_ptr<sinsp_filter_check>> m_checks;
+
+private:
+	struct check_stats {
+		// The number of times the check was evaluated
+		uint64_t m_num_compare = 0;
+
+		// The number of times the check decided the result of the expression
+		uint64_t m_num_decisive = 0;
+	};
+
+	bool compare_sampled(sinsp_evt*);
+	void sort_checks();
+
+	boolop m_sampled_boolop = BO_NONE;
+	uint64_t m_sample_period = 0;
+	uint64_t m_num_compare = 0;
+	std::vector<check_stats> m_stats;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Multi-pattern match
+// Checks a string field against the values of several checks on it connected
+// by 'or', e.g. "fd.name startswith /etc or fd.name in (/bin/sh, /bin/bash)",
+// extracting it only once and matching all the values in a single pass.
+///////////////////////////////////////////////////////////////////////////////
+class sinsp_filter_multi_match : public sinsp_filter_check {
+public:
+	explicit sinsp_filter_multi_match(std::unique_ptr<sinsp_filter_check> field);
+	virtual ~sinsp_filter_multi_match() = default;
+
+	//
+	// The values come from the checks that were merged, the field parsing from
+	// the wrapped check.
+	//
+	int32_t parse_field_name(std::string_view,
+	                         bool alloc_state,
+	                         bool needed_for_filtering) override {
+		return 0;
+	}
+
+	void add_filter_value(const char* str, uint32_t len, uint32_t i = 0) override { return; }
+
+	const filtercheck_field_info* get_field_info() const override {
+		return m_field->get_field_info();
+	}
+
+	uint32_t get_cost() const override { return m_field->get_extract_cost() + 2; }
+
+	//
+	// Adds values of the wrapped check compared with one of the '=', 'in',
+	// 'contains' and 'startswith' operators. build() must be called once
+	// all of them are added.
+	//
+	void add_values(cmpop op, const filter_value_t* values, size_t count);
+	void build() { m_matcher.build(); }
+
+protected:
+	bool compare_nocache(sinsp_evt*) override;
+
+private:
+	std::unique_ptr<sinsp_filter_check> m_field;
+	multi_string_matcher m_matcher;
 };
 
 /*!
@@ -242,6 +321,20 @@ public:
 
 	const std::vector<message>& get_warnings() const { return m_warnings; }
 
+	/*!
+	    \brief Enables reordering the checks connected by 'and' and 'or' in
+	    the compiled filter by increasing cost, so that the cheapest ones are
+	    evaluated first
+	    \param enabled Whether the checks are reordered
+	    \param sample_period If not zero, the checks are ordered again every
+	    sample_period evaluations of each expression, also considering how
+	    often each check decided its result
+	*/
+	void set_reorder_checks(bool enabled, uint64_t sample_period = 0) {
+		m_reorder_checks = enabled;
+		m_reorder_sample_period = sample_period;
+	}
+
 private:
 	void visit(const libsinsp::filter::ast::and_expr*) override;
 	void visit(const libsinsp::filter::ast::or_expr*) override;
@@ -255,6 +348,12 @@ private:
 	void visit(const libsinsp::filter::ast::field_transformer_expr*) override;
 	std::string create_filtercheck_name(const std::string& name, const std::string& arg);
 	std::unique_ptr<sinsp_filter_check> create_filtercheck(std::string_view field);
+	void merge_or_checks(const libsinsp::filter::ast::or_expr* e,
+	                     std::vector<std::unique_ptr<sinsp_filter_check>>& merged,
+	                     std::vector<bool>& skipped);
+	std::unique_ptr<sinsp_filter_check> create_multi_match(
+	        const std::string& field,
+	        const std::vector<const libsinsp::filter::ast::binary_check_expr*>& checks);
 	void check_value_and_add_warnings(cmpop op,
 	                                  const libsinsp::filter::ast::pos_info& pos,
 	                                  const std::string& v);
@@ -279,6 +378,12 @@ private:
 	std::shared_ptr<sinsp_filter_cache_factory> m_cache_factory;
 	std::vector<message> m_warnings;
 	sinsp_filter_check_list m_default_filterlist;
+	bool m_reorder_checks = false;
+	uint64_t m_reorder_sample_period = 0;
+
+	// Minimum number of values for checks on the same field connected by
+	// 'or' to be merged into a sinsp_filter_multi_match
+	static constexpr const size_t s_min_multi_match_values = 8;
 };
 
 /*@}*/
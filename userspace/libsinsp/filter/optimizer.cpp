@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/filter/optimizer.h>
+
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace libsinsp::filter::ast;
+
+// `evt.num >= 0` holds for every event
+static bool is_always_true(const expr* e) {
+	auto c = dynamic_cast<const binary_check_expr*>(e);
+	if(c == nullptr || c->op != ">=") {
+		return false;
+	}
+	auto f = dynamic_cast<const field_expr*>(c->left.get());
+	auto v = dynamic_cast<const value_expr*>(c->right.get());
+	return f != nullptr && f->field == "evt.num" && f->arg.empty() && v != nullptr &&
+	       v->value == "0";
+}
+
+static std::unique_ptr<expr> constant_expr(bool value, const pos_info& pos) {
+	std::unique_ptr<expr> ret = binary_check_expr::create(field_expr::create("evt.num", "", pos),
+	                                                      ">=",
+	                                                      value_expr::create("0", pos),
+	                                                      pos);
+	if(!value) {
+		ret = not_expr::create(std::move(ret), pos);
+	}
+	return ret;
+}
+
+static bool is_equality(const binary_check_expr* c) {
+	return (c->op == "=" || c->op == "==") && dynamic_cast<const value_expr*>(c->right.get());
+}
+
+static bool is_in(const binary_check_expr* c) {
+	return c->op == "in" && dynamic_cast<const list_expr*>(c->right.get());
+}
+
+// The string representation of an expression, and the one of its negation
+static std::pair<std::string, std::string> keys(const expr* e) {
+	auto n = dynamic_cast<const not_expr*>(e);
+	auto key = as_string(e);
+	return {key, n != nullptr ? as_string(n->child.get()) : "not " + key};
+}
+
+namespace {
+
+struct optimizer_visitor : public const_expr_visitor {
+	explicit optimizer_visitor(const std::vector<std::pair<const expr*, bool>>& constants):
+	        m_constants(constants) {}
+
+	const std::vector<std::pair<const expr*, bool>>& m_constants;
+
+	// the optimized node, or null if it is constant
+	std::unique_ptr<expr> m_last_node;
+	bool m_last_value = false;
+
+	bool fold(const expr* e) {
+		if(is_always_true(e)) {
+			m_last_node = nullptr;
+			m_last_value = true;
+			return true;
+		}
+		for(const auto& c : m_constants) {
+			if(c.first->is_equal(e)) {
+				m_last_node = nullptr;
+				m_last_value = c.second;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template<typename T>
+	void visit_logical_op(const T* e) {
+		if(fold(e)) {
+			return;
+		}
+
+		// the value of a child deciding the result of the whole node
+		constexpr bool decisive = std::is_same_v<T, or_expr>;
+
+		std::vector<std::unique_ptr<expr>> children;
+		std::unordered_set<std::string> seen;
+		auto add = [&](std::unique_ptr<expr> c) {
+			auto k = keys(c.get());
+			if(seen.count(k.second) > 0) {
+				// "A and not A" is false, "A or not A" is true
+				return false;
+			}
+			if(seen.insert(k.first).second) {
+				children.push_back(std::move(c));
+			}
+			return true;
+		};
+
+		for(const auto& c : e->children) {
+			c->accept(this);
+			if(!m_last_node) {
+				if(m_last_value == decisive) {
+					return;
+				}
+				continue;
+			}
+
+			// nested nodes of the same kind are flattened
+			if(auto nested = dynamic_cast<T*>(m_last_node.get())) {
+				auto grandchildren = std::move(nested->children);
+				for(auto& gc : grandchildren) {
+					if(!add(std::move(gc))) {
+						m_last_node = nullptr;
+						m_last_value = decisive;
+						return;
+					}
+				}
+			} else if(!add(std::move(m_last_node))) {
+				m_last_value = decisive;
+				return;
+			}
+		}
+
+		if constexpr(decisive) {
+			merge_in_checks(children);
+		}
+
+		m_last_node = nullptr;
+		m_last_value = !decisive;
+		if(children.size() == 1) {
+			m_last_node = std::move(children[0]);
+		} else if(children.size() > 1) {
+			m_last_node = T::create(children, e->get_pos());
+		}
+	}
+
+	// Merges the '=' and 'in' checks on the same field into the first of them
+	void merge_in_checks(std::vector<std::unique_ptr<expr>>& children) {
+		struct group {
+			size_t first;
+			size_t count = 0;
+			bool has_equality = false;
+			std::vector<std::string> values;
+			std::unordered_set<std::string> seen;
+		};
+
+		std::vector<group> groups;
+		std::unordered_map<std::string, size_t> groups_by_field;
+		std::vector<size_t> child_group(children.size(), SIZE_MAX);
+		for(size_t i = 0; i < children.size(); i++) {
+			auto c = dynamic_cast<const binary_check_expr*>(children[i].get());
+			if(c == nullptr || (!is_equality(c) && !is_in(c))) {
+				continue;
+			}
+
+			auto field = as_string(c->left.get());
+			auto it = groups_by_field.find(field);
+			if(it == groups_by_field.end()) {
+				it = groups_by_field.emplace(field, groups.size()).first;
+				groups.emplace_back().first = i;
+			}
+			auto& g = groups[it->second];
+			g.count++;
+			child_group[i] = it->second;
+
+			auto add_value = [&g](const std::string& v) {
+				if(g.seen.insert(v).second) {
+					g.values.push_back(v);
+				}
+			};
+			if(is_equality(c)) {
+				g.has_equality = true;
+				add_value(static_cast<const value_expr*>(c->right.get())->value);
+			} else {
+				for(const auto& v : static_cast<const list_expr*>(c->right.get())->values) {
+					add_value(v);
+				}
+			}
+		}
+
+		std::vector<std::unique_ptr<expr>> merged;
+		for(size_t i = 0; i < children.size(); i++) {
+			auto gi = child_group[i];
+			if(gi == SIZE_MAX || !groups[gi].has_equality || groups[gi].count < 2) {
+				merged.push_back(std::move(children[i]));
+				continue;
+			}
+			if(groups[gi].first != i) {
+				continue;
+			}
+			auto c = static_cast<binary_check_expr*>(children[i].get());
+			merged.push_back(binary_check_expr::create(std::move(c->left),
+			                                           "in",
+			                                           list_expr::create(groups[gi].values,
+			                                                             c->right->get_pos()),
+			                                           c->get_pos()));
+		}
+		children = std::move(merged);
+	}
+
+	void visit(const and_expr* e) override { visit_logical_op(e); }
+
+	void visit(const or_expr* e) override { visit_logical_op(e); }
+
+	void visit(const not_expr* e) override {
+		if(fold(e)) {
+			return;
+		}
+		e->child->accept(this);
+		if(!m_last_node) {
+			m_last_value = !m_last_value;
+			return;
+		}
+		if(auto n = dynamic_cast<not_expr*>(m_last_node.get())) {
+			m_last_node = std::move(n->child);
+			return;
+		}
+		m_last_node = not_expr::create(std::move(m_last_node), e->get_pos());
+	}
+
+	void visit(const binary_check_expr* e) override {
+		if(!fold(e)) {
+			m_last_node = clone(e);
+		}
+	}
+
+	void visit(const unary_check_expr* e) override {
+		if(!fold(e)) {
+			m_last_node = clone(e);
+		}
+	}
+
+	void visit(const identifier_expr* e) override { m_last_node = clone(e); }
+
+	void visit(const value_expr* e) override { m_last_node = clone(e); }
+
+	void visit(const list_expr* e) override { m_last_node = clone(e); }
+
+	void visit(const field_expr* e) override { m_last_node = clone(e); }
+
+	void visit(const field_transformer_expr* e) override { m_last_node = clone(e); }
+};
+
+}  // namespace
+
+std::unique_ptr<expr> libsinsp::filter::ast::optimize(
+        const expr* e,
+        const std::vector<std::pair<const expr*, bool>>& constants) {
+	optimizer_visitor v(constants);
+	e->accept(&v);
+	if(!v.m_last_node) {
+		return constant_expr(v.m_last_value, e->get_pos());
+	}
+	return std::move(v.m_last_node);
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <libsinsp/filter/ast.h>
+
+#include <utility>
+#include <vector>
+
+namespace libsinsp {
+namespace filter {
+namespace ast {
+
+/*!
+    \brief Returns an optimized copy of a filter AST, which evaluates to
+    the same results with fewer checks. The optimization:
+    - flattens the nested 'and' and 'or' nodes of the same kind
+    - removes the duplicate children of 'and' and 'or' nodes, and the
+      double negations
+    - merges the '=' and 'in' checks on the same field connected by 'or'
+      into a single 'in' check, if at least one of them is an '=' check
+      (which guarantees that the field is not a list)
+    - folds the constant subexpressions, such as `evt.num >= 0` (the
+      `always_true` macro of Falco rulesets) or `A and not A`. A filter
+      that is constant as a whole is returned as `evt.num >= 0` or
+      `not evt.num >= 0`.
+    \param e The AST expression to be optimized
+    \param constants Subexpressions known to always evaluate to the given
+    value, such as the conditions of the placeholder macros of a ruleset
+*/
+std::unique_ptr<expr> optimize(const expr* e,
+                               const std::vector<std::pair<const expr*, bool>>& constants = {});
+
+}  // namespace ast
+}  // namespace filter
+}  // namespace libsinsp
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/filter_set.h>
+#include <libsinsp/filter/parser.h>
+#include <libsinsp/filter/ppm_codes.h>
+#include <libsinsp/sinsp_exception.h>
+
+sinsp_filter_set::sinsp_filter_set(
+        const std::shared_ptr<sinsp_filter_factory>& factory,
+        const std::shared_ptr<sinsp_filter_cache_factory>& cache_factory):
+        m_factory(factory),
+        m_cache_factory(cache_factory) {
+	// share the caches between all the filters, as they often
+	// extract the same fields
+	if(!m_cache_factory) {
+		m_cache_factory = std::make_shared<exprstr_sinsp_filter_cache_factory>();
+	}
+}
+
+void sinsp_filter_set::add(uint32_t id, const std::string& source, const std::string& filter) {
+	libsinsp::filter::parser parser(filter);
+	std::unique_ptr<libsinsp::filter::ast::expr> ast;
+	try {
+		ast = parser.parse();
+	} catch(const sinsp_exception& e) {
+		throw sinsp_exception("filter error at " + parser.get_pos().as_string() + ": " +
+		                      e.what());
+	}
+	add(id, source, ast.get());
+}
+
+void sinsp_filter_set::add(uint32_t id,
+                           const std::string& source,
+                           const libsinsp::filter::ast::expr* filter) {
+	sinsp_filter_compiler compiler(m_factory, filter, m_cache_factory);
+	auto e = std::make_unique<entry>();
+	e->id = id;
+	e->filter = compiler.compile();
+
+	auto src = get_source(source);
+	if(src == nullptr) {
+		src = m_sources.emplace_back(std::make_unique<source_filters>()).get();
+		src->name = source;
+		src->by_type.resize(PPM_EVENT_MAX);
+
+		// the sources of the events are matched again with the new one
+		m_sources_by_idx.clear();
+		m_known_source_idx.clear();
+	}
+
+	auto codes = libsinsp::filter::ast::ppm_event_codes(filter);
+	codes.for_each([src, &e](ppm_event_code code) {
+		src->by_type[code].push_back(e.get());
+		return true;
+	});
+
+	m_filters.push_back(std::move(e));
+}
+
+bool sinsp_filter_set::run(sinsp_evt* evt, std::vector<uint32_t>& ids) {
+	ids.clear();
+
+	auto src = get_source(evt);
+	auto type = evt->get_type();
+	if(src == nullptr || type >= src->by_type.size()) {
+		return false;
+	}
+
+	for(auto e : src->by_type[type]) {
+		if(e->filter->run(evt)) {
+			ids.push_back(e->id);
+		}
+	}
+	return !ids.empty();
+}
+
+size_t sinsp_filter_set::size(const std::string& source, ppm_event_code type) const {
+	auto src = get_source(source);
+	if(src == nullptr || type >= src->by_type.size()) {
+		return 0;
+	}
+	return src->by_type[type].size();
+}
+
+sinsp_filter_set::source_filters* sinsp_filter_set::get_source(const std::string& name) const {
+	for(const auto& s : m_sources) {
+		if(s->name == name) {
+			return s.get();
+		}
+	}
+	return nullptr;
+}
+
+sinsp_filter_set::source_filters* sinsp_filter_set::get_source(const sinsp_evt* evt) {
+	// the index of an event source is stable for a given inspector, so the
+	// name of the source is only looked up the first time it is seen
+	auto idx = evt->get_source_idx();
+	if(idx == sinsp_no_event_source_idx) {
+		return nullptr;
+	}
+
+	if(idx >= m_known_source_idx.size()) {
+		m_known_source_idx.resize(idx + 1, false);
+		m_sources_by_idx.resize(idx + 1, nullptr);
+	}
+
+	if(!m_known_source_idx[idx]) {
+		auto name = evt->get_source_name();
+		m_sources_by_idx[idx] = name ? get_source(name) : nullptr;
+		m_known_source_idx[idx] = true;
+	}
+	return m_sources_by_idx[idx];
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <libsinsp/filter.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+  \brief A set of filters, each one with an ID, evaluated together on the
+  events. Filters are indexed by the event source they apply to and by the
+  event types they can match, so that each event is only evaluated by the
+  filters that may match it.
+*/
+class SINSP_PUBLIC sinsp_filter_set {
+public:
+	/*!
+	    \brief Constructs the set
+	    \param factory Pointer to a filter factory used to compile the filters
+	    \param cache_factory Pointer to a factory of filter caches shared by
+	    all the filters of the set. By default, caching is enabled.
+	*/
+	explicit sinsp_filter_set(
+	        const std::shared_ptr<sinsp_filter_factory>& factory,
+	        const std::shared_ptr<sinsp_filter_cache_factory>& cache_factory = nullptr);
+
+	virtual ~sinsp_filter_set() = default;
+	sinsp_filter_set(sinsp_filter_set&&) = default;
+	sinsp_filter_set& operator=(sinsp_filter_set&&) = default;
+	sinsp_filter_set(const sinsp_filter_set&) = delete;
+	sinsp_filter_set& operator=(const sinsp_filter_set&) = delete;
+
+	/*!
+	    \brief Compiles a filter and adds it to the set
+	    \param id The ID reported when the filter matches an event
+	    \param source The name of the event source the filter applies to
+	    \param filter The filter string
+	    \note Throws a sinsp_exception if the filter can't be compiled
+	*/
+	void add(uint32_t id, const std::string& source, const std::string& filter);
+
+	/*!
+	    \brief Compiles the AST of a parsed filter and adds it to the set
+	    \param id The ID reported when the filter matches an event
+	    \param source The name of the event source the filter applies to
+	    \param filter The AST of the filter
+	    \note Throws a sinsp_exception if the filter can't be compiled
+	*/
+	void add(uint32_t id, const std::string& source, const libsinsp::filter::ast::expr* filter);
+
+	/*!
+	    \brief Evaluates the filters that may match the event
+	    \param evt The event
+	    \param ids Filled with the IDs of the filters matching the event,
+	    in the order they were added to the set
+	    \return true if at least one filter matched the event
+	*/
+	bool run(sinsp_evt* evt, std::vector<uint32_t>& ids);
+
+	/*!
+	    \brief Returns the number of filters in the set
+	*/
+	size_t size() const { return m_filters.size(); }
+
+	/*!
+	    \brief Returns the number of filters in the set that may match
+	    events of the given source and type
+	*/
+	size_t size(const std::string& source, ppm_event_code type) const;
+
+private:
+	struct entry {
+		uint32_t id;
+		std::unique_ptr<sinsp_filter> filter;
+	};
+
+	struct source_filters {
+		std::string name;
+
+		// indexed by ppm_event_code
+		std::vector<std::vector<entry*>> by_type;
+	};
+
+	source_filters* get_source(const std::string& name) const;
+	source_filters* get_source(const sinsp_evt* evt);
+
+	std::shared_ptr<sinsp_filter_factory> m_factory;
+	std::shared_ptr<sinsp_filter_cache_factory> m_cache_factory;
+	std::vector<std::unique_ptr<entry>> m_filters;
+	std::vector<std::unique_ptr<source_filters>> m_sources;
+
+	// the sources of the filters by the index of the event source, as
+	// found in the events
+	std::vector<source_filters*> m_sources_by_idx;
+	std::vector<bool> m_known_source_idx;
+};
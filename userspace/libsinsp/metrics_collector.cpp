@@ -597,6 +597,18 @@ std::vector<metrics_v2> libs_state_counters::to_metrics() {
 	                                METRIC_VALUE_UNIT_COUNT,
 	                                METRIC_VALUE_METRIC_TYPE_MONOTONIC,
 	                                m_sinsp_stats_v2->m_n_removed_fds));
+	metrics.emplace_back(new_metric("n_deferred_fds",
+	                                METRICS_V2_STATE_COUNTERS,
+	                                METRIC_VALUE_TYPE_U64,
+	                                METRIC_VALUE_UNIT_COUNT,
+	                                METRIC_VALUE_METRIC_TYPE_MONOTONIC,
+	                                m_sinsp_stats_v2->m_n_deferred_fds));
+	metrics.emplace_back(new_metric("n_resolved_fds",
+	                                METRICS_V2_STATE_COUNTERS,
+	                                METRIC_VALUE_TYPE_U64,
+	                                METRIC_VALUE_UNIT_COUNT,
+	                                METRIC_VALUE_METRIC_TYPE_MONOTONIC,
+	                                m_sinsp_stats_v2->m_n_resolved_fds));
 	metrics.emplace_back(new_metric("n_stored_evts",
 	                                METRICS_V2_STATE_COUNTERS,
 	                                METRIC_VALUE_TYPE_U64,
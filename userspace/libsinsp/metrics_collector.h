@@ -35,6 +35,8 @@ struct sinsp_stats_v2 {
 	uint64_t m_n_failed_fd_lookups;
 	uint64_t m_n_added_fds;
 	uint64_t m_n_removed_fds;
+	uint64_t m_n_deferred_fds;
+	uint64_t m_n_resolved_fds;
 	///@)
 	///@(
 	/** evt parsing related counters, unit: count. */
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/multi_string_matcher.h>
+
+#include <algorithm>
+#include <map>
+#include <queue>
+
+multi_string_matcher::multi_string_matcher() {
+	std::fill(std::begin(m_root_next), std::end(m_root_next), 0);
+}
+
+void multi_string_matcher::add_equals(std::string_view pattern) {
+	m_num_patterns++;
+	if(m_equals.find(pattern) == m_equals.end()) {
+		m_equals.insert(m_storage.emplace_back(pattern));
+	}
+}
+
+void multi_string_matcher::add_prefix(std::string_view pattern) {
+	m_num_patterns++;
+	if(pattern.empty()) {
+		m_match_all = true;
+	}
+	m_prefixes.emplace_back(pattern);
+}
+
+void multi_string_matcher::add_substring(std::string_view pattern) {
+	m_num_patterns++;
+	if(pattern.empty()) {
+		m_match_all = true;
+	}
+	m_substrings.emplace_back(pattern);
+}
+
+void multi_string_matcher::build() {
+	// Drop the prefixes that start with another one: any string they
+	// match is also matched by the shorter one. Once sorted, all the
+	// strings starting with a prefix directly follow it.
+	std::sort(m_prefixes.begin(), m_prefixes.end());
+	std::vector<std::string> prefixes;
+	for(auto& p : m_prefixes) {
+		if(prefixes.empty() || p.compare(0, prefixes.back().size(), prefixes.back()) != 0) {
+			prefixes.push_back(std::move(p));
+		}
+	}
+	m_prefixes = std::move(prefixes);
+
+	// Build the trie of the substrings, then flatten it breadth-first
+	// while computing the failure links of the automaton.
+	std::vector<std::map<uint8_t, uint32_t>> trie(1);
+	std::vector<bool> out(1, false);
+	for(const auto& s : m_substrings) {
+		uint32_t state = 0;
+		for(auto c : s) {
+			auto it = trie[state].find((uint8_t)c);
+			if(it == trie[state].end()) {
+				trie[state][(uint8_t)c] = trie.size();
+				state = trie.size();
+				trie.emplace_back();
+				out.push_back(false);
+			} else {
+				state = it->second;
+			}
+		}
+		out[state] = true;
+	}
+	m_substrings.clear();
+
+	m_nodes.assign(trie.size(), ac_node{0, 0, 0, false});
+	m_edges.clear();
+	std::queue<uint32_t> pending;
+	pending.push(0);
+	while(!pending.empty()) {
+		uint32_t state = pending.front();
+		pending.pop();
+		auto& node = m_nodes[state];
+		node.out = node.out || out[state];
+		node.first_edge = m_edges.size();
+		node.num_edges = trie[state].size();
+		for(auto& [c, child] : trie[state]) {
+			m_edges.emplace_back(c, child);
+			if(state == 0) {
+				m_root_next[c] = child;
+				m_nodes[child].fail = 0;
+			} else {
+				// The nodes are visited by increasing depth, so the
+				// transitions of the shorter suffixes are all known
+				uint32_t fail = m_nodes[state].fail;
+				m_nodes[child].fail = next_state(fail, c);
+			}
+			m_nodes[child].out = m_nodes[m_nodes[child].fail].out;
+			pending.push(child);
+		}
+	}
+}
+
+uint32_t multi_string_matcher::next_state(uint32_t state, uint8_t c) const {
+	while(state != 0) {
+		const auto& node = m_nodes[state];
+		auto first = m_edges.begin() + node.first_edge;
+		auto last = first + node.num_edges;
+		auto it = std::lower_bound(first, last, c, [](const auto& e, uint8_t v) {
+			return e.first < v;
+		});
+		if(it != last && it->first == c) {
+			return it->second;
+		}
+		state = node.fail;
+	}
+	return m_root_next[c];
+}
+
+bool multi_string_matcher::match_substrings(std::string_view str) const {
+	uint32_t state = 0;
+	for(auto c : str) {
+		state = next_state(state, (uint8_t)c);
+		if(m_nodes[state].out) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool multi_string_matcher::match(std::string_view str) const {
+	if(m_match_all) {
+		return true;
+	}
+
+	if(!m_equals.empty() && m_equals.find(str) != m_equals.end()) {
+		return true;
+	}
+
+	if(!m_prefixes.empty()) {
+		// With no prefix starting with another one, the only prefix
+		// that can match is the greatest one not after the string.
+		auto it = std::upper_bound(m_prefixes.begin(),
+		                           m_prefixes.end(),
+		                           str,
+		                           [](std::string_view s, const std::string& p) { return s < p; });
+		if(it != m_prefixes.begin()) {
+			--it;
+			if(str.compare(0, it->size(), *it) == 0) {
+				return true;
+			}
+		}
+	}
+
+	return m_nodes.size() > 1 && match_substrings(str);
+}
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+//
+// A set of string patterns tested all at once against a string, which
+// matches if it is equal to, starts with or contains any of them.
+//
+// This is meant for long lists of patterns checked against the same
+// field, where testing them one by one is linear in their number:
+// - equality is a lookup in a hash set
+// - prefixes are kept sorted, so that the only candidate for a
+//   string is found with a binary search
+// - substrings are all searched in a single pass over the string
+//   with an Aho-Corasick automaton
+//
+// Patterns can't be added after build() is called.
+//
+class multi_string_matcher {
+public:
+	multi_string_matcher();
+
+	void add_equals(std::string_view pattern);
+	void add_prefix(std::string_view pattern);
+	void add_substring(std::string_view pattern);
+
+	// Must be called once after adding the patterns and before matching
+	void build();
+
+	bool match(std::string_view str) const;
+
+	size_t size() const { return m_num_patterns; }
+
+private:
+	// A state of the automaton. The transitions from the root are
+	// kept in m_root_next, the ones of the other states in
+	// m_edges[first_edge, first_edge + num_edges) sorted by byte.
+	struct ac_node {
+		uint32_t first_edge;
+		uint32_t num_edges;
+		uint32_t fail;
+		bool out;
+	};
+
+	uint32_t next_state(uint32_t state, uint8_t c) const;
+
+	bool match_substrings(std::string_view str) const;
+
+	size_t m_num_patterns = 0;
+	bool m_match_all = false;
+
+	std::deque<std::string> m_storage;
+	std::unordered_set<std::string_view> m_equals;
+	std::vector<std::string> m_prefixes;
+	std::vector<std::string> m_substrings;
+
+	std::vector<ac_node> m_nodes;
+	std::vector<std::pair<uint8_t, uint32_t>> m_edges;
+	uint32_t m_root_next[256];
+};
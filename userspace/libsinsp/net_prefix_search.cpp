@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/net_prefix_search.h>
+#include <libsinsp/sinsp_inet.h>
+
+void net_prefix_search::add_network(const ipv4net &net) {
+	// the netmask is in network byte order and made of leading ones
+	uint32_t mask = ntohl(net.m_netmask);
+	uint32_t prefix_len = 0;
+	while(prefix_len < 32 && (mask & (1U << (31 - prefix_len)))) {
+		prefix_len++;
+	}
+	m_v4.add((const uint8_t *)&net.m_ip, prefix_len);
+}
+
+void net_prefix_search::add_network(const ipv6net &net) {
+	m_v6.add((const uint8_t *)net.addr().m_b, net.prefix_len());
+}
+
+static inline uint32_t nibble(const uint8_t *addr, uint32_t i) {
+	return (i % 2) ? (addr[i / 2] & 0xf) : (addr[i / 2] >> 4);
+}
+
+void net_prefix_search::trie::add(const uint8_t *prefix, uint32_t prefix_len) {
+	uint32_t node = 0;
+	for(uint32_t i = 0;; i++) {
+		uint32_t nib = nibble(prefix, i);
+		uint32_t remaining = prefix_len - i * 4;
+		if(remaining <= 4) {
+			// the last bits of the prefix cover a range of slots, and any
+			// longer prefix already below them is now redundant
+			uint32_t span = 1 << (4 - remaining);
+			uint32_t first = nib & ~(span - 1);
+			for(uint32_t s = first; s < first + span; s++) {
+				m_nodes[node][s] = COVERED;
+			}
+			return;
+		}
+
+		uint32_t next = m_nodes[node][nib];
+		if(next == COVERED) {
+			return;
+		}
+		if(next == EMPTY) {
+			next = m_nodes.size();
+			m_nodes.emplace_back();
+			m_nodes[node][nib] = next;
+		}
+		node = next;
+	}
+}
+
+bool net_prefix_search::trie::match(const uint8_t *addr, uint32_t addr_len) const {
+	uint32_t node = 0;
+	for(uint32_t i = 0; i < addr_len / 4; i++) {
+		uint32_t next = m_nodes[node][nibble(addr, i)];
+		if(next == COVERED) {
+			return true;
+		}
+		if(next == EMPTY) {
+			return false;
+		}
+		node = next;
+	}
+	return false;
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <libsinsp/tuples.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// A set of IPv4 and IPv6 networks that tells whether an address belongs to any
+// of them. The networks are kept in one trie per address family, which
+// consumes 4 bits of the address per level, so that a lookup takes at most 8
+// (IPv4) or 32 (IPv6) steps regardless of how many networks the set holds.
+class net_prefix_search {
+public:
+	void add_network(const ipv4net &net);
+	void add_network(const ipv6net &net);
+
+	// addr is in network byte order, as in ipv4net::m_ip
+	bool match(uint32_t addr) const { return m_v4.match((const uint8_t *)&addr, 32); }
+	bool match(const ipv6addr &addr) const { return m_v6.match((const uint8_t *)addr.m_b, 128); }
+
+private:
+	class trie {
+	public:
+		void add(const uint8_t *prefix, uint32_t prefix_len);
+		bool match(const uint8_t *addr, uint32_t addr_len) const;
+
+	private:
+		// each slot is either empty, the index of the node for the next 4
+		// bits, or a mark that all the addresses below it are in the set
+		static constexpr uint32_t EMPTY = 0;
+		static constexpr uint32_t COVERED = UINT32_MAX;
+
+		std::vector<std::array<uint32_t, 16>> m_nodes{std::array<uint32_t, 16>{}};
+	};
+
+	trie m_v4;
+	trie m_v6;
+};
@@ -17,6 +17,7 @@ limitations under the License.
 */
 
 #include <inttypes.h>
+#include <algorithm>
 #include <string.h>
 #include <memory>
 #include <vector>
@@ -978,6 +979,9 @@ bool sinsp_plugin::extract_fields(sinsp_evt* evt,
 	ev.evtnum = evt->get_num();
 	ev.evtsrc = evt->get_source_name();
 
+	// the plugin is free to reuse the memory of the batched results
+	m_batch_evtnum = 0;
+
 	ss_plugin_field_extract_input in;
 	ss_plugin_table_reader_vtable_ext table_reader_ext;
 	in.num_fields = num_fields;
@@ -995,6 +999,78 @@ bool sinsp_plugin::extract_fields(sinsp_evt* evt,
 	return res;
 }
 
+size_t sinsp_plugin::add_batch_field(const ss_plugin_extract_field& field) {
+	size_t slot = m_batch_fields.size();
+	for(size_t i = 0; i < m_batch_fields.size(); i++) {
+		auto& f = m_batch_fields[i];
+		if(f.refs == 0) {
+			slot = std::min(slot, i);
+			continue;
+		}
+		if(f.field.field_id == field.field_id && f.field.arg_present == field.arg_present &&
+		   f.field.arg_index == field.arg_index &&
+		   (f.field.arg_key != nullptr) == (field.arg_key != nullptr) &&
+		   (field.arg_key == nullptr || f.arg_key == field.arg_key)) {
+			f.refs++;
+			return i;
+		}
+	}
+
+	if(slot == m_batch_fields.size()) {
+		m_batch_fields.emplace_back();
+	}
+	auto& f = m_batch_fields[slot];
+	f.field = field;
+	f.arg_key = field.arg_key != nullptr ? field.arg_key : "";
+	f.refs = 1;
+	m_batch_changed = true;
+	return slot;
+}
+
+void sinsp_plugin::remove_batch_field(size_t slot) {
+	ASSERT(slot < m_batch_fields.size() && m_batch_fields[slot].refs > 0);
+	if(--m_batch_fields[slot].refs == 0) {
+		m_batch_changed = true;
+	}
+}
+
+const ss_plugin_extract_field* sinsp_plugin::extract_batch_field(sinsp_evt* evt, size_t slot) {
+	if(m_batch_changed) {
+		m_batch.clear();
+		m_batch_pos.assign(m_batch_fields.size(), 0);
+		for(size_t i = 0; i < m_batch_fields.size(); i++) {
+			auto& f = m_batch_fields[i];
+			if(f.refs > 0) {
+				m_batch_pos[i] = m_batch.size();
+				m_batch.push_back(f.field);
+				m_batch.back().arg_key = f.field.arg_key != nullptr ? f.arg_key.c_str() : nullptr;
+			}
+		}
+		m_batch_changed = false;
+		m_batch_evtnum = 0;
+	}
+
+	ASSERT(slot < m_batch_pos.size() && m_batch_fields[slot].refs > 0);
+	auto field = &m_batch[m_batch_pos[slot]];
+
+	// events with no number can't be told apart, so their results are
+	// never reused
+	auto evtnum = evt->get_num();
+	if(evtnum == 0 || evtnum != m_batch_evtnum) {
+		m_batch_res = extract_fields(evt, m_batch.size(), m_batch.data());
+		m_batch_evtnum = evtnum;
+	}
+	if(m_batch_res) {
+		return field;
+	}
+
+	// a call fails as a whole if any of the fields can't be extracted, in
+	// which case they are extracted one by one without retrying the batch
+	auto res = extract_fields(evt, 1, field);
+	m_batch_evtnum = evtnum;
+	return res ? field : nullptr;
+}
+
 /** End of Field Extraction CAP **/
 
 /** Event Parsing CAP **/
@@ -185,6 +185,24 @@ public:
 
 	bool extract_fields(sinsp_evt* evt, uint32_t num_fields, ss_plugin_extract_field* fields);
 
+	/**
+	 * @brief Adds a field to the batch of the ones extracted together, with
+	 * a single call to the plugin for each event. Identical fields share
+	 * the same slot, which is released with remove_batch_field().
+	 * @return The slot of the field in the batch
+	 */
+	size_t add_batch_field(const ss_plugin_extract_field& field);
+
+	void remove_batch_field(size_t slot);
+
+	/**
+	 * @brief Extracts all the fields of the batch from the event, unless
+	 * already done for the same event, and returns the results of the
+	 * field in the given slot, or nullptr if it can't be extracted. The
+	 * results are valid until the fields are extracted from another event.
+	 */
+	const ss_plugin_extract_field* extract_batch_field(sinsp_evt* evt, size_t slot);
+
 	/** Event Parsing **/
 	inline const std::unordered_set<std::string>& parse_event_sources() const {
 		return m_parse_event_sources;
@@ -239,6 +257,22 @@ private:
 	std::unordered_set<std::string> m_extract_event_sources;
 	libsinsp::events::set<ppm_event_code> m_extract_event_codes;
 
+	/** Batched Field Extraction **/
+	struct batch_field {
+		ss_plugin_extract_field field = {};
+		std::string arg_key;
+		uint32_t refs = 0;
+	};
+	std::vector<batch_field> m_batch_fields;
+
+	// the fields with at least one reference, as passed to the plugin, and
+	// their position in it by slot
+	std::vector<ss_plugin_extract_field> m_batch;
+	std::vector<size_t> m_batch_pos;
+	bool m_batch_changed = false;
+	uint64_t m_batch_evtnum = 0;
+	bool m_batch_res = false;
+
 	/** Event Parsing **/
 	std::unordered_set<std::string> m_parse_event_sources;
 	libsinsp::events::set<ppm_event_code> m_parse_event_codes;
@@ -42,6 +42,12 @@ sinsp_filter_check_plugin::sinsp_filter_check_plugin(const sinsp_filter_check_pl
 	m_compatible_plugin_sources_bitmap = p.m_compatible_plugin_sources_bitmap;
 }
 
+sinsp_filter_check_plugin::~sinsp_filter_check_plugin() {
+	if(m_batch_slot != SIZE_MAX) {
+		m_eplugin->remove_batch_field(m_batch_slot);
+	}
+}
+
 int32_t sinsp_filter_check_plugin::parse_field_name(std::string_view val,
                                                     bool alloc_state,
                                                     bool needed_for_filtering) {
@@ -111,15 +117,41 @@ int32_t sinsp_filter_check_plugin::parse_field_name(std::string_view val,
 			                      m_field->m_name +
 			                      string(" requires an argument but none provided"));
 		}
+
+		// the fields of the checks actually used are extracted together
+		if(alloc_state && m_eplugin) {
+			if(m_batch_slot != SIZE_MAX) {
+				m_eplugin->remove_batch_field(m_batch_slot);
+			}
+			m_batch_slot = m_eplugin->add_batch_field(get_extract_field());
+		}
 	}
 
 	return res;
 }
 
+ss_plugin_extract_field sinsp_filter_check_plugin::get_extract_field() const {
+	// note: use non-transformed type, we'll apply transformations later on
+	ss_plugin_extract_field efield = {};
+	efield.field_id = m_field_id;
+	efield.field = m_info->m_fields[m_field_id].m_name.c_str();
+	efield.arg_key = m_arg_key;
+	efield.arg_index = m_arg_index;
+	efield.arg_present = m_arg_present;
+	efield.ftype = sinsp_filter_check::get_field_info()->m_type;
+	efield.flist = m_info->m_fields[m_field_id].m_flags & EPF_IS_LIST;
+	return efield;
+}
+
 std::unique_ptr<sinsp_filter_check> sinsp_filter_check_plugin::allocate_new() {
 	return std::make_unique<sinsp_filter_check_plugin>(*this);
 }
 
+uint32_t sinsp_filter_check_plugin::get_extract_cost() const {
+	// the extraction goes through the plugin API
+	return 16;
+}
+
 bool sinsp_filter_check_plugin::extract_nocache(sinsp_evt* evt,
                                                 std::vector<extract_value_t>& values,
                                                 bool sanitize_strings) {
@@ -149,50 +181,48 @@ bool sinsp_filter_check_plugin::extract_nocache(sinsp_evt* evt,
 		return false;
 	}
 
-	// note: use non-transformed type, we'll apply transformations later on
-	auto type = sinsp_filter_check::get_field_info()->m_type;
-
-	// here we want to extract just one field
-	uint32_t num_fields = 1;
-
-	// populate the field to extract for the plugin
-	ss_plugin_extract_field efield;
-	efield.field_id = m_field_id;
-	efield.field = m_info->m_fields[m_field_id].m_name.c_str();
-	efield.arg_key = m_arg_key;
-	efield.arg_index = m_arg_index;
-	efield.arg_present = m_arg_present;
-	efield.ftype = type;
-	efield.flist = m_info->m_fields[m_field_id].m_flags & EPF_IS_LIST;
-	if(!m_eplugin->extract_fields(evt, num_fields, &efield) || efield.res_len == 0) {
+	// the field is extracted together with the other ones of the plugin,
+	// or alone if it's not in the batch
+	ss_plugin_extract_field single;
+	const ss_plugin_extract_field* efield = &single;
+	if(m_batch_slot != SIZE_MAX) {
+		efield = m_eplugin->extract_batch_field(evt, m_batch_slot);
+	} else {
+		single = get_extract_field();
+		if(!m_eplugin->extract_fields(evt, 1, &single)) {
+			efield = nullptr;
+		}
+	}
+	if(efield == nullptr || efield->res_len == 0) {
 		return false;
 	}
 
+	auto type = (ppm_param_type)efield->ftype;
 	values.clear();
-	for(uint32_t i = 0; i < efield.res_len; ++i) {
+	for(uint32_t i = 0; i < efield->res_len; ++i) {
 		extract_value_t res;
 		switch(type) {
 		case PT_UINT64:
 		case PT_RELTIME:
 		case PT_ABSTIME: {
 			res.len = sizeof(uint64_t);
-			res.ptr = (uint8_t*)&efield.res.u64[i];
+			res.ptr = (uint8_t*)&efield->res.u64[i];
 			break;
 		}
 		case PT_IPADDR:
 		case PT_IPNET: {
-			res.len = (uint32_t)efield.res.buf[i].len;
-			res.ptr = (uint8_t*)efield.res.buf[i].ptr;
+			res.len = (uint32_t)efield->res.buf[i].len;
+			res.ptr = (uint8_t*)efield->res.buf[i].ptr;
 			break;
 		}
 		case PT_CHARBUF: {
-			res.len = strlen(efield.res.str[i]);
-			res.ptr = (uint8_t*)efield.res.str[i];
+			res.len = strlen(efield->res.str[i]);
+			res.ptr = (uint8_t*)efield->res.str[i];
 			break;
 		}
 		case PT_BOOL: {
 			res.len = sizeof(ss_plugin_bool);
-			res.ptr = (uint8_t*)&efield.res.boolean[i];
+			res.ptr = (uint8_t*)&efield->res.boolean[i];
 			break;
 		}
 		default:
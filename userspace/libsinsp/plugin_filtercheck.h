@@ -38,7 +38,7 @@ public:
 
 	explicit sinsp_filter_check_plugin(const sinsp_filter_check_plugin& p);
 
-	virtual ~sinsp_filter_check_plugin() = default;
+	virtual ~sinsp_filter_check_plugin();
 
 	std::unique_ptr<sinsp_filter_check> allocate_new() override;
 
@@ -46,6 +46,8 @@ public:
 	                         bool alloc_state,
 	                         bool needed_for_filtering) override;
 
+	uint32_t get_extract_cost() const override;
+
 protected:
 	bool extract_nocache(sinsp_evt* evt,
 	                     std::vector<extract_value_t>& values,
@@ -62,6 +64,10 @@ private:
 	std::vector<bool> m_compatible_plugin_sources_bitmap;
 	std::shared_ptr<sinsp_plugin> m_eplugin;
 
+	// The slot of the field in the batch of the ones extracted together
+	// by the plugin, if added to it
+	size_t m_batch_slot = SIZE_MAX;
+
 	// extract_arg_index() extracts a valid index from the argument if
 	// format is valid, otherwise it throws an exception.
 	// `full_field_name` has the format "field[argument]" and it is necessary
@@ -71,4 +77,7 @@ private:
 	// extract_arg_key() extracts a valid string from the argument. If we pass
 	// a numeric argument, it will be converted to string.
 	void extract_arg_key();
+
+	// returns the description of the field to extract for the plugin
+	ss_plugin_extract_field get_extract_field() const;
 };
@@ -20,11 +20,14 @@ limitations under the License.
 
 #include <string.h>
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <list>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include <libsinsp/filter_value.h>
 #include <libsinsp/utils.h>
@@ -35,6 +38,54 @@ typedef std::list<std::string> filter_components_t;
 // Split path /var/log/messages into a list of components (var, log, messages). Empty components are
 // skipped.
 void split_path(const filter_value_t &path, filter_components_t &components);
+
+// Walks the components of a path like split_path does, after an initial "root"
+// component, without copying them.
+class path_cursor {
+public:
+	explicit path_cursor(const filter_value_t &path):
+	        m_cur("root"),
+	        m_next((const char *)path.first),
+	        m_end((const char *)path.first + path.second) {}
+
+	bool at_end() const { return m_cur.data() == nullptr; }
+	std::string_view get() const { return m_cur; }
+
+	void next() {
+		while(m_next < m_end && *m_next == '/') {
+			m_next++;
+		}
+		if(m_next >= m_end) {
+			m_cur = std::string_view();
+			return;
+		}
+		const char *sep = (const char *)memchr(m_next, '/', m_end - m_next);
+		const char *comp_end = sep ? sep : m_end;
+		m_cur = std::string_view(m_next, comp_end - m_next);
+		m_next = comp_end;
+	}
+
+private:
+	std::string_view m_cur;
+	const char *m_next;
+	const char *m_end;
+};
+
+// Walks a list of components that was split by the caller.
+class components_cursor {
+public:
+	explicit components_cursor(const filter_components_t &components):
+	        m_cur(components.begin()),
+	        m_end(components.end()) {}
+
+	bool at_end() const { return m_cur == m_end; }
+	std::string_view get() const { return *m_cur; }
+	void next() { m_cur++; }
+
+private:
+	filter_components_t::const_iterator m_cur;
+	filter_components_t::const_iterator m_end;
+};
 };  // namespace path_prefix_map_ut
 
 //
@@ -53,6 +104,11 @@ void split_path(const filter_value_t &path, filter_components_t &components);
 // - search(/var, [/var/run, /etc, /lib, /usr/lib])
 //         does not succeed because no path is a prefix of /var
 //         /var is a partial match but the search path is /var/run, not /var.
+//
+// The search paths are kept in a tree of maps, one per path component,
+// which is compiled into a single flat table on the first match after
+// a change. Matching walks the table with views on the components of
+// the path and does not allocate.
 
 template<class Value>
 class path_prefix_map {
@@ -81,6 +137,48 @@ public:
 	std::string as_string(bool include_vals);
 
 private:
+	static constexpr uint32_t NO_CHILD = UINT32_MAX;
+
+	// A step from a node of the compiled tree. Like the entries of
+	// m_dirs, it either leads to another node or terminates a path.
+	struct compiled_edge {
+		uint32_t child;
+		Value *value;
+	};
+
+	struct edge_key {
+		uint32_t node;
+		std::string_view name;
+
+		bool operator==(const edge_key &other) const {
+			return node == other.node && name == other.name;
+		}
+	};
+
+	struct edge_key_hash {
+		size_t operator()(const edge_key &k) const {
+			return std::hash<std::string_view>()(k.name) ^ (k.node * 0x9e3779b97f4a7c15ULL);
+		}
+	};
+
+	// The names point to the keys of m_dirs and m_glob_dirs, which
+	// is why any change to the tree throws the compiled one away.
+	struct compiled_tree {
+		std::unordered_map<edge_key, compiled_edge, edge_key_hash> edges;
+
+		// For each node, its range of glob_edges
+		std::vector<std::pair<uint32_t, uint32_t>> globs;
+		std::vector<std::pair<const char *, compiled_edge>> glob_edges;
+	};
+
+	uint32_t compile(compiled_tree &tree) const;
+
+	template<class Cursor>
+	Value *match_node(uint32_t node, Cursor comp);
+
+	template<class Cursor>
+	Value *check_match_edge(const compiled_edge &edge, Cursor comp);
+
 	std::string as_string(const std::string &prefix, bool include_vals);
 	std::string as_string(const std::string &prefix,
 	                      bool include_vals,
@@ -101,18 +199,6 @@ private:
 	                                Value &v,
 	                                path_map_t &dirs);
 
-	Value *match_components(const path_prefix_map_ut::filter_components_t &components,
-	                        path_prefix_map_ut::filter_components_t::const_iterator comp);
-
-	Value *match_components_direct(const path_prefix_map_ut::filter_components_t &components,
-	                               path_prefix_map_ut::filter_components_t::const_iterator comp);
-
-	Value *match_components_glob(const path_prefix_map_ut::filter_components_t &components,
-	                             path_prefix_map_ut::filter_components_t::const_iterator comp);
-
-	Value *check_match_value(std::pair<path_prefix_map *, Value *> &val,
-	                         const path_prefix_map_ut::filter_components_t &components,
-	                         path_prefix_map_ut::filter_components_t::const_iterator comp);
 
 	// This is used *only* for components that do not contain glob
 	// characters.
@@ -137,6 +223,10 @@ private:
 	// the lookup is done by iterating over the keys and doing
 	// sinsp_utils::glob_match for each.
 	path_map_t m_glob_dirs;
+
+	// Only set in the top-level map, built on the first match
+	// after a change.
+	std::unique_ptr<compiled_tree> m_compiled;
 };
 
 template<class Value>
@@ -186,6 +276,7 @@ template<class Value>
 void path_prefix_map<Value>::add_search_path_components(
         const path_prefix_map_ut::filter_components_t &components,
         Value &v) {
+	m_compiled.reset();
 	add_search_path_components(components, components.begin(), v);
 }
 
@@ -263,58 +354,97 @@ Value *path_prefix_map<Value>::match(const char *path) {
 
 template<class Value>
 Value *path_prefix_map<Value>::match(const filter_value_t &path) {
-	path_prefix_map_ut::filter_components_t components;
-
-	path_prefix_map_ut::split_path(path, components);
-
-	// Add an initial "root" to the set of components. That
-	// ensures that a top-level path of '/' still results in a
-	// non-empty components list. For all other paths, there will
-	// be a dummy 'root' prefix at the top of every path.
-	components.emplace_front("root");
+	if(!m_compiled) {
+		m_compiled = std::make_unique<compiled_tree>();
+		compile(*m_compiled);
+	}
 
-	return match_components(components);
+	// The cursor starts on the "root" component all the search
+	// paths have been added under.
+	return match_node(0, path_prefix_map_ut::path_cursor(path));
 }
 
 template<class Value>
 Value *path_prefix_map<Value>::match_components(
         const path_prefix_map_ut::filter_components_t &components) {
-	return match_components(components, components.begin());
+	if(!m_compiled) {
+		m_compiled = std::make_unique<compiled_tree>();
+		compile(*m_compiled);
+	}
+
+	return match_node(0, path_prefix_map_ut::components_cursor(components));
 }
 
 template<class Value>
-Value *path_prefix_map<Value>::match_components(
-        const path_prefix_map_ut::filter_components_t &components,
-        path_prefix_map_ut::filter_components_t::const_iterator comp) {
-	Value *ret = match_components_direct(components, comp);
+uint32_t path_prefix_map<Value>::compile(compiled_tree &tree) const {
+	uint32_t node = tree.globs.size();
+
+	// Add all the glob edges of the node before the ones of its
+	// children, so that they stay contiguous.
+	uint32_t first_glob = tree.glob_edges.size();
+	tree.globs.emplace_back(first_glob, first_glob + m_glob_dirs.size());
+	for(auto &it : m_glob_dirs) {
+		tree.glob_edges.emplace_back(it.first.c_str(), compiled_edge{NO_CHILD, it.second.second});
+	}
+
+	uint32_t i = first_glob;
+	for(auto &it : m_glob_dirs) {
+		if(it.second.first != NULL) {
+			uint32_t child = it.second.first->compile(tree);
+			tree.glob_edges[i].second.child = child;
+		}
+		i++;
+	}
 
-	if(ret != NULL) {
-		return ret;
+	for(auto &it : m_dirs) {
+		compiled_edge edge{NO_CHILD, it.second.second};
+		if(it.second.first != NULL) {
+			edge.child = it.second.first->compile(tree);
+		}
+		tree.edges.emplace(edge_key{node, it.first}, edge);
 	}
 
-	return match_components_glob(components, comp);
+	return node;
 }
 
 template<class Value>
-Value *path_prefix_map<Value>::match_components_direct(
-        const path_prefix_map_ut::filter_components_t &components,
-        path_prefix_map_ut::filter_components_t::const_iterator comp) {
-	auto it = m_dirs.find(*comp);
+template<class Cursor>
+Value *path_prefix_map<Value>::match_node(uint32_t node, Cursor comp) {
+	if(comp.at_end()) {
+		return NULL;
+	}
+
+	auto it = m_compiled->edges.find(edge_key{node, comp.get()});
+	if(it != m_compiled->edges.end()) {
+		Value *v = check_match_edge(it->second, comp);
+		if(v != NULL) {
+			return v;
+		}
+	}
 
-	if(it == m_dirs.end()) {
+	auto globs = m_compiled->globs[node];
+	if(globs.first == globs.second) {
 		return NULL;
+	}
+
+	// glob_match() wants a NUL-terminated string. Path components
+	// are short, so this only allocates for unusual ones.
+	char buf[256];
+	std::string long_name;
+	const char *name = buf;
+	std::string_view comp_name = comp.get();
+	if(comp_name.size() < sizeof(buf)) {
+		memcpy(buf, comp_name.data(), comp_name.size());
+		buf[comp_name.size()] = '\0';
 	} else {
-		return check_match_value(it->second, components, ++comp);
+		long_name = comp_name;
+		name = long_name.c_str();
 	}
-}
 
-template<class Value>
-Value *path_prefix_map<Value>::match_components_glob(
-        const path_prefix_map_ut::filter_components_t &components,
-        path_prefix_map_ut::filter_components_t::const_iterator comp) {
-	for(auto &it : m_glob_dirs) {
-		if(sinsp_utils::glob_match(it.first.c_str(), comp->c_str(), false)) {
-			Value *v = check_match_value(it.second, components, ++comp);
+	for(uint32_t i = globs.first; i < globs.second; i++) {
+		const auto &glob = m_compiled->glob_edges[i];
+		if(sinsp_utils::glob_match(glob.first, name, false)) {
+			Value *v = check_match_edge(glob.second, comp);
 			if(v != NULL) {
 				return v;
 			}
@@ -325,25 +455,25 @@ Value *path_prefix_map<Value>::match_components_glob(
 }
 
 template<class Value>
-Value *path_prefix_map<Value>::check_match_value(
-        std::pair<path_prefix_map *, Value *> &val,
-        const path_prefix_map_ut::filter_components_t &components,
-        path_prefix_map_ut::filter_components_t::const_iterator comp) {
+template<class Cursor>
+Value *path_prefix_map<Value>::check_match_edge(const compiled_edge &edge, Cursor comp) {
+	comp.next();
+
 	// If there is nothing left in the match path, the
 	// subtree must be null. This ensures that /var
 	// matches only /var and not /var/lib
-	if(comp == components.end()) {
-		if(val.first == NULL) {
-			return val.second;
+	if(comp.at_end()) {
+		if(edge.child == NO_CHILD) {
+			return edge.value;
 		} else {
 			return NULL;
 		}
-	} else if(val.first == NULL) {
+	} else if(edge.child == NO_CHILD) {
 		// /foo/bar matched a prefix /foo, so we're
 		// done.
-		return val.second;
+		return edge.value;
 	} else {
-		return val.first->match_components(components, comp);
+		return match_node(edge.child, comp);
 	}
 }
 
@@ -122,6 +122,12 @@ sinsp::sinsp(bool with_metrics):
 
 	m_proc_scan_timeout_ms = SCAP_PROC_SCAN_TIMEOUT_NONE;
 	m_proc_scan_log_interval_ms = SCAP_PROC_SCAN_LOG_NONE;
+	m_proc_scan_num_threads = 0;
+	m_proc_scan_lazy_fds = false;
+	m_driver_wakeup_watermark = 0;
+	m_savefile_mmap = false;
+	m_savefile_start_ts = 0;
+	m_savefile_start_evt_num = 0;
 
 	m_replay_scap_evt = NULL;
 
@@ -312,6 +318,8 @@ void sinsp::open_common(scap_open_args* oargs,
 	oargs->log_fn = &sinsp_scap_log_fn;
 	oargs->proc_scan_timeout_ms = m_proc_scan_timeout_ms;
 	oargs->proc_scan_log_interval_ms = m_proc_scan_log_interval_ms;
+	oargs->proc_scan_num_threads = m_proc_scan_num_threads;
+	oargs->proc_scan_lazy_fds = m_proc_scan_lazy_fds;
 
 	m_h = scap_alloc();
 	if(m_h == NULL) {
@@ -446,6 +454,7 @@ void sinsp::open_bpf(const std::string& bpf_path,
 	scap_bpf_engine_params params;
 	params.buffer_bytes_dim = driver_buffer_bytes_dim;
 	params.bpf_probe = bpf_path.data();
+	params.wakeup_watermark = m_driver_wakeup_watermark;
 	oargs.engine_params = &params;
 
 	scap_platform* platform = scap_linux_alloc_platform(::on_new_entry_from_proc, this);
@@ -506,6 +515,70 @@ void sinsp::open_savefile(const std::string& filename, int fd) {
 
 	params.start_offset = 0;
 	params.fbuffer_size = 0;
+	params.fnames = NULL;
+	params.nfnames = 0;
+	params.segment_offsets = NULL;
+	params.nsegments = 0;
+	params.num_workers = 0;
+	params.use_mmap = m_savefile_mmap;
+	params.start_ts = m_savefile_start_ts;
+	params.start_evt_num = m_savefile_start_evt_num;
+	params.index_fname =
+	        m_savefile_index_filename.empty() ? NULL : m_savefile_index_filename.c_str();
+	oargs.engine_params = &params;
+
+	scap_platform* platform = scap_savefile_alloc_platform(::on_new_entry_from_proc, this);
+	params.platform = platform;
+	open_common(&oargs, &scap_savefile_engine, platform, SINSP_MODE_CAPTURE);
+#else
+	throw sinsp_exception("SAVEFILE engine is not supported in this build");
+#endif
+}
+
+void sinsp::open_savefiles(const std::vector<std::string>& filenames,
+                           uint32_t num_workers,
+                           const std::vector<uint64_t>& segment_offsets) {
+#ifdef HAS_ENGINE_SAVEFILE
+	scap_open_args oargs{};
+	scap_savefile_engine_params params{};
+
+	if(filenames.empty()) {
+		throw sinsp_exception(
+		        "When you use the 'savefile' engine you need to provide a path to the file.");
+	}
+
+	if(filenames.size() > 1 && !segment_offsets.empty()) {
+		throw sinsp_exception("segments can only split a single capture file");
+	}
+
+	m_input_filename = filenames[0];
+	m_input_fd = 0;
+
+	std::vector<const char*> fnames;
+	m_filesize = 0;
+	for(const auto& filename : filenames) {
+		char error[SCAP_LASTERR_SIZE] = {0};
+		int64_t size = get_file_size(filename, error);
+		if(size < 0) {
+			throw sinsp_exception(error);
+		}
+		m_filesize += size;
+		fnames.push_back(filename.c_str());
+	}
+
+	params.fname = fnames[0];
+	if(fnames.size() > 1) {
+		params.fnames = fnames.data();
+		params.nfnames = fnames.size();
+	}
+	params.segment_offsets = segment_offsets.data();
+	params.nsegments = segment_offsets.size();
+	params.num_workers = num_workers;
+	params.use_mmap = m_savefile_mmap;
+	params.start_ts = m_savefile_start_ts;
+	params.start_evt_num = m_savefile_start_evt_num;
+	params.index_fname =
+	        m_savefile_index_filename.empty() ? NULL : m_savefile_index_filename.c_str();
 	oargs.engine_params = &params;
 
 	scap_platform* platform = scap_savefile_alloc_platform(::on_new_entry_from_proc, this);
@@ -596,6 +669,7 @@ void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim,
 	params.buffer_bytes_dim = driver_buffer_bytes_dim;
 	params.cpus_for_each_buffer = cpus_for_each_buffer;
 	params.allocate_online_only = online_only;
+	params.wakeup_watermark = m_driver_wakeup_watermark;
 	oargs.engine_params = &params;
 
 	scap_platform* platform = scap_linux_alloc_platform(::on_new_entry_from_proc, this);
@@ -713,6 +787,8 @@ void sinsp::close() {
 
 	m_is_dumping = false;
 
+	m_delayed_scap_evt.reset();
+
 	deinit_state();
 
 	m_filter.reset();
@@ -873,7 +949,7 @@ void sinsp::on_new_entry_from_proc(void* context,
 			}
 		}
 
-		sinsp_tinfo->add_fd_from_scap(fdinfo);
+		sinsp_tinfo->add_fd_from_scap(fdinfo, m_proc_scan_lazy_fds && is_live());
 	}
 }
 
@@ -1088,6 +1164,34 @@ int32_t sinsp::fetch_next_event(sinsp_evt*& evt) {
 }
 
 int32_t sinsp::next(sinsp_evt** puevt) {
+	return next_event(puevt, true);
+}
+
+int32_t sinsp::next_batch(uint32_t max_events, const std::function<void(sinsp_evt*)>& cb) {
+	int32_t res = SCAP_SUCCESS;
+
+	m_delayed_scap_evt.m_batch_size = max_events;
+	for(uint32_t i = 0; i < max_events; i++) {
+		// don't wait for new events from libscap in the middle of a batch
+		if(i > 0 && m_delayed_scap_evt.empty() && m_delayed_scap_evt.batch_empty()) {
+			break;
+		}
+
+		sinsp_evt* evt;
+		res = next_event(&evt, i == 0);
+		if(res == SCAP_SUCCESS) {
+			cb(evt);
+		} else if(res != SCAP_FILTERED_EVENT) {
+			break;
+		}
+		res = SCAP_SUCCESS;
+	}
+	m_delayed_scap_evt.m_batch_size = 1;
+
+	return res;
+}
+
+int32_t sinsp::next_event(sinsp_evt** puevt, bool housekeeping) {
 	*puevt = NULL;
 	sinsp_evt* evt = &m_evt;
 
@@ -1146,7 +1250,7 @@ int32_t sinsp::next(sinsp_evt** puevt) {
 	//
 	// If required, retrieve the processes cpu from the kernel
 	//
-	if(m_get_procs_cpu_from_driver && is_live()) {
+	if(housekeeping && m_get_procs_cpu_from_driver && is_live()) {
 		get_procs_cpu_from_driver(ts);
 	}
 
@@ -1169,12 +1273,12 @@ int32_t sinsp::next(sinsp_evt** puevt) {
 			m_tid_to_remove = -1;
 		}
 
-		if(!is_offline()) {
+		if(housekeeping && !is_offline()) {
 			m_thread_manager->remove_inactive_threads();
 		}
 	}
 
-	if(m_auto_stats_print && is_debug_enabled() && is_live()) {
+	if(housekeeping && m_auto_stats_print && is_debug_enabled() && is_live()) {
 		if(ts > m_next_stats_print_time_ns) {
 			if(m_next_stats_print_time_ns) {
 				print_capture_stats(sinsp_logger::SEV_DEBUG);
@@ -1184,11 +1288,11 @@ int32_t sinsp::next(sinsp_evt** puevt) {
 		}
 	}
 
-	if(m_auto_containers_purging && !is_offline()) {
+	if(housekeeping && m_auto_containers_purging && !is_offline()) {
 		m_container_manager.remove_inactive_containers();
 	}
 
-	if(m_auto_usergroups_purging && !is_offline()) {
+	if(housekeeping && m_auto_usergroups_purging && !is_offline()) {
 		m_usergroup_manager.clear_host_users_groups();
 	}
 
@@ -1748,6 +1852,30 @@ void sinsp::set_proc_scan_log_interval_ms(uint64_t val) {
 	m_proc_scan_log_interval_ms = val;
 }
 
+void sinsp::set_proc_scan_num_threads(uint32_t val) {
+	m_proc_scan_num_threads = val;
+}
+
+void sinsp::set_proc_scan_lazy_fds(bool val) {
+	m_proc_scan_lazy_fds = val;
+}
+
+void sinsp::set_driver_wakeup_watermark(uint32_t val) {
+	m_driver_wakeup_watermark = val;
+}
+
+void sinsp::set_savefile_mmap(bool val) {
+	m_savefile_mmap = val;
+}
+
+void sinsp::set_savefile_start(uint64_t ts,
+                               uint64_t evt_num,
+                               const std::string& index_filename) {
+	m_savefile_start_ts = ts;
+	m_savefile_start_evt_num = evt_num;
+	m_savefile_index_filename = index_filename;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Note: this is defined here so we can inline it in sinso::next
 ///////////////////////////////////////////////////////////////////////////////
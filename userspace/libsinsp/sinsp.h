@@ -76,6 +76,7 @@ limitations under the License.
 #include <libsinsp/user.h>
 #include <libsinsp/utils.h>
 
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -174,6 +175,22 @@ public:
 	                      const libsinsp::events::set<ppm_sc_code>& ppm_sc_of_interest = {});
 	virtual void open_nodriver(bool full_proc_scan = false);
 	virtual void open_savefile(const std::string& filename, int fd = 0);
+	/*!
+	  \brief Open a capture made of several files, e.g. the rotation of a
+	  sinsp_cycledumper, or a single file split into segments, and decode it on a
+	  pool of threads. The events of the files or segments are merged back in
+	  timestamp order. Only the tables of the first file are loaded.
+
+	  \param filenames The files of the capture.
+	  \param num_workers The number of decoding threads.
+	  \param segment_offsets With a single file, the offsets of the event blocks
+	   that start a new segment, see sinsp_dumper::next_write_position().
+	   Compressed files can only be seeked by decompressing them from the start,
+	   so segments are meant for uncompressed captures.
+	*/
+	virtual void open_savefiles(const std::vector<std::string>& filenames,
+	                            uint32_t num_workers,
+	                            const std::vector<uint64_t>& segment_offsets = {});
 	virtual void open_plugin(const std::string& plugin_name,
 	                         const std::string& plugin_open_params,
 	                         sinsp_plugin_platform platform_type);
@@ -220,6 +237,29 @@ public:
 	*/
 	virtual int32_t next(sinsp_evt** evt);
 
+	/*!
+	  \brief Process up to max_events events from the open capture source,
+	  calling cb on each of them.
+
+	  Events are fetched from libscap in batches (see scap_next_batch) and the
+	  periodic housekeeping that \ref next() runs for every event (purging of
+	  inactive threads, containers and users, collection of the processes CPU
+	  usage, stats printing) runs once per batch. The batch ends early when all
+	  the events fetched from libscap have been processed.
+
+	  \param max_events the maximum number of events to process.
+	  \param cb called on every event that \ref next() would return with
+	   SCAP_SUCCESS. The event can be considered valid only until cb returns.
+
+	  \return SCAP_SUCCESS if the batch ended normally, otherwise the first
+	   result other than SCAP_SUCCESS and SCAP_FILTERED_EVENT that \ref next()
+	   would have returned. Events processed before that were already passed
+	   to cb.
+
+	  \note: it can be freely interleaved with \ref next().
+	*/
+	int32_t next_batch(uint32_t max_events, const std::function<void(sinsp_evt*)>& cb);
+
 	/*!
 	  \brief Get the maximum number of bytes currently in use by any CPU buffer
 	 */
@@ -436,6 +476,49 @@ public:
 	 */
 	void set_proc_scan_log_interval_ms(uint64_t val);
 
+	/*!
+	 * \brief sets the number of threads exploring /proc during the initial scan. The
+	 *        results are merged in /proc order, so the thread table is the same as with
+	 *        a serial scan. Value of 0 (default) or 1 means a serial scan.
+	 */
+	void set_proc_scan_num_threads(uint32_t val);
+
+	/*!
+	 * \brief when true, the initial scan of /proc only records the number and the type of
+	 *        every fd, and their details are read from /proc the first time they are
+	 *        accessed. Only applies to live captures. Value of false (default) reads them
+	 *        all during the scan.
+	 */
+	void set_proc_scan_lazy_fds(bool val);
+
+	/*!
+	 * \brief sets the number of bytes that must be pending in a driver buffer to wake up
+	 *        the consumer. When not 0 the bpf and modern_bpf engines block on their
+	 *        buffers instead of sleeping with an exponential backoff when they are empty.
+	 *        Value of 0 (default) keeps the sleep backoff. Must be called before opening.
+	 */
+	void set_driver_wakeup_watermark(uint32_t val);
+
+	/*!
+	 * \brief when true, uncompressed capture files are mapped in memory and their events
+	 *        are parsed where they are, without copying them to a read buffer. Compressed
+	 *        files are read as usual. Value of false (default) reads every file through zlib.
+	 *        Must be called before opening.
+	 */
+	void set_savefile_mmap(bool val);
+
+	/*!
+	 * \brief makes the capture files opened next start at their first event with a
+	 *        timestamp of at least ts, preceded by at least evt_num events. Value of 0
+	 *        (default) for both reads them from the beginning. If index_filename is the
+	 *        index written by sinsp_dumper::set_index() for the file, reading starts from
+	 *        the closest checkpoint instead. The state is the one saved at the beginning
+	 *        of the file. Must be called before opening.
+	 */
+	void set_savefile_start(uint64_t ts,
+	                        uint64_t evt_num = 0,
+	                        const std::string& index_filename = "");
+
 	/*!
 	  \brief Returns a new instance of a filtercheck supporting fields for
 	  a generic event source (e.g. evt.num, evt.time, evt.pluginname...)
@@ -993,6 +1076,7 @@ private:
 	void import_ifaddr_list();
 	void import_user_list();
 	int32_t fetch_next_event(sinsp_evt*& evt);
+	int32_t next_event(sinsp_evt** puevt, bool housekeeping);
 
 	//
 	// Note: lookup_only should be used when the query for the thread is made
@@ -1163,9 +1247,38 @@ public:
 
 	// temp storage for scap_next
 	// stores top scap_evt while qualified events from m_async_events_queue are being processed
+	// and, when reading in batches, the scap events fetched by scap_next_batch and not
+	// processed yet
 	struct {
-		inline auto next(scap_t* h) {
-			auto res = scap_next(h, &m_pevt, &m_cpuid, &m_dump_flags);
+		inline int32_t next(scap_t* h) {
+			int32_t res;
+			if(m_batch_pos < m_batch_count) {
+				take_batched();
+				return SCAP_SUCCESS;
+			}
+
+			if(m_batch_size > 1) {
+				if(m_batch_evts.size() < m_batch_size) {
+					m_batch_evts.resize(m_batch_size);
+					m_batch_cpuids.resize(m_batch_size);
+					m_batch_dump_flags.resize(m_batch_size);
+				}
+				m_batch_pos = 0;
+				res = scap_next_batch(h,
+				                      m_batch_evts.data(),
+				                      m_batch_cpuids.data(),
+				                      m_batch_dump_flags.data(),
+				                      m_batch_size,
+				                      &m_batch_count);
+				if(res == SCAP_SUCCESS) {
+					take_batched();
+					return res;
+				}
+				m_batch_count = 0;
+			} else {
+				res = scap_next(h, &m_pevt, &m_cpuid, &m_dump_flags);
+			}
+
 			if(res != SCAP_SUCCESS) {
 				clear();
 			}
@@ -1178,15 +1291,35 @@ public:
 			clear();
 		}
 		inline bool empty() const { return m_pevt == nullptr; }
+		inline bool batch_empty() const { return m_batch_pos >= m_batch_count; }
 		inline void clear() {
 			m_pevt = nullptr;
 			m_cpuid = 0;
 			m_dump_flags = 0;
 		}
+		inline void reset() {
+			clear();
+			m_batch_pos = 0;
+			m_batch_count = 0;
+		}
+		inline void take_batched() {
+			m_pevt = m_batch_evts[m_batch_pos];
+			m_cpuid = m_batch_cpuids[m_batch_pos];
+			m_dump_flags = m_batch_dump_flags[m_batch_pos];
+			m_batch_pos++;
+		}
 
 		scap_evt* m_pevt{nullptr};
 		uint16_t m_cpuid{0};
 		uint32_t m_dump_flags;
+
+		// number of events requested to scap_next_batch, 1 means scap_next
+		uint32_t m_batch_size{1};
+		uint32_t m_batch_pos{0};
+		uint32_t m_batch_count{0};
+		std::vector<scap_evt*> m_batch_evts;
+		std::vector<uint16_t> m_batch_cpuids;
+		std::vector<uint32_t> m_batch_dump_flags;
 	} m_delayed_scap_evt;
 
 	//
@@ -1211,6 +1344,19 @@ public:
 	//
 	uint64_t m_proc_scan_timeout_ms;
 	uint64_t m_proc_scan_log_interval_ms;
+	uint32_t m_proc_scan_num_threads;
+	bool m_proc_scan_lazy_fds;
+
+	// Pending bytes that wake up the consumer of the driver buffers, 0 to sleep instead
+	uint32_t m_driver_wakeup_watermark;
+
+	// Map uncompressed capture files in memory instead of reading them
+	bool m_savefile_mmap;
+
+	// First event to read from capture files, and index to find it
+	uint64_t m_savefile_start_ts;
+	uint64_t m_savefile_start_evt_num;
+	std::string m_savefile_index_filename;
 
 	// Any thread with a comm in this set will not have its events
 	// returned in sinsp::next()
@@ -25,6 +25,8 @@ limitations under the License.
 
 #include <re2/re2.h>
 
+#include <charconv>
+
 #define STRPROPERTY_STORAGE_SIZE 1024
 
 std::string std::to_string(boolop b) {
@@ -493,6 +495,147 @@ Json::Value sinsp_filter_check::tojson(sinsp_evt* evt) {
 	return jsonval;
 }
 
+// Appends a quoted JSON string to out. Only plain ASCII strings are escaped
+// here, the other ones go through jsoncpp so that the result is the same as
+// the one of Json::FastWriter.
+static void json_append_string(std::string& out, const char* str, size_t len) {
+	for(size_t i = 0; i < len; i++) {
+		auto c = (unsigned char)str[i];
+		if(c < 0x20 || c >= 0x80) {
+			out += Json::valueToQuotedString(std::string(str, len).c_str());
+			return;
+		}
+	}
+
+	out += '"';
+	for(size_t i = 0; i < len; i++) {
+		if(str[i] == '"' || str[i] == '\\') {
+			out += '\\';
+		}
+		out += str[i];
+	}
+	out += '"';
+}
+
+// Appends a value serialized as Json::FastWriter would do
+static void json_append_value(std::string& out, const Json::Value& v) {
+	char buf[32];
+	switch(v.type()) {
+	case Json::nullValue:
+		out += "null";
+		break;
+	case Json::intValue:
+		out.append(buf, std::to_chars(buf, buf + sizeof(buf), v.asLargestInt()).ptr - buf);
+		break;
+	case Json::uintValue:
+		out.append(buf, std::to_chars(buf, buf + sizeof(buf), v.asLargestUInt()).ptr - buf);
+		break;
+	case Json::realValue:
+		out += Json::valueToString(v.asDouble());
+		break;
+	case Json::stringValue: {
+		const char* begin;
+		const char* end;
+		v.getString(&begin, &end);
+		json_append_string(out, begin, end - begin);
+		break;
+	}
+	case Json::booleanValue:
+		out += v.asBool() ? "true" : "false";
+		break;
+	case Json::arrayValue:
+		out += '[';
+		for(Json::ArrayIndex i = 0; i < v.size(); i++) {
+			if(i > 0) {
+				out += ',';
+			}
+			json_append_value(out, v[i]);
+		}
+		out += ']';
+		break;
+	case Json::objectValue: {
+		out += '{';
+		bool first = true;
+		for(const auto& name : v.getMemberNames()) {
+			if(!first) {
+				out += ',';
+			}
+			first = false;
+			json_append_string(out, name.data(), name.size());
+			out += ':';
+			json_append_value(out, v[name]);
+		}
+		out += '}';
+		break;
+	}
+	}
+}
+
+bool sinsp_filter_check::rawval_to_json(std::string& out,
+                                        uint8_t* rawval,
+                                        ppm_param_type ptype,
+                                        ppm_print_format print_format,
+                                        uint32_t len) {
+	switch(ptype) {
+	case PT_CHARBUF:
+	case PT_FSPATH:
+	case PT_BYTEBUF:
+	case PT_IPV4ADDR:
+	case PT_IPV6ADDR:
+	case PT_IPADDR:
+	case PT_IPNET:
+	case PT_FSRELPATH: {
+		// strings are written without copying them in a Json value
+		auto str = rawval_to_string(rawval, ptype, print_format, len);
+		json_append_string(out, str, strlen(str));
+		return true;
+	}
+	default: {
+		auto jsonval = rawval_to_json(rawval, ptype, print_format, len);
+		if(jsonval.isNull()) {
+			return false;
+		}
+		json_append_value(out, jsonval);
+		return true;
+	}
+	}
+}
+
+bool sinsp_filter_check::append_json(sinsp_evt* evt, std::string& out) {
+	uint32_t len;
+	Json::Value jsonval = extract_as_js(evt, &len);
+	if(jsonval != Json::nullValue) {
+		json_append_value(out, jsonval);
+		return true;
+	}
+
+	m_extracted_values.clear();
+	if(!extract(evt, m_extracted_values) || m_extracted_values.empty()) {
+		return false;
+	}
+
+	auto ftype = get_transformed_field_info()->m_type;
+	if(m_field->m_flags & EPF_IS_LIST) {
+		out += '[';
+		for(size_t i = 0; i < m_extracted_values.size(); i++) {
+			auto& val = m_extracted_values[i];
+			if(i > 0) {
+				out += ',';
+			}
+			if(!rawval_to_json(out, val.ptr, ftype, m_field->m_print_format, val.len)) {
+				out += "null";
+			}
+		}
+		out += ']';
+		return true;
+	}
+	return rawval_to_json(out,
+	                      m_extracted_values[0].ptr,
+	                      ftype,
+	                      m_field->m_print_format,
+	                      m_extracted_values[0].len);
+}
+
 int32_t sinsp_filter_check::parse_field_name(std::string_view str,
                                              bool alloc_state,
                                              bool needed_for_filtering) {
@@ -573,6 +716,24 @@ void sinsp_filter_check::add_filter_value(const char* str, uint32_t len, uint32_
 	m_vals[i] = item;
 
 	// populate operator-specific optimizations
+	if(m_cmpop == CO_IN || m_cmpop == CO_INTERSECTS || m_cmpop == CO_PMATCH) {
+		// networks can't be matched by value, so they get a trie of their own
+		switch(get_transformed_field_info()->m_type) {
+		case PT_IPV4NET:
+		case PT_IPV6NET:
+		case PT_IPNET:
+			ensure_unique_ptr_allocated(m_val_storages_nets);
+			if(parsed_len == sizeof(ipv4net)) {
+				m_val_storages_nets->add_network(*(ipv4net*)item.first);
+			} else if(parsed_len == sizeof(ipv6net)) {
+				m_val_storages_nets->add_network(*(ipv6net*)item.first);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
 	if(m_cmpop == CO_IN || m_cmpop == CO_INTERSECTS) {
 		// If the operator is IN or INTERSECTS, populate the map search
 		ensure_unique_ptr_allocated(m_val_storages_members);
@@ -723,6 +884,33 @@ size_t sinsp_filter_check::parse_filter_value(const char* str,
 	return parsed_len;
 }
 
+// Looks up an address in the networks of an 'in', 'intersects' or 'pmatch'
+// comparison. Returns false if the address can't be looked up in the trie, in
+// which case the values must be compared one by one.
+static inline bool match_networks(const net_prefix_search* nets,
+                                  ppm_param_type type,
+                                  const void* addr,
+                                  uint32_t len,
+                                  bool& found) {
+	if(nets == nullptr) {
+		return false;
+	}
+
+	if(type == PT_IPV4NET || (type == PT_IPNET && len == sizeof(uint32_t))) {
+		uint32_t v4;
+		memcpy(&v4, addr, sizeof(v4));
+		found = nets->match(v4);
+		return true;
+	}
+
+	if(type == PT_IPV6NET || (type == PT_IPNET && len == sizeof(ipv6addr))) {
+		found = nets->match(*(const ipv6addr*)addr);
+		return true;
+	}
+
+	return false;
+}
+
 bool sinsp_filter_check::compare_rhs(cmpop op,
                                      ppm_param_type type,
                                      std::vector<extract_value_t>& values) {
@@ -770,6 +958,12 @@ bool sinsp_filter_check::compare_rhs(cmpop op,
 				// of memcmp.
 				if(type == PT_IPNET) {
 					bool found = false;
+					if(match_networks(m_val_storages_nets.get(), type, it.ptr, it.len, found)) {
+						if(!found) {
+							return false;
+						}
+						continue;
+					}
 					for(const auto& m : m_vals) {
 						if(::flt_compare(CO_EQ, type, item.first, m.first, item.second, m.second)) {
 							found = true;
@@ -797,6 +991,13 @@ bool sinsp_filter_check::compare_rhs(cmpop op,
 				// todo(jasondellaluce): refactor filter_value_t to actually use flt_compare instead
 				// of memcmp.
 				if(type == PT_IPNET) {
+					bool found = false;
+					if(match_networks(m_val_storages_nets.get(), type, it.ptr, it.len, found)) {
+						if(found) {
+							return true;
+						}
+						continue;
+					}
 					for(const auto& m : m_vals) {
 						if(::flt_compare(CO_EQ, type, item.first, m.first, item.second, m.second)) {
 							return true;
@@ -863,11 +1064,17 @@ bool sinsp_filter_check::compare_rhs(cmpop op,
 	case CO_INTERSECTS: {
 		// Certain filterchecks can't be done as a set
 		// membership test/group match. For these, just loop over the
-		// values and see if any value is equal.
+		// values and see if any value is equal, unless they are
+		// networks that can be looked up in a trie.
+		bool found = false;
 		switch(type) {
 		case PT_IPV4NET:
 		case PT_IPV6NET:
 		case PT_IPNET:
+			if(match_networks(m_val_storages_nets.get(), type, operand1, op1_len, found)) {
+				return found;
+			}
+			// fallthrough
 		case PT_SOCKADDR:
 		case PT_SOCKTUPLE:
 		case PT_FDLIST:
@@ -979,6 +1186,44 @@ bool sinsp_filter_check::extract(sinsp_evt* evt,
 	return m_extract_cache->result();
 }
 
+uint32_t sinsp_filter_check::get_cost() const {
+	uint32_t cost = get_extract_cost() + m_transformers.size();
+	if(m_rhs_filter_check) {
+		cost += m_rhs_filter_check->get_extract_cost();
+	}
+
+	switch(m_cmpop) {
+	case CO_EXISTS:
+		break;
+	case CO_IN:
+	case CO_INTERSECTS:
+	case CO_PMATCH: {
+		// the values are looked up in a hash set or a prefix tree, except
+		// for the networks that are compared one by one
+		auto info = get_transformed_field_info();
+		cost += 2;
+		if(info && info->m_type == PT_IPNET) {
+			cost += m_vals.size();
+		}
+		break;
+	}
+	case CO_CONTAINS:
+	case CO_ICONTAINS:
+	case CO_BCONTAINS:
+	case CO_GLOB:
+	case CO_IGLOB:
+		cost += 2;
+		break;
+	case CO_REGEX:
+		cost += 8;
+		break;
+	default:
+		cost += 1;
+		break;
+	}
+	return cost;
+}
+
 bool sinsp_filter_check::compare(sinsp_evt* evt) {
 	if(m_cache_metrics != NULL) {
 		m_cache_metrics->m_num_compare++;
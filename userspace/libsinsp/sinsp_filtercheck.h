@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <libsinsp/filter_value.h>
 #include <libsinsp/prefix_search.h>
+#include <libsinsp/net_prefix_search.h>
 #include <libsinsp/event.h>
 #include <libsinsp/filter_compare.h>
 #include <libsinsp/filter_field.h>
@@ -123,6 +124,27 @@ public:
 	//
 	virtual bool has_transformers() const { return !m_transformers.empty(); }
 
+	//
+	// Return true if comparing the field takes more than comparing the
+	// values returned by extract() with the right-hand side ones, in which
+	// case its comparisons can't be merged with the ones of other checks
+	//
+	virtual bool has_custom_compare() const { return false; }
+
+	//
+	// Return an estimate of the relative cost of extracting the field, from
+	// 1 for the fields read from the event header to 16 for the ones that
+	// call into a plugin
+	//
+	virtual uint32_t get_extract_cost() const { return 2; }
+
+	//
+	// Return an estimate of the relative cost of evaluating the check, based
+	// on the cost of extracting the field, the comparison operator and the
+	// number of values to compare with
+	//
+	virtual uint32_t get_cost() const;
+
 	//
 	// Return the type of the current field after applying
 	// all the configured transformers
@@ -161,6 +183,13 @@ public:
 	//
 	virtual Json::Value tojson(sinsp_evt* evt);
 
+	//
+	// Extract the value from the event and append it to out serialized in
+	// JSON, as tojson() would return it, without building a Json value.
+	// Returns false if the field has no value, leaving out unchanged
+	//
+	virtual bool append_json(sinsp_evt* evt, std::string& out);
+
 	sinsp* m_inspector = nullptr;
 	std::vector<extract_value_t> m_extracted_values;
 	std::shared_ptr<sinsp_filter_compare_cache> m_compare_cache = nullptr;
@@ -209,6 +238,12 @@ protected:
 	                           ppm_print_format print_format,
 	                           uint32_t len);
 
+	bool rawval_to_json(std::string& out,
+	                    uint8_t* rawval,
+	                    ppm_param_type ptype,
+	                    ppm_print_format print_format,
+	                    uint32_t len);
+
 	inline uint8_t* filter_value_p(uint16_t i = 0) {
 		ASSERT(i < m_vals.size());
 		return m_vals[i].first;
@@ -246,6 +281,7 @@ private:
 	std::unique_ptr<std::unordered_set<filter_value_t, g_hash_membuf, g_equal_to_membuf>>
 	        m_val_storages_members;
 	std::unique_ptr<path_prefix_search> m_val_storages_paths;
+	std::unique_ptr<net_prefix_search> m_val_storages_nets;
 	uint32_t m_val_storages_min_size;
 	uint32_t m_val_storages_max_size;
 
@@ -1756,6 +1756,22 @@ uint8_t* sinsp_filter_check_event::extract_single(sinsp_evt* evt,
 	return NULL;
 }
 
+bool sinsp_filter_check_event::has_custom_compare() const {
+	return m_field_id == TYPE_ARGRAW || m_field_id == TYPE_AROUND;
+}
+
+uint32_t sinsp_filter_check_event::get_extract_cost() const {
+	switch(m_field_id) {
+	case TYPE_DIR:
+	case TYPE_TYPE:
+	case TYPE_SYSCALL_TYPE:
+	case TYPE_CPU:
+		return 1;
+	default:
+		return sinsp_filter_check::get_extract_cost();
+	}
+}
+
 bool sinsp_filter_check_event::compare_nocache(sinsp_evt* evt) {
 	bool res;
 
@@ -95,6 +95,8 @@ public:
 	                          uint32_t len,
 	                          uint8_t* storage,
 	                          uint32_t storage_len) override;
+	bool has_custom_compare() const override;
+	uint32_t get_extract_cost() const override;
 
 protected:
 	Json::Value extract_as_js(sinsp_evt*, uint32_t* len) override;
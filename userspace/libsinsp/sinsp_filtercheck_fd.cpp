@@ -1458,6 +1458,42 @@ bool sinsp_filter_check_fd::compare_net(sinsp_evt *evt) {
 		return true;
 	}
 
+	// all the networks of a list are looked up at once
+	if(m_cmpop == CO_IN) {
+		switch(m_fdinfo->m_type) {
+		case SCAP_FD_IPV4_SERVSOCK:
+			return compare_rhs(m_cmpop,
+			                   PT_IPNET,
+			                   &m_fdinfo->m_sockinfo.m_ipv4serverinfo.m_ip,
+			                   sizeof(uint32_t));
+		case SCAP_FD_IPV6_SERVSOCK:
+			return compare_rhs(m_cmpop,
+			                   PT_IPNET,
+			                   &m_fdinfo->m_sockinfo.m_ipv6serverinfo.m_ip,
+			                   sizeof(ipv6addr));
+		case SCAP_FD_IPV4_SOCK:
+			return compare_rhs(m_cmpop,
+			                   PT_IPNET,
+			                   &m_fdinfo->m_sockinfo.m_ipv4info.m_fields.m_sip,
+			                   sizeof(uint32_t)) ||
+			       compare_rhs(m_cmpop,
+			                   PT_IPNET,
+			                   &m_fdinfo->m_sockinfo.m_ipv4info.m_fields.m_dip,
+			                   sizeof(uint32_t));
+		case SCAP_FD_IPV6_SOCK:
+			return compare_rhs(m_cmpop,
+			                   PT_IPNET,
+			                   &m_fdinfo->m_sockinfo.m_ipv6info.m_fields.m_sip,
+			                   sizeof(ipv6addr)) ||
+			       compare_rhs(m_cmpop,
+			                   PT_IPNET,
+			                   &m_fdinfo->m_sockinfo.m_ipv6info.m_fields.m_dip,
+			                   sizeof(ipv6addr));
+		default:
+			return false;
+		}
+	}
+
 	bool sip_cmp = false;
 	bool dip_cmp = false;
 
@@ -1506,7 +1542,7 @@ bool sinsp_filter_check_fd::compare_net(sinsp_evt *evt) {
 		return false;
 	}
 
-	if(m_cmpop == CO_EQ || m_cmpop == CO_IN) {
+	if(m_cmpop == CO_EQ) {
 		return sip_cmp || dip_cmp;
 	}
 
@@ -1735,6 +1771,13 @@ bool sinsp_filter_check_fd::extract_fd(sinsp_evt *evt) {
 	return true;
 }
 
+bool sinsp_filter_check_fd::has_custom_compare() const {
+	return m_field_id == TYPE_IP || m_field_id == TYPE_PORT || m_field_id == TYPE_PROTO ||
+	       m_field_id == TYPE_NET || m_field_id == TYPE_CLIENTIP_NAME ||
+	       m_field_id == TYPE_SERVERIP_NAME || m_field_id == TYPE_LIP_NAME ||
+	       m_field_id == TYPE_RIP_NAME;
+}
+
 bool sinsp_filter_check_fd::compare_nocache(sinsp_evt *evt) {
 	//
 	// Some fields are filter only and therefore get a special treatment
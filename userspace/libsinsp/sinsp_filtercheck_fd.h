@@ -78,6 +78,7 @@ public:
 	int32_t parse_field_name(std::string_view,
 	                         bool alloc_state,
 	                         bool needed_for_filtering) override;
+	bool has_custom_compare() const override;
 
 protected:
 	bool extract_nocache(sinsp_evt*,
@@ -178,6 +178,11 @@ std::unique_ptr<sinsp_filter_check> sinsp_filter_check_gen_event::allocate_new()
 	return std::make_unique<sinsp_filter_check_gen_event>();
 }
 
+uint32_t sinsp_filter_check_gen_event::get_extract_cost() const {
+	// the plugin info is rendered by the plugin
+	return m_field_id == TYPE_PLUGININFO ? sinsp_filter_check::get_extract_cost() : 1;
+}
+
 Json::Value sinsp_filter_check_gen_event::extract_as_js(sinsp_evt* evt, uint32_t* len) {
 	switch(m_field_id) {
 	case TYPE_TIME:
@@ -47,6 +47,7 @@ public:
 	virtual ~sinsp_filter_check_gen_event() = default;
 
 	std::unique_ptr<sinsp_filter_check> allocate_new() override;
+	uint32_t get_extract_cost() const override;
 
 protected:
 	uint8_t* extract_single(sinsp_evt*, uint32_t* len, bool sanitize_strings = true) override;
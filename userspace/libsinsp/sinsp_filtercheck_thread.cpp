@@ -2211,6 +2211,36 @@ bool sinsp_filter_check_thread::compare_full_aenv(sinsp_evt* evt) {
 	return found;
 }
 
+bool sinsp_filter_check_thread::has_custom_compare() const {
+	switch(m_field_id) {
+	case TYPE_APID:
+	case TYPE_ANAME:
+	case TYPE_AEXE:
+	case TYPE_AEXEPATH:
+	case TYPE_ACMDLINE:
+		return m_argid == -1;
+	case TYPE_AENV:
+		return m_argname.empty();
+	default:
+		return false;
+	}
+}
+
+uint32_t sinsp_filter_check_thread::get_extract_cost() const {
+	// the ancestor fields walk the process tree
+	switch(m_field_id) {
+	case TYPE_APID:
+	case TYPE_ANAME:
+	case TYPE_AEXE:
+	case TYPE_AEXEPATH:
+	case TYPE_ACMDLINE:
+	case TYPE_AENV:
+		return 8;
+	default:
+		return sinsp_filter_check::get_extract_cost();
+	}
+}
+
 bool sinsp_filter_check_thread::compare_nocache(sinsp_evt* evt) {
 	if(m_field_id == TYPE_APID) {
 		if(m_argid == -1) {
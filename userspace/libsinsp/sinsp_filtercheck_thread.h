@@ -122,6 +122,8 @@ public:
 	                         bool needed_for_filtering) override;
 
 	int32_t get_argid() const;
+	bool has_custom_compare() const override;
+	uint32_t get_extract_cost() const override;
 
 protected:
 	uint8_t *extract_single(sinsp_evt *, uint32_t *len, bool sanitize_strings = true) override;
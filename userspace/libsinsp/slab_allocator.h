@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace libsinsp {
+
+/**
+ * \brief A pool of memory blocks of `Size` bytes, carved out of larger slabs.
+ *
+ * Each thread allocates from and frees into its own cache of blocks without
+ * locking. The caches exchange batches of blocks with a shared depot when they
+ * run empty or grow too large, and hand all their blocks back to it when their
+ * thread exits, so a block can be freed from any thread. Slabs are never given
+ * back to the system: the pool keeps the high-water mark of the blocks in use.
+ */
+template<size_t Size, size_t Align>
+class slab_pool {
+public:
+	static void* allocate() {
+		cache& c = local();
+		if(c.head == nullptr) {
+			refill(c);
+		}
+		node* n = c.head;
+		c.head = n->next;
+		c.count--;
+		if(c.dead) {
+			flush(c, c.count);
+		}
+		return n;
+	}
+
+	static void deallocate(void* p) noexcept {
+		cache& c = local();
+		node* n = static_cast<node*>(p);
+		n->next = c.head;
+		c.head = n;
+		c.count++;
+		if(c.dead || c.count >= 2 * BATCH_SIZE) {
+			flush(c, c.dead ? c.count : BATCH_SIZE);
+		}
+	}
+
+private:
+	struct node {
+		node* next;
+	};
+
+	static_assert(Align <= alignof(std::max_align_t), "over-aligned types are not supported");
+	static constexpr size_t BLOCK_SIZE =
+	        ((Size > sizeof(node) ? Size : sizeof(node)) + Align - 1) & ~(Align - 1);
+	static constexpr size_t BATCH_SIZE = 64;
+
+	// note: trivially destructible, so that it can still be used while the
+	// thread-local destructors run
+	struct cache {
+		node* head;
+		size_t count;
+		bool dead;
+	};
+
+	struct cache_flusher {
+		cache& m_cache;
+		~cache_flusher() {
+			m_cache.dead = true;
+			flush(m_cache, m_cache.count);
+		}
+	};
+
+	struct depot {
+		std::mutex m_lock;
+		node* m_head = nullptr;
+	};
+
+	static cache& local() {
+		static thread_local cache c = {nullptr, 0, false};
+		static thread_local cache_flusher f{c};
+		return c;
+	}
+
+	// note: never destroyed, blocks can be freed during static destruction
+	static depot& shared_depot() {
+		static depot* d = new depot();
+		return *d;
+	}
+
+	static void refill(cache& c) {
+		{
+			depot& d = shared_depot();
+			std::lock_guard<std::mutex> lock(d.m_lock);
+			while(d.m_head != nullptr && c.count < BATCH_SIZE) {
+				node* n = d.m_head;
+				d.m_head = n->next;
+				n->next = c.head;
+				c.head = n;
+				c.count++;
+			}
+		}
+		if(c.head != nullptr) {
+			return;
+		}
+
+		char* slab = static_cast<char*>(std::malloc(BLOCK_SIZE * BATCH_SIZE));
+		if(slab == nullptr) {
+			throw std::bad_alloc();
+		}
+		for(size_t i = 0; i < BATCH_SIZE; i++) {
+			node* n = reinterpret_cast<node*>(slab + i * BLOCK_SIZE);
+			n->next = c.head;
+			c.head = n;
+		}
+		c.count = BATCH_SIZE;
+	}
+
+	static void flush(cache& c, size_t count) noexcept {
+		depot& d = shared_depot();
+		std::lock_guard<std::mutex> lock(d.m_lock);
+		for(size_t i = 0; i < count && c.head != nullptr; i++) {
+			node* n = c.head;
+			c.head = n->next;
+			c.count--;
+			n->next = d.m_head;
+			d.m_head = n;
+		}
+	}
+};
+
+/**
+ * \brief Allocator drawing single objects of type T from a slab_pool. Mostly
+ * useful to pool the control blocks of std::shared_ptr.
+ */
+template<typename T>
+class slab_allocator {
+public:
+	using value_type = T;
+
+	slab_allocator() noexcept = default;
+
+	template<typename U>
+	slab_allocator(const slab_allocator<U>&) noexcept {}
+
+	T* allocate(size_t n) {
+		if(n != 1) {
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		return static_cast<T*>(slab_pool<sizeof(T), alignof(T)>::allocate());
+	}
+
+	void deallocate(T* p, size_t n) noexcept {
+		if(n != 1) {
+			::operator delete(p);
+			return;
+		}
+		slab_pool<sizeof(T), alignof(T)>::deallocate(p);
+	}
+
+	template<typename U>
+	friend bool operator==(const slab_allocator&, const slab_allocator<U>&) noexcept {
+		return true;
+	}
+
+	template<typename U>
+	friend bool operator!=(const slab_allocator&, const slab_allocator<U>&) noexcept {
+		return false;
+	}
+};
+
+/**
+ * \brief Helpers for the class-specific operator new and delete of T. Objects of
+ * subclasses with a different size come from the global heap.
+ */
+template<typename T>
+inline void* slab_new(size_t size) {
+	if(size != sizeof(T)) {
+		return ::operator new(size);
+	}
+	return slab_pool<sizeof(T), alignof(T)>::allocate();
+}
+
+template<typename T>
+inline void slab_delete(void* p, size_t size) noexcept {
+	if(size != sizeof(T)) {
+		::operator delete(p);
+		return;
+	}
+	slab_pool<sizeof(T), alignof(T)>::deallocate(p);
+}
+
+/**
+ * \brief Shares the ownership of `p`, with the control block coming from a slab_pool.
+ */
+template<typename T>
+inline std::shared_ptr<T> make_slab_shared(std::unique_ptr<T> p) {
+	if(p == nullptr) {
+		return nullptr;
+	}
+	return std::shared_ptr<T>(p.release(), std::default_delete<T>(), slab_allocator<T>());
+}
+
+}  // namespace libsinsp
@@ -23,6 +23,7 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <utility>
 
 namespace libsinsp {
 namespace state {
@@ -56,12 +57,14 @@ public:
 		                  bool r):
 		        m_readonly(r),
 		        m_index(in),
+		        m_offset((size_t)-1),
 		        m_name(n),
 		        m_info(i),
 		        m_defs_id(defsptr) {}
 		inline field_info():
 		        m_readonly(true),
 		        m_index((size_t)-1),
+		        m_offset((size_t)-1),
 		        m_name(""),
 		        m_info(typeinfo::of<uint8_t>()),
 		        m_defs_id((uintptr_t)NULL) {}
@@ -137,6 +140,7 @@ public:
 	private:
 		bool m_readonly;
 		size_t m_index;
+		size_t m_offset;
 		std::string m_name;
 		libsinsp::state::typeinfo m_info;
 		uintptr_t m_defs_id;
@@ -226,8 +230,12 @@ public:
 				}
 				return it->second;
 			}
-			m_definitions.insert({field.name(), field});
-			const auto& def = m_definitions.at(field.name());
+			// fields are laid out in the order they are defined, so the
+			// offsets of the existing ones never change
+			auto& def = m_definitions.insert({field.name(), field}).first->second;
+			const auto& info = def.info();
+			def.m_offset = (m_block_size + info.alignment() - 1) & ~(info.alignment() - 1);
+			m_block_size = def.m_offset + info.size();
 			m_definitions_ordered.push_back(&def);
 			return def;
 		}
@@ -235,6 +243,7 @@ public:
 		uintptr_t m_defs_id;
 		std::unordered_map<std::string, field_info> m_definitions;
 		std::vector<const field_info*> m_definitions_ordered;
+		size_t m_block_size = 0;
 		friend class dynamic_struct;
 	};
 
@@ -242,9 +251,18 @@ public:
 	        m_fields(),
 	        m_dynamic_fields(dynamic_fields) {}
 
-	inline dynamic_struct(dynamic_struct&&) = default;
+	inline dynamic_struct(dynamic_struct&& s) noexcept:
+	        m_fields(std::move(s.m_fields)),
+	        m_fields_count(std::exchange(s.m_fields_count, 0)),
+	        m_dynamic_fields(std::move(s.m_dynamic_fields)) {}
 
-	inline dynamic_struct& operator=(dynamic_struct&&) = default;
+	inline dynamic_struct& operator=(dynamic_struct&& s) {
+		destroy_dynamic_fields();
+		m_fields = std::move(s.m_fields);
+		m_fields_count = std::exchange(s.m_fields_count, 0);
+		m_dynamic_fields = std::move(s.m_dynamic_fields);
+		return *this;
+	}
 
 	inline dynamic_struct(const dynamic_struct& s) { deep_fields_copy(s); }
 
@@ -296,6 +314,8 @@ public:
 		if(!defs) {
 			throw sinsp_exception("dynamic struct constructed with null field definitions");
 		}
+		// the layout of the allocated fields depends on the definitions
+		destroy_dynamic_fields();
 		m_dynamic_fields = defs;
 	}
 
@@ -307,7 +327,7 @@ protected:
 	 * For strings, "out" is considered of type const char**.
 	 */
 	virtual void get_dynamic_field(const field_info& i, void* out) {
-		const auto* buf = _access_dynamic_field(i.m_index);
+		const auto* buf = _access_dynamic_field(i);
 		if(i.info().index() == typeinfo::index_t::TI_STRING) {
 			*((const char**)out) = ((const std::string*)buf)->c_str();
 		} else {
@@ -322,7 +342,7 @@ protected:
 	 * For strings, "in" is considered of type const char**.
 	 */
 	virtual void set_dynamic_field(const field_info& i, const void* in) {
-		auto* buf = _access_dynamic_field(i.m_index);
+		auto* buf = _access_dynamic_field(i);
 		if(i.info().index() == typeinfo::index_t::TI_STRING) {
 			*((std::string*)buf) = *((const char**)in);
 		} else {
@@ -334,14 +354,15 @@ protected:
 	 * @brief Destroys all the dynamic field values currently allocated
 	 */
 	virtual void destroy_dynamic_fields() {
-		if(!m_dynamic_fields) {
+		if(!m_dynamic_fields || !m_fields) {
 			return;
 		}
-		for(size_t i = 0; i < m_fields.size(); i++) {
-			m_dynamic_fields->m_definitions_ordered[i]->info().destroy(m_fields[i]);
-			free(m_fields[i]);
+		for(size_t i = 0; i < m_fields_count; i++) {
+			const auto* def = m_dynamic_fields->m_definitions_ordered[i];
+			def->info().destroy(m_fields.get() + def->m_offset);
 		}
-		m_fields.clear();
+		m_fields.reset();
+		m_fields_count = 0;
 	}
 
 private:
@@ -358,20 +379,41 @@ private:
 		}
 	}
 
-	inline void* _access_dynamic_field(size_t index) {
+	inline void* _access_dynamic_field(const field_info& i) {
 		if(!m_dynamic_fields) {
 			throw sinsp_exception("dynamic struct has no field definitions");
 		}
-		if(index >= m_dynamic_fields->m_definitions_ordered.size()) {
-			throw sinsp_exception("dynamic struct access overflow: " + std::to_string(index));
+		if(i.m_index >= m_fields_count) {
+			if(i.m_index >= m_dynamic_fields->m_definitions_ordered.size()) {
+				throw sinsp_exception("dynamic struct access overflow: " +
+				                      std::to_string(i.m_index));
+			}
+			_resize_dynamic_fields();
 		}
-		while(m_fields.size() <= index) {
-			auto def = m_dynamic_fields->m_definitions_ordered[m_fields.size()];
-			void* fieldbuf = malloc(def->info().size());
-			def->info().construct(fieldbuf);
-			m_fields.push_back(fieldbuf);
+		return m_fields.get() + i.m_offset;
+	}
+
+	// allocates one block for all the fields currently defined, and moves
+	// the values of the ones we already had into it
+	inline void _resize_dynamic_fields() {
+		const auto& defs = m_dynamic_fields->m_definitions_ordered;
+		std::unique_ptr<uint8_t[]> fields(new uint8_t[m_dynamic_fields->m_block_size]);
+		for(size_t i = 0; i < defs.size(); i++) {
+			auto* buf = fields.get() + defs[i]->m_offset;
+			defs[i]->info().construct(buf);
+			if(i >= m_fields_count) {
+				continue;
+			}
+			auto* prev = m_fields.get() + defs[i]->m_offset;
+			if(defs[i]->info().index() == typeinfo::index_t::TI_STRING) {
+				*((std::string*)buf) = std::move(*((std::string*)prev));
+			} else {
+				memcpy(buf, prev, defs[i]->info().size());
+			}
+			defs[i]->info().destroy(prev);
 		}
-		return m_fields[index];
+		m_fields = std::move(fields);
+		m_fields_count = defs.size();
 	}
 
 	inline void deep_fields_copy(const dynamic_struct& other_const) {
@@ -380,11 +422,11 @@ private:
 		auto& other = const_cast<dynamic_struct&>(other_const);
 
 		// copy the definitions
+		destroy_dynamic_fields();
 		set_dynamic_fields(other.dynamic_fields());
 
 		// deep copy of all the fields
-		destroy_dynamic_fields();
-		for(size_t i = 0; i < other.m_fields.size(); i++) {
+		for(size_t i = 0; i < other.m_fields_count; i++) {
 			const auto info = m_dynamic_fields->m_definitions_ordered[i];
 			// note: we use uintptr_t as it fits all the data types supported for
 			// reading and writing dynamic fields (e.g. uint32_t, uint64_t, const char*,
@@ -395,7 +437,9 @@ private:
 		}
 	}
 
-	std::vector<void*> m_fields;
+	// all the fields live in a single block, at the offsets of their definitions
+	std::unique_ptr<uint8_t[]> m_fields;
+	size_t m_fields_count = 0;
 	std::shared_ptr<field_infos> m_dynamic_fields;
 };
 
@@ -93,6 +93,11 @@ public:
 	 */
 	inline size_t size() const { return m_size; }
 
+	/**
+	 * @brief Returns the alignment requirement of variables of the given type.
+	 */
+	inline size_t alignment() const { return m_alignment; }
+
 	/**
 	 * @brief Constructs and initializes the given type in the passed-in
 	 * memory location, which is expected to be larger or equal than size().
@@ -112,10 +117,16 @@ public:
 	}
 
 private:
-	inline typeinfo(const char* n, index_t k, size_t s, void (*c)(void*), void (*d)(void*)):
+	inline typeinfo(const char* n,
+	                index_t k,
+	                size_t s,
+	                size_t a,
+	                void (*c)(void*),
+	                void (*d)(void*)):
 	        m_name(n),
 	        m_index(k),
 	        m_size(s),
+	        m_alignment(a),
 	        m_construct(c),
 	        m_destroy(d) {}
 
@@ -133,12 +144,13 @@ private:
 
 	template<typename T>
 	static inline typeinfo _build(const char* n, index_t k) {
-		return typeinfo(n, k, sizeof(T), _construct<T>, _destroy<T>);
+		return typeinfo(n, k, sizeof(T), alignof(T), _construct<T>, _destroy<T>);
 	}
 
 	const char* m_name;
 	index_t m_index;
 	size_t m_size;
+	size_t m_alignment;
 	void (*m_construct)(void*);
 	void (*m_destroy)(void*);
 };
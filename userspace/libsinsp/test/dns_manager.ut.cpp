@@ -20,6 +20,8 @@ limitations under the License.
 #include <dns_manager.h>
 #include <gtest/gtest.h>
 
+#include <arpa/inet.h>
+
 TEST(sinsp_dns_manager, simple_dns_manager_invocation) {
 	// Simple dummy test to assert that sinsp_dns_manager is invocated correctly
 	// and not leaking memory
@@ -29,4 +31,25 @@ TEST(sinsp_dns_manager, simple_dns_manager_invocation) {
 	bool result = sinsp_dns_manager::get().match(name, AF_INET, &addr, ts);
 	ASSERT_FALSE(result);
 }
+
+TEST(sinsp_dns_manager, name_of) {
+	// numeric names resolve to themselves without querying any DNS server
+	uint64_t ts = 11111111111111;
+	uint32_t v4;
+	ASSERT_EQ(inet_pton(AF_INET, "10.11.12.13", &v4), 1);
+	ASSERT_TRUE(sinsp_dns_manager::get().match("10.11.12.13", AF_INET, &v4, ts));
+	ASSERT_EQ(sinsp_dns_manager::get().name_of(AF_INET, &v4, ts), "10.11.12.13");
+
+	ipv6addr v6;
+	ASSERT_EQ(inet_pton(AF_INET6, "fd00::1213", v6.m_b), 1);
+	ASSERT_TRUE(sinsp_dns_manager::get().match("fd00::1213", AF_INET6, v6.m_b, ts));
+	ASSERT_EQ(sinsp_dns_manager::get().name_of(AF_INET6, v6.m_b, ts), "fd00::1213");
+
+	// addresses of names that were never matched are unknown
+	uint32_t unknown_v4;
+	ASSERT_EQ(inet_pton(AF_INET, "10.11.12.14", &unknown_v4), 1);
+	ASSERT_EQ(sinsp_dns_manager::get().name_of(AF_INET, &unknown_v4, ts), "");
+	ASSERT_EQ(inet_pton(AF_INET6, "fd00::1214", v6.m_b), 1);
+	ASSERT_EQ(sinsp_dns_manager::get().name_of(AF_INET6, v6.m_b, ts), "");
+}
 #endif
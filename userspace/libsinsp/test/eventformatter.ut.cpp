@@ -363,3 +363,59 @@ TEST_F(sinsp_formatter_test, lenght_larger_with_transformer) {
 	EXPECT_EQ(m_last_field_values["proc.name"], "init");
 	EXPECT_EQ(m_last_field_values["toupper(proc.name)"], "INIT");
 }
+
+TEST_F(sinsp_formatter_test, streaming_json) {
+	auto getcwd = generate_getcwd_failed_entry_event();
+	auto open = add_event_advance_ts(increasing_ts(),
+	                                 INIT_TID,
+	                                 PPME_SYSCALL_OPEN_X,
+	                                 6,
+	                                 (uint64_t)3,
+	                                 "/tmp/\"quoted\"\\ and \xc3\xa9\t",
+	                                 PPM_O_RDWR,
+	                                 0,
+	                                 5,
+	                                 (uint64_t)123);
+	std::vector<std::string> formats = {
+	        "start %proc.name %thread.tid end",
+	        "%proc.name %proc.name %proc.pid",
+	        "*start %proc.name %evt.asynctype end",
+	        "start end",
+	        "%proc.aname[0] %toupper(proc.name) %evt.arg.path %toupper(evt.arg.path)",
+	        "%evt.num %evt.time %evt.rawtime %evt.dir %evt.type %evt.res %evt.count %evt.latency",
+	        "*%evt.args %fd.name %fd.num %evt.arg.name %proc.cmdline",
+	};
+
+	for(auto evt : {getcwd, open}) {
+		for(const auto& fmt : formats) {
+			for(bool resolve_transformers : {false, true}) {
+				sinsp_evt_formatter f(&m_inspector, fmt, m_filter_list);
+				f.set_resolve_transformed_fields(resolve_transformers);
+				std::string expected;
+				auto expected_res = f.tostring_withformat(evt, expected, f.OF_JSON);
+
+				f.set_streaming_json(true);
+				std::string output = "previous output";
+				auto res = f.tostring_withformat(evt, output, f.OF_JSON);
+				EXPECT_EQ(res, expected_res) << fmt;
+				if(expected_res) {
+					EXPECT_EQ(output, expected) << fmt;
+				}
+			}
+		}
+	}
+}
+
+TEST_F(sinsp_formatter_test, streaming_json_stop_on_null) {
+	sinsp_evt_formatter f(&m_inspector, "start %proc.name %evt.asynctype end", m_filter_list);
+	f.set_streaming_json(true);
+	auto evt = generate_getcwd_failed_entry_event();
+	std::string output;
+	EXPECT_FALSE(f.tostring_withformat(evt, output, f.OF_JSON));
+	EXPECT_EQ(output, "null");
+
+	// the values are written in key order
+	f.set_format(f.OF_JSON, "start %proc.name %evt.asynctype %evt.arg.path end");
+	EXPECT_FALSE(f.tostring(evt, output));
+	EXPECT_EQ(output, "{\"evt.arg.path\":\"/test/dir\"}");
+}
@@ -20,8 +20,12 @@ limitations under the License.
 
 #include <sinsp_with_test_input.h>
 #include <sinsp_errno.h>
+#include <libsinsp/dumper.h>
 #include "test_utils.h"
 
+#include <filesystem>
+#include <fstream>
+
 TEST_F(sinsp_with_test_input, event_category) {
 	add_default_init_thread();
 
@@ -184,3 +188,411 @@ TEST_F(sinsp_with_test_input, event_hostname) {
 	ASSERT_EQ(0, success2);
 #endif
 }
+
+TEST_F(sinsp_with_test_input, event_next_batch) {
+	add_default_init_thread();
+
+	open_inspector();
+
+	std::vector<uint64_t> expected_ts;
+	for(int i = 0; i < 5; i++) {
+		expected_ts.push_back(increasing_ts());
+		add_event(expected_ts.back(), 1, PPME_SYSCALL_EPOLL_CREATE_E, 1, (uint32_t)-1);
+	}
+
+	/* Batches can be freely interleaved with `next()`. */
+	sinsp_evt *evt = nullptr;
+	ASSERT_EQ(m_inspector.next(&evt), SCAP_SUCCESS);
+	std::vector<uint64_t> ts = {evt->get_ts()};
+	std::vector<uint64_t> num = {evt->get_num()};
+
+	int32_t res;
+	do {
+		res = m_inspector.next_batch(3, [&](sinsp_evt *e) {
+			ts.push_back(e->get_ts());
+			num.push_back(e->get_num());
+		});
+	} while(res == SCAP_SUCCESS);
+
+	/* The test engine times out once all the events are consumed. */
+	ASSERT_EQ(res, SCAP_TIMEOUT);
+	ASSERT_EQ(ts, expected_ts);
+	for(size_t i = 1; i < num.size(); i++) {
+		ASSERT_EQ(num[i], num[i - 1] + 1);
+	}
+}
+
+TEST_F(sinsp_with_test_input, event_next_batch_savefile) {
+	std::filesystem::path tmp_scap_file_path =
+	        std::filesystem::temp_directory_path() / "tmp.next_batch.scap";
+	std::string tmp_scap_file_name = tmp_scap_file_path.string();
+
+	add_default_init_thread();
+	open_inspector();
+
+	/* Enough events to need more than one savefile batch buffer. */
+	std::vector<uint64_t> expected_ts;
+	sinsp_dumper dumper;
+	dumper.open(&m_inspector, tmp_scap_file_name, false);
+	for(int i = 0; i < 5000; i++) {
+		sinsp_evt *evt = add_event_advance_ts(increasing_ts(),
+		                                      1,
+		                                      PPME_SYSCALL_OPEN_E,
+		                                      3,
+		                                      "/tmp/the_file.txt",
+		                                      (uint32_t)0,
+		                                      (uint32_t)0);
+		expected_ts.push_back(evt->get_ts());
+		dumper.dump(evt);
+	}
+	dumper.close();
+
+	sinsp inspector;
+	inspector.open_savefile(tmp_scap_file_name);
+	std::vector<uint64_t> ts;
+	int32_t res;
+	do {
+		res = inspector.next_batch(1000, [&](sinsp_evt *evt) { ts.push_back(evt->get_ts()); });
+	} while(res == SCAP_SUCCESS);
+	inspector.close();
+
+	ASSERT_EQ(res, SCAP_EOF);
+	ASSERT_EQ(ts, expected_ts);
+
+	std::filesystem::remove(tmp_scap_file_path);
+}
+
+TEST_F(sinsp_with_test_input, event_savefile_parallel_files) {
+	std::vector<std::string> files;
+	for(int i = 0; i < 3; i++) {
+		std::filesystem::path path = std::filesystem::temp_directory_path() /
+		                             ("tmp.parallel_files." + std::to_string(i) + ".scap");
+		files.push_back(path.string());
+	}
+
+	add_default_init_thread();
+	open_inspector();
+
+	/* The events written by the dumpers when they open take the timestamp of the
+	 * last event, as it happens when a dumper rotates its files. */
+	add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_GETCWD_E, 0);
+
+	/* The files overlap in time, so that the merge must interleave them, and each
+	 * one spans several chunks of the parallel reader. */
+	std::vector<uint64_t> expected_ts;
+	std::vector<std::unique_ptr<sinsp_dumper>> dumpers;
+	for(const auto &file : files) {
+		dumpers.emplace_back(std::make_unique<sinsp_dumper>());
+		dumpers.back()->open(&m_inspector, file, true);
+	}
+	for(int i = 0; i < 30000; i++) {
+		sinsp_evt *evt = add_event_advance_ts(increasing_ts(),
+		                                      1,
+		                                      PPME_SYSCALL_OPEN_E,
+		                                      3,
+		                                      "/tmp/the_file.txt",
+		                                      (uint32_t)0,
+		                                      (uint32_t)0);
+		expected_ts.push_back(evt->get_ts());
+		dumpers[(i / 7 + i % 3) % files.size()]->dump(evt);
+	}
+	for(auto &dumper : dumpers) {
+		dumper->close();
+	}
+
+	for(uint32_t num_workers : {1, 2, 4}) {
+		sinsp inspector;
+		inspector.open_savefiles(files, num_workers);
+		std::vector<uint64_t> ts;
+		int32_t res;
+		sinsp_evt *evt;
+		while((res = inspector.next(&evt)) == SCAP_SUCCESS) {
+			if(evt->get_type() == PPME_SYSCALL_OPEN_E) {
+				ts.push_back(evt->get_ts());
+			}
+		}
+		inspector.close();
+
+		ASSERT_EQ(res, SCAP_EOF);
+		ASSERT_EQ(ts, expected_ts);
+	}
+
+	{
+		sinsp inspector;
+		inspector.open_savefiles(files, 2);
+		std::vector<uint64_t> ts;
+		int32_t res;
+		do {
+			res = inspector.next_batch(1000, [&](sinsp_evt *evt) {
+				if(evt->get_type() == PPME_SYSCALL_OPEN_E) {
+					ts.push_back(evt->get_ts());
+				}
+			});
+		} while(res == SCAP_SUCCESS);
+		inspector.close();
+
+		ASSERT_EQ(res, SCAP_EOF);
+		ASSERT_EQ(ts, expected_ts);
+	}
+
+	sinsp inspector;
+	ASSERT_THROW(inspector.open_savefiles(files, 2, {1024}), sinsp_exception);
+
+	for(const auto &file : files) {
+		std::filesystem::remove(file);
+	}
+}
+
+TEST_F(sinsp_with_test_input, event_savefile_parallel_segments) {
+	std::filesystem::path tmp_scap_file_path =
+	        std::filesystem::temp_directory_path() / "tmp.parallel_segments.scap";
+	std::string tmp_scap_file_name = tmp_scap_file_path.string();
+
+	add_default_init_thread();
+	open_inspector();
+
+	std::vector<uint64_t> expected_ts;
+	std::vector<uint64_t> offsets;
+	sinsp_dumper dumper;
+	dumper.open(&m_inspector, tmp_scap_file_name, false);
+	for(int i = 0; i < 20000; i++) {
+		sinsp_evt *evt = add_event_advance_ts(increasing_ts(),
+		                                      1,
+		                                      PPME_SYSCALL_OPEN_E,
+		                                      3,
+		                                      "/tmp/the_file.txt",
+		                                      (uint32_t)0,
+		                                      (uint32_t)0);
+		expected_ts.push_back(evt->get_ts());
+		if(i == 4000 || i == 4001 || i == 15000) {
+			offsets.push_back(dumper.next_write_position());
+		}
+		dumper.dump(evt);
+	}
+	dumper.close();
+
+	sinsp inspector;
+	inspector.open_savefiles({tmp_scap_file_name}, 3, offsets);
+	std::vector<uint64_t> ts;
+	int32_t res;
+	sinsp_evt *evt;
+	while((res = inspector.next(&evt)) == SCAP_SUCCESS) {
+		if(evt->get_type() == PPME_SYSCALL_OPEN_E) {
+			ts.push_back(evt->get_ts());
+		}
+	}
+	inspector.close();
+
+	ASSERT_EQ(res, SCAP_EOF);
+	ASSERT_EQ(ts, expected_ts);
+
+	/* Offsets must be increasing */
+	std::reverse(offsets.begin(), offsets.end());
+	ASSERT_THROW(inspector.open_savefiles({tmp_scap_file_name}, 3, offsets), sinsp_exception);
+
+	std::filesystem::remove(tmp_scap_file_path);
+}
+
+TEST_F(sinsp_with_test_input, event_savefile_mmap) {
+	std::vector<std::string> files;
+	for(const char *name : {"tmp.mmap.scap", "tmp.mmap.scap.gz"}) {
+		files.push_back((std::filesystem::temp_directory_path() / name).string());
+	}
+
+	add_default_init_thread();
+	open_inspector();
+
+	std::vector<uint64_t> offsets;
+	std::vector<std::pair<uint64_t, std::string>> expected;
+	sinsp_dumper uncompressed;
+	sinsp_dumper compressed;
+	uncompressed.open(&m_inspector, files[0], false);
+	compressed.open(&m_inspector, files[1], true);
+	for(int i = 0; i < 20000; i++) {
+		std::string name = "/tmp/the_file_" + std::to_string(i) + ".txt";
+		sinsp_evt *evt = add_event_advance_ts(increasing_ts(),
+		                                      1,
+		                                      PPME_SYSCALL_OPEN_E,
+		                                      3,
+		                                      name.c_str(),
+		                                      (uint32_t)0,
+		                                      (uint32_t)0);
+		expected.emplace_back(evt->get_ts(), name);
+		if(i == 10000) {
+			offsets.push_back(uncompressed.next_write_position());
+		}
+		uncompressed.dump(evt);
+		compressed.dump(evt);
+	}
+	uncompressed.close();
+	compressed.close();
+
+	/* Compressed files fall back to zlib, and the events of mapped files stay valid
+	 * when the parallel reader keeps them in its chunks. */
+	auto read_events = [&](const std::string &file, uint32_t num_workers) {
+		sinsp inspector;
+		inspector.set_savefile_mmap(true);
+		if(num_workers > 0) {
+			inspector.open_savefiles({file}, num_workers, offsets);
+		} else {
+			inspector.open_savefile(file);
+		}
+		std::vector<std::pair<uint64_t, std::string>> events;
+		int32_t res;
+		do {
+			res = inspector.next_batch(1000, [&](sinsp_evt *evt) {
+				if(evt->get_type() == PPME_SYSCALL_OPEN_E) {
+					events.emplace_back(evt->get_ts(), evt->get_param(0)->as<std::string>());
+				}
+			});
+		} while(res == SCAP_SUCCESS);
+		inspector.close();
+
+		EXPECT_EQ(res, SCAP_EOF);
+		return events;
+	};
+
+	ASSERT_EQ(read_events(files[0], 0), expected);
+	ASSERT_EQ(read_events(files[0], 2), expected);
+	ASSERT_EQ(read_events(files[1], 0), expected);
+
+	for(const auto &file : files) {
+		std::filesystem::remove(file);
+	}
+}
+
+TEST_F(sinsp_with_test_input, event_savefile_start) {
+	std::string file = (std::filesystem::temp_directory_path() / "tmp.start.scap").string();
+	std::string index = file + ".idx";
+
+	add_default_init_thread();
+	open_inspector();
+
+	/* The events written by the dumper when it opens take the timestamp of the
+	 * last event, instead of the current time. */
+	add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_GETCWD_E, 0);
+
+	std::vector<uint64_t> expected_ts;
+	sinsp_dumper dumper;
+	dumper.set_index(index, 1000);
+	dumper.open(&m_inspector, file, true);
+	for(int i = 0; i < 20000; i++) {
+		sinsp_evt *evt = add_event_advance_ts(increasing_ts(),
+		                                      1,
+		                                      PPME_SYSCALL_OPEN_E,
+		                                      3,
+		                                      "/tmp/the_file.txt",
+		                                      (uint32_t)0,
+		                                      (uint32_t)0);
+		expected_ts.push_back(evt->get_ts());
+		dumper.dump(evt);
+	}
+	dumper.close();
+
+	auto read_ts = [&](uint64_t ts, uint64_t evt_num, const std::string &index_filename) {
+		sinsp inspector;
+		inspector.set_savefile_start(ts, evt_num, index_filename);
+		inspector.open_savefile(file);
+		std::vector<uint64_t> events;
+		int32_t res;
+		sinsp_evt *evt;
+		while((res = inspector.next(&evt)) == SCAP_SUCCESS) {
+			if(evt->get_type() == PPME_SYSCALL_OPEN_E) {
+				events.push_back(evt->get_ts());
+			}
+		}
+		inspector.close();
+
+		EXPECT_EQ(res, SCAP_EOF);
+		return events;
+	};
+
+	/* The checkpoints of the index find the same events as a full scan */
+	for(size_t i : {0, 999, 1000, 1001, 12345, 19999}) {
+		std::vector<uint64_t> suffix(expected_ts.begin() + i, expected_ts.end());
+		ASSERT_EQ(read_ts(expected_ts[i], 0, index), suffix);
+		ASSERT_EQ(read_ts(expected_ts[i], 0, ""), suffix);
+		ASSERT_EQ(read_ts(0, i, index), read_ts(0, i, ""));
+	}
+
+	/* Event numbers also count the events written by the dumper when it opens */
+	std::vector<uint64_t> events = read_ts(0, 12345, index);
+	ASSERT_GE(events.size(), expected_ts.size() - 12345);
+	ASSERT_LT(events.size(), expected_ts.size() - 12345 + 10);
+	ASSERT_TRUE(std::equal(events.begin(), events.end(), expected_ts.end() - events.size()));
+	ASSERT_TRUE(read_ts(expected_ts.back() + 1, 0, index).empty());
+
+	/* A broken index falls back to a full scan */
+	std::ofstream(index, std::ios::binary | std::ios::trunc) << "not an index";
+	ASSERT_EQ(read_ts(expected_ts[12345], 0, index).size(), expected_ts.size() - 12345);
+
+	std::filesystem::remove(file);
+	std::filesystem::remove(index);
+}
+
+TEST_F(sinsp_with_test_input, event_savefile_parallel_compression) {
+	std::string file =
+	        (std::filesystem::temp_directory_path() / "tmp.parallel_compression.scap").string();
+	std::string index = file + ".idx";
+
+	add_default_init_thread();
+	open_inspector();
+	add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_GETCWD_E, 0);
+
+	/* Enough events to fill several chunks, with the file flushed in the middle */
+	std::vector<std::pair<uint64_t, std::string>> expected;
+	sinsp_dumper dumper;
+	dumper.set_compression_threads(3);
+	dumper.set_index(index, 1000);
+	dumper.open(&m_inspector, file, true);
+	for(int i = 0; i < 50000; i++) {
+		std::string name = "/tmp/the_file_" + std::to_string(i) + ".txt";
+		sinsp_evt *evt = add_event_advance_ts(increasing_ts(),
+		                                      1,
+		                                      PPME_SYSCALL_OPEN_E,
+		                                      3,
+		                                      name.c_str(),
+		                                      (uint32_t)0,
+		                                      (uint32_t)0);
+		expected.emplace_back(evt->get_ts(), name);
+		dumper.dump(evt);
+		if(i == 20000) {
+			dumper.flush();
+		}
+	}
+	ASSERT_GT(dumper.next_write_position(), dumper.written_bytes());
+	dumper.close();
+
+	/* A gzip file, made of several members */
+	std::ifstream in(file, std::ios::binary);
+	ASSERT_EQ(in.get(), 0x1f);
+	ASSERT_EQ(in.get(), 0x8b);
+	in.close();
+
+	auto read_events = [&](uint64_t start_ts) {
+		sinsp inspector;
+		inspector.set_savefile_start(start_ts, 0, index);
+		inspector.open_savefile(file);
+		std::vector<std::pair<uint64_t, std::string>> events;
+		int32_t res;
+		sinsp_evt *evt;
+		while((res = inspector.next(&evt)) == SCAP_SUCCESS) {
+			if(evt->get_type() == PPME_SYSCALL_OPEN_E) {
+				events.emplace_back(evt->get_ts(), evt->get_param(0)->as<std::string>());
+			}
+		}
+		inspector.close();
+
+		EXPECT_EQ(res, SCAP_EOF);
+		return events;
+	};
+
+	ASSERT_EQ(read_events(0), expected);
+
+	/* The offsets of the index are positions in the uncompressed data */
+	std::vector<std::pair<uint64_t, std::string>> suffix(expected.begin() + 33333, expected.end());
+	ASSERT_EQ(read_events(expected[33333].first), suffix);
+
+	std::filesystem::remove(file);
+	std::filesystem::remove(index);
+}
@@ -840,6 +840,89 @@ TEST_F(sinsp_with_test_input, filter_cache_pointer_instability) {
 	EXPECT_FALSE(eval_filter(evt, "(evt.arg.ret = val(evt.arg.reaper_tid))"));
 }
 
+TEST_F(sinsp_with_test_input, filter_multi_match) {
+	add_default_init_thread();
+	open_inspector();
+
+	auto evt = generate_getcwd_failed_entry_event();
+	std::string values = "evt.source in (a, b, c, d, e, f, g)";
+
+	// checks on a field connected by 'or' with enough values are merged
+	auto factory = std::make_shared<sinsp_filter_factory>(&m_inspector, m_default_filterlist);
+	sinsp_filter_compiler compiler(factory, values + " or evt.source = syscall or evt.num = 0");
+	auto filter = compiler.compile();
+	auto expr = dynamic_cast<sinsp_filter_expression*>(filter->m_filter->m_checks[0].get());
+	ASSERT_NE(expr, nullptr);
+	ASSERT_EQ(expr->m_checks.size(), 2);
+	ASSERT_NE(dynamic_cast<sinsp_filter_multi_match*>(expr->m_checks[0].get()), nullptr);
+	ASSERT_TRUE(filter->run(evt));
+
+	EXPECT_TRUE(eval_filter(evt, values + " or evt.source startswith sys"));
+	EXPECT_TRUE(eval_filter(evt, values + " or evt.source contains scal"));
+	EXPECT_TRUE(eval_filter(evt, values + " or evt.source startswith x or evt.source = syscall"));
+	EXPECT_FALSE(eval_filter(evt, values + " or evt.source = sys"));
+	EXPECT_FALSE(eval_filter(evt, values + " or evt.source startswith scal"));
+	EXPECT_FALSE(eval_filter(evt, values + " or evt.source contains xyz"));
+	EXPECT_TRUE(eval_filter(evt, "not (" + values + " or evt.source = sys)"));
+	EXPECT_FALSE(eval_filter(evt, "evt.type = getcwd and (" + values + " or evt.source = x)"));
+	EXPECT_TRUE(eval_filter(evt, values + " or evt.type = getcwd or evt.source = x"));
+	EXPECT_TRUE(eval_filter(evt, "evt.source = x or evt.type = getcwd or " + values));
+}
+
+TEST_F(sinsp_with_test_input, filter_reorder_checks) {
+	add_default_init_thread();
+	open_inspector();
+
+	auto evt = generate_getcwd_failed_entry_event();
+	auto factory = std::make_shared<sinsp_filter_factory>(&m_inspector, m_default_filterlist);
+	auto compile = [&](const std::string& str, uint64_t sample_period) {
+		sinsp_filter_compiler compiler(factory, str);
+		compiler.set_reorder_checks(true, sample_period);
+		return compiler.compile();
+	};
+	auto field_name = [](const std::unique_ptr<sinsp_filter_check>& c) {
+		return std::string(c->get_field_info()->m_name);
+	};
+
+	// the cheapest checks come first, keeping their negation
+	auto filter = compile("proc.aname = foo and not fd.name contains x and evt.dir = <", 0);
+	auto expr = dynamic_cast<sinsp_filter_expression*>(filter->m_filter->m_checks[0].get());
+	ASSERT_NE(expr, nullptr);
+	ASSERT_EQ(expr->m_checks.size(), 3);
+	ASSERT_EQ(field_name(expr->m_checks[0]), "evt.dir");
+	ASSERT_EQ(expr->m_checks[0]->m_boolop, BO_NONE);
+	ASSERT_NE(dynamic_cast<sinsp_filter_expression*>(expr->m_checks[1].get()), nullptr);
+	ASSERT_EQ(expr->m_checks[1]->m_boolop, BO_ANDNOT);
+	ASSERT_EQ(field_name(expr->m_checks[2]), "proc.aname");
+	ASSERT_EQ(expr->m_checks[2]->m_boolop, BO_AND);
+	ASSERT_FALSE(filter->run(evt));
+
+	// the result does not change
+	for(const std::string str : {"proc.aname = init or (evt.dir = > and evt.type = getcwd)",
+	                             "not (proc.name regex '^i' and evt.type = getcwd)",
+	                             "proc.name = x or not evt.dir = > or evt.type = open",
+	                             "evt.type = open or evt.type = getcwd and not evt.dir = >"}) {
+		sinsp_filter_compiler compiler(factory, str);
+		auto expected = compiler.compile()->run(evt);
+		EXPECT_EQ(compile(str, 0)->run(evt), expected) << str;
+		EXPECT_EQ(compile(str, 1)->run(evt), expected) << str;
+	}
+
+	// the checks that decide the result more often come first
+	filter = compile("evt.dir = < and evt.type = open", 4);
+	expr = dynamic_cast<sinsp_filter_expression*>(filter->m_filter->m_checks[0].get());
+	ASSERT_NE(expr, nullptr);
+	ASSERT_EQ(field_name(expr->m_checks[0]), "evt.dir");
+	for(int i = 0; i < 4; i++) {
+		ASSERT_FALSE(filter->run(evt));
+	}
+	ASSERT_EQ(field_name(expr->m_checks[0]), "evt.type");
+	ASSERT_EQ(expr->m_checks[0]->m_boolop, BO_NONE);
+	ASSERT_EQ(field_name(expr->m_checks[1]), "evt.dir");
+	ASSERT_EQ(expr->m_checks[1]->m_boolop, BO_AND);
+	ASSERT_FALSE(filter->run(evt));
+}
+
 TEST_F(sinsp_with_test_input, filter_regex_operator_evaluation) {
 	// Basic case just to assert that the basic setup works
 	add_default_init_thread();
@@ -82,6 +82,18 @@ TEST_F(sinsp_with_test_input, net_ipv4_compare) {
 
 	EXPECT_FALSE(eval_filter(evt, "fd.net == 10.0.0.0/8"));
 	EXPECT_FALSE(eval_filter(evt, "fd.net == 2001:db8:abcd:0012::0/64"));
+
+	EXPECT_TRUE(eval_filter(evt, "fd.net in (10.0.0.0/8, 142.251.111.0/24)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.net in (10.0.0.0/8, 172.32.0.0/11)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.net in (2001:db8::0/32, 142.251.111.144/30)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.net in (0.0.0.0/0)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.snet in (10.0.0.0/8, 142.251.111.147/32)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.cnet in (10.0.0.0/8, 172.40.111.0/24)"));
+
+	EXPECT_FALSE(eval_filter(evt, "fd.net in (10.0.0.0/8, 192.168.0.0/16)"));
+	EXPECT_FALSE(eval_filter(evt, "fd.net in (10.0.0.0/8, 142.251.111.148/30)"));
+	EXPECT_FALSE(eval_filter(evt, "fd.net in (2001:db8::0/32)"));
+	EXPECT_FALSE(eval_filter(evt, "fd.cnet in (10.0.0.0/8, 142.251.111.147/32)"));
 }
 
 TEST_F(sinsp_with_test_input, net_ipv6_compare) {
@@ -145,4 +157,11 @@ TEST_F(sinsp_with_test_input, net_ipv6_compare) {
 
 	EXPECT_FALSE(eval_filter(evt, "fd.net == 10.0.0.0/8"));
 	EXPECT_FALSE(eval_filter(evt, "fd.net == 2001:db8:abcd:0012::0/64"));
+
+	EXPECT_TRUE(eval_filter(evt, "fd.net in (10.0.0.0/8, 2001:4860:4860::8888/128)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.net in (2001:db8::0/32, ::1/128)"));
+	EXPECT_TRUE(eval_filter(evt, "fd.snet in (2001:db8::0/32, 2001:4860::0/31)"));
+
+	EXPECT_FALSE(eval_filter(evt, "fd.net in (10.0.0.0/8, 2001:4860:4860::8889/128)"));
+	EXPECT_FALSE(eval_filter(evt, "fd.snet in (0.0.0.0/0, ::1/128)"));
 }
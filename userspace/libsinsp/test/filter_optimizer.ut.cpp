@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <libsinsp/filter/optimizer.h>
+#include <libsinsp/filter/parser.h>
+#include <sinsp_with_test_input.h>
+
+using namespace libsinsp::filter;
+
+static std::string optimize(const std::string& filter,
+                            const std::vector<std::pair<std::string, bool>>& constants = {}) {
+	std::vector<std::unique_ptr<ast::expr>> asts;
+	std::vector<std::pair<const ast::expr*, bool>> c;
+	for(const auto& it : constants) {
+		asts.push_back(parser(it.first).parse());
+		c.emplace_back(asts.back().get(), it.second);
+	}
+	return ast::as_string(ast::optimize(parser(filter).parse().get(), c).get());
+}
+
+TEST(filter_optimizer, flatten) {
+	EXPECT_EQ(optimize("f.a = 1 and (f.b = 2 and (f.c = 3 and f.d = 4))"),
+	          "(f.a = 1 and f.b = 2 and f.c = 3 and f.d = 4)");
+	EXPECT_EQ(optimize("(f.a = 1 or f.b = 2) or (f.c = 3 or (f.d = 4 and f.e = 5))"),
+	          "(f.a = 1 or f.b = 2 or f.c = 3 or (f.d = 4 and f.e = 5))");
+	EXPECT_EQ(optimize("not not f.a = 1"), "f.a = 1");
+	EXPECT_EQ(optimize("not not not f.a = 1"), "not f.a = 1");
+	EXPECT_EQ(optimize("not (f.a = 1 and f.b = 2)"), "not (f.a = 1 and f.b = 2)");
+}
+
+TEST(filter_optimizer, duplicates) {
+	EXPECT_EQ(optimize("f.a = 1 and f.b = 2 and f.a = 1"), "(f.a = 1 and f.b = 2)");
+	EXPECT_EQ(optimize("(f.a = 1 or f.b exists) and (f.b exists or f.a = 1)"),
+	          "((f.a = 1 or f.b exists) and (f.b exists or f.a = 1))");
+	EXPECT_EQ(optimize("(f.a = 1 and f.b = 2) or (f.a = 1 and f.b = 2)"),
+	          "(f.a = 1 and f.b = 2)");
+}
+
+TEST(filter_optimizer, merge_in_checks) {
+	EXPECT_EQ(optimize("f.a = x or f.b = y or f.a = z or f.a in (w, x)"),
+	          "(f.a in (x, z, w) or f.b = y)");
+	EXPECT_EQ(optimize("f.a = x or f.a = y"), "f.a in (x, y)");
+	EXPECT_EQ(optimize("f.a[1] = x or f.a[2] = y"), "(f.a[1] = x or f.a[2] = y)");
+	EXPECT_EQ(optimize("tolower(f.a) = x or tolower(f.a) = y"), "tolower(f.a) in (x, y)");
+
+	// a field compared with 'in' only could be a list
+	EXPECT_EQ(optimize("f.a in (x) or f.a in (y)"), "(f.a in (x) or f.a in (y))");
+
+	// no merging in 'and' nodes, nor with other operators or fields
+	EXPECT_EQ(optimize("f.a = x and f.a = y"), "(f.a = x and f.a = y)");
+	EXPECT_EQ(optimize("f.a = x or f.a != y"), "(f.a = x or f.a != y)");
+	EXPECT_EQ(optimize("f.a = x or f.a = val(f.b)"), "(f.a = x or f.a = val(f.b))");
+}
+
+TEST(filter_optimizer, constants) {
+	EXPECT_EQ(optimize("f.a = 1 and evt.num >= 0"), "f.a = 1");
+	EXPECT_EQ(optimize("f.a = 1 or evt.num >= 0"), "evt.num >= 0");
+	EXPECT_EQ(optimize("f.a = 1 and not evt.num >= 0"), "not evt.num >= 0");
+	EXPECT_EQ(optimize("f.a = 1 and not f.a = 1"), "not evt.num >= 0");
+	EXPECT_EQ(optimize("(f.a = 1 or not f.a = 1) and f.b = 2"), "f.b = 2");
+	EXPECT_EQ(optimize("f.a = 1 and (f.b = 2 or not f.b = 2 and f.c = 3)"),
+	          "(f.a = 1 and (f.b = 2 or (not f.b = 2 and f.c = 3)))");
+
+	// user-defined constants
+	EXPECT_EQ(optimize("f.a = 1 and not (proc.name = never)", {{"proc.name = never", false}}),
+	          "f.a = 1");
+	EXPECT_EQ(optimize("f.a = 1 and (f.x = 1 or f.y = 2)", {{"(f.x = 1 or f.y = 2)", false}}),
+	          "not evt.num >= 0");
+	EXPECT_EQ(optimize("f.a = 1 or f.x = 1", {{"f.x = 1", true}}), "evt.num >= 0");
+}
+
+TEST_F(sinsp_with_test_input, filter_optimizer) {
+	add_default_init_thread();
+	open_inspector();
+
+	auto evt = generate_getcwd_failed_entry_event();
+	auto factory = std::make_shared<sinsp_filter_factory>(&m_inspector, m_default_filterlist);
+	for(const std::string str :
+	    {"evt.type = getcwd or evt.type = open or evt.type in (close, getcwd)",
+	     "evt.type = open or evt.type = close",
+	     "evt.dir = < and (evt.dir = < and (proc.name = init and evt.num >= 0))",
+	     "not not (proc.name = init and not proc.name = init)",
+	     "proc.name = init or not proc.name = init",
+	     "not (evt.type = getcwd or proc.name = x or evt.type = open)",
+	     "evt.type != open and evt.num >= 0 or proc.name in (x, y) or proc.name = z"}) {
+		auto ast = parser(str).parse();
+		auto optimized = ast::optimize(ast.get());
+		auto expected = sinsp_filter_compiler(factory, ast.get()).compile()->run(evt);
+		EXPECT_EQ(sinsp_filter_compiler(factory, optimized.get()).compile()->run(evt), expected)
+		        << str;
+	}
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <libsinsp/filter_set.h>
+#include <sinsp_with_test_input.h>
+
+TEST_F(sinsp_with_test_input, filter_set) {
+	add_default_init_thread();
+	open_inspector();
+
+	auto factory = std::make_shared<sinsp_filter_factory>(&m_inspector, m_default_filterlist);
+	sinsp_filter_set set(factory);
+	set.add(1, "syscall", "evt.type = open and fd.name startswith /tmp");
+	set.add(2, "syscall", "evt.type in (open, getcwd) and evt.res = SUCCESS");
+	set.add(3, "syscall", "evt.type = getcwd");
+	set.add(4, "syscall", "proc.name = init");
+	set.add(5, "other", "evt.type = open");
+	ASSERT_THROW(set.add(6, "syscall", "evt.type = "), sinsp_exception);
+	ASSERT_THROW(set.add(6, "syscall", "not.a.field = 1"), sinsp_exception);
+
+	ASSERT_EQ(set.size(), 5);
+	ASSERT_EQ(set.size("syscall", PPME_SYSCALL_OPEN_X), 3);
+	ASSERT_EQ(set.size("syscall", PPME_SYSCALL_GETCWD_E), 3);
+	ASSERT_EQ(set.size("syscall", PPME_SYSCALL_CLOSE_X), 1);
+	ASSERT_EQ(set.size("other", PPME_SYSCALL_OPEN_X), 1);
+	ASSERT_EQ(set.size("missing", PPME_SYSCALL_OPEN_X), 0);
+
+	std::vector<uint32_t> ids;
+	auto evt = add_event_advance_ts(increasing_ts(),
+	                                INIT_TID,
+	                                PPME_SYSCALL_OPEN_X,
+	                                6,
+	                                (int64_t)3,
+	                                "/tmp/the_file.txt",
+	                                0,
+	                                0,
+	                                0,
+	                                (uint64_t)0);
+	ASSERT_TRUE(set.run(evt, ids));
+	ASSERT_EQ(ids, std::vector<uint32_t>({1, 2, 4}));
+
+	evt = generate_getcwd_failed_entry_event();
+	ASSERT_TRUE(set.run(evt, ids));
+	ASSERT_EQ(ids, std::vector<uint32_t>({3, 4}));
+
+	// the IDs of the previous run are cleared when nothing matches
+	sinsp_filter_set empty(factory);
+	empty.add(1, "syscall", "evt.type = close");
+	ASSERT_FALSE(empty.run(evt, ids));
+	ASSERT_TRUE(ids.empty());
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <libsinsp/multi_string_matcher.h>
+
+TEST(multi_string_matcher, equals) {
+	multi_string_matcher m;
+	m.add_equals("/bin/sh");
+	m.add_equals("/bin/bash");
+	m.add_equals("/bin/sh");
+	m.build();
+
+	ASSERT_EQ(m.size(), 3);
+	ASSERT_TRUE(m.match("/bin/sh"));
+	ASSERT_TRUE(m.match("/bin/bash"));
+	ASSERT_FALSE(m.match("/bin/s"));
+	ASSERT_FALSE(m.match("/bin/shell"));
+	ASSERT_FALSE(m.match(""));
+}
+
+TEST(multi_string_matcher, prefixes) {
+	multi_string_matcher m;
+	m.add_prefix("/usr/lib/");
+	m.add_prefix("/etc");
+	m.add_prefix("/usr/lib/x86_64");
+	m.add_prefix("/usr/bin/");
+	m.add_prefix("/etc/ssh");
+	m.build();
+
+	ASSERT_TRUE(m.match("/etc"));
+	ASSERT_TRUE(m.match("/etc/ssh/sshd_config"));
+	ASSERT_TRUE(m.match("/etcetera"));
+	ASSERT_TRUE(m.match("/usr/lib/x86_64/libc.so"));
+	ASSERT_TRUE(m.match("/usr/lib/libfoo.so"));
+	ASSERT_TRUE(m.match("/usr/bin/ls"));
+	ASSERT_FALSE(m.match("/usr/lib"));
+	ASSERT_FALSE(m.match("/usr/local/bin/ls"));
+	ASSERT_FALSE(m.match("/et"));
+	ASSERT_FALSE(m.match("/var/log"));
+}
+
+TEST(multi_string_matcher, substrings) {
+	multi_string_matcher m;
+	m.add_substring("he");
+	m.add_substring("she");
+	m.add_substring("hers");
+	m.add_substring("his");
+	m.add_substring("xmrig");
+	m.build();
+
+	ASSERT_TRUE(m.match("ushers"));
+	ASSERT_TRUE(m.match("ahishe"));
+	ASSERT_TRUE(m.match("/tmp/xmrig --donate-level=1"));
+	ASSERT_TRUE(m.match("hhhe"));
+	ASSERT_FALSE(m.match("hxs"));
+	ASSERT_FALSE(m.match("xmri"));
+	ASSERT_FALSE(m.match(""));
+
+	// matches found through the failure links only
+	multi_string_matcher m2;
+	m2.add_substring("abcd");
+	m2.add_substring("bce");
+	m2.build();
+	ASSERT_TRUE(m2.match("zabce"));
+	ASSERT_FALSE(m2.match("abcbcd"));
+	ASSERT_TRUE(m2.match("abcbcdabcd"));
+}
+
+TEST(multi_string_matcher, mixed) {
+	multi_string_matcher m;
+	m.add_equals("sh");
+	m.add_prefix("/tmp/");
+	m.add_substring("nc -e");
+	m.build();
+
+	ASSERT_TRUE(m.match("sh"));
+	ASSERT_TRUE(m.match("/tmp/x"));
+	ASSERT_TRUE(m.match("bash -c nc -e /bin/sh"));
+	ASSERT_FALSE(m.match("bash"));
+}
+
+TEST(multi_string_matcher, empty_patterns) {
+	multi_string_matcher none;
+	none.build();
+	ASSERT_FALSE(none.match("anything"));
+
+	multi_string_matcher prefix;
+	prefix.add_prefix("");
+	prefix.build();
+	ASSERT_TRUE(prefix.match("anything"));
+	ASSERT_TRUE(prefix.match(""));
+
+	multi_string_matcher substring;
+	substring.add_substring("");
+	substring.build();
+	ASSERT_TRUE(substring.match("anything"));
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <libsinsp/net_prefix_search.h>
+#include <libsinsp/sinsp_inet.h>
+
+static ipv4net make_ipv4net(const char* ip, uint32_t prefix_len) {
+	ipv4net net;
+	inet_pton(AF_INET, ip, &net.m_ip);
+	net.m_netmask = prefix_len ? htonl(~0U << (32 - prefix_len)) : 0;
+	return net;
+}
+
+static uint32_t make_ipv4addr(const char* ip) {
+	uint32_t addr;
+	inet_pton(AF_INET, ip, &addr);
+	return addr;
+}
+
+TEST(net_prefix_search_test, ipv4) {
+	net_prefix_search nets;
+
+	ASSERT_FALSE(nets.match(make_ipv4addr("10.1.2.3")));
+
+	nets.add_network(make_ipv4net("10.0.0.0", 8));
+	nets.add_network(make_ipv4net("172.16.0.0", 12));
+	nets.add_network(make_ipv4net("192.168.1.7", 32));
+	nets.add_network(make_ipv4net("142.251.111.0", 25));
+
+	ASSERT_TRUE(nets.match(make_ipv4addr("10.1.2.3")));
+	ASSERT_TRUE(nets.match(make_ipv4addr("10.255.255.255")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("11.0.0.0")));
+
+	ASSERT_TRUE(nets.match(make_ipv4addr("172.16.0.1")));
+	ASSERT_TRUE(nets.match(make_ipv4addr("172.31.255.255")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("172.32.0.0")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("172.15.255.255")));
+
+	ASSERT_TRUE(nets.match(make_ipv4addr("192.168.1.7")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("192.168.1.6")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("192.168.1.8")));
+
+	ASSERT_TRUE(nets.match(make_ipv4addr("142.251.111.127")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("142.251.111.128")));
+
+	// the host bits of a network are not relevant
+	nets.add_network(make_ipv4net("8.8.8.8", 16));
+	ASSERT_TRUE(nets.match(make_ipv4addr("8.8.1.1")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("8.9.8.8")));
+}
+
+TEST(net_prefix_search_test, ipv4_overlapping) {
+	net_prefix_search nets;
+
+	// a network covering one already added replaces it, and networks added
+	// inside an existing one change nothing
+	nets.add_network(make_ipv4net("10.1.2.0", 24));
+	nets.add_network(make_ipv4net("10.0.0.0", 8));
+	nets.add_network(make_ipv4net("10.3.4.5", 32));
+	ASSERT_TRUE(nets.match(make_ipv4addr("10.1.2.3")));
+	ASSERT_TRUE(nets.match(make_ipv4addr("10.200.0.1")));
+	ASSERT_FALSE(nets.match(make_ipv4addr("9.255.255.255")));
+
+	nets.add_network(make_ipv4net("0.0.0.0", 0));
+	ASSERT_TRUE(nets.match(make_ipv4addr("1.2.3.4")));
+	ASSERT_TRUE(nets.match(make_ipv4addr("255.255.255.255")));
+}
+
+TEST(net_prefix_search_test, ipv6) {
+	net_prefix_search nets;
+
+	nets.add_network(ipv6net("2001:db8::/32"));
+	nets.add_network(ipv6net("fd00:1:2:3:8000::/65"));
+	nets.add_network(ipv6net("::1/128"));
+
+	ASSERT_TRUE(nets.match(ipv6addr("2001:db8:abcd::1")));
+	ASSERT_FALSE(nets.match(ipv6addr("2001:db9::1")));
+
+	ASSERT_TRUE(nets.match(ipv6addr("fd00:1:2:3:ffff::1")));
+	ASSERT_FALSE(nets.match(ipv6addr("fd00:1:2:3:7fff::1")));
+
+	ASSERT_TRUE(nets.match(ipv6addr("::1")));
+	ASSERT_FALSE(nets.match(ipv6addr("::2")));
+
+	// each address family has its own networks
+	ASSERT_FALSE(nets.match(make_ipv4addr("0.0.0.1")));
+	nets.add_network(make_ipv4net("0.0.0.0", 0));
+	ASSERT_FALSE(nets.match(ipv6addr("::2")));
+}
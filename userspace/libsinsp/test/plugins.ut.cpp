@@ -286,6 +286,52 @@ TEST_F(sinsp_with_test_input, plugin_syscall_extract) {
 	ASSERT_FALSE(field_has_value(evt, "sample.tick", pl_flist));
 }
 
+// scenario: all the fields of a plugin used by the compiled filters should be
+// extracted with a single call per event
+TEST_F(sinsp_with_test_input, plugin_syscall_extract_batch) {
+	filter_check_list pl_flist;
+	auto pl = register_plugin(&m_inspector, get_plugin_api_sample_syscall_extract_many);
+	add_plugin_filterchecks(&m_inspector, pl, sinsp_syscall_event_source_name, pl_flist);
+	auto factory = std::make_shared<sinsp_filter_factory>(&m_inspector, pl_flist);
+
+	// the number of calls is checked last on purpose
+	auto f1 = sinsp_filter_compiler(factory,
+	                                "many.type = 2 and many.tid = 1 and many.len > 0 and "
+	                                "many.nparams = 3 and many.hex exists and many.byte[0] exists "
+	                                "and many.calls = 1")
+	                  .compile();
+	auto f2 = sinsp_filter_compiler(factory, "many.tid = 1 and many.calls = 1").compile();
+	auto f3 = sinsp_filter_compiler(factory, "many.calls = 2").compile();
+
+	add_default_init_thread();
+	open_inspector();
+
+	auto evt = add_event_advance_ts(increasing_ts(),
+	                                1,
+	                                PPME_SYSCALL_OPEN_E,
+	                                3,
+	                                "/tmp/the_file",
+	                                PPM_O_RDWR,
+	                                0);
+	ASSERT_TRUE(f1->run(evt));
+	ASSERT_TRUE(f2->run(evt));
+	ASSERT_FALSE(f3->run(evt));
+
+	evt = add_event_advance_ts(increasing_ts(),
+	                           1,
+	                           PPME_SYSCALL_OPEN_X,
+	                           6,
+	                           (uint64_t)3,
+	                           "/tmp/the_file",
+	                           PPM_O_RDWR,
+	                           0,
+	                           5,
+	                           (uint64_t)123);
+	ASSERT_FALSE(f1->run(evt));
+	ASSERT_FALSE(f2->run(evt));
+	ASSERT_TRUE(f3->run(evt));
+}
+
 // scenario: an event sourcing plugin should produce events of "syscall"
 // event source and we should be able to extract filter values implemented
 // by both libsinsp and another plugin with field extraction capability
@@ -19,6 +19,8 @@ limitations under the License.
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <driver/ppm_events_public.h>
 
@@ -36,9 +38,10 @@ namespace {
  */
 struct plugin_state {
 	std::string lasterr;
-	uint64_t u64storage;
-	std::string strstorage;
-	const char* strptrstorage;
+	// one result for each of the fields extracted at once
+	std::vector<uint64_t> u64storage;
+	std::vector<std::string> strstorage;
+	std::vector<const char*> strptrstorage;
 	ss_plugin_table_t* thread_table;
 	ss_plugin_table_field_t* thread_comm_field;
 	ss_plugin_table_field_t* thread_opencount_field;
@@ -235,11 +238,14 @@ ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
 	ss_plugin_table_entry_t* thread = NULL;
 	ss_plugin_table_entry_t* evtcount = NULL;
 	auto ps = reinterpret_cast<plugin_state*>(s);
+	ps->u64storage.resize(in->num_fields);
+	ps->strstorage.resize(in->num_fields);
+	ps->strptrstorage.resize(in->num_fields);
 	for(uint32_t i = 0; i < in->num_fields; i++) {
 		switch(in->fields[i].field_id) {
 		case 0:  // sample.is_open
-			ps->u64storage = evt_type_is_open(ev->evt->type);
-			in->fields[i].res.u64 = &ps->u64storage;
+			ps->u64storage[i] = evt_type_is_open(ev->evt->type);
+			in->fields[i].res.u64 = &ps->u64storage[i];
 			in->fields[i].res_len = 1;
 			break;
 		case 1:  // sample.open_count
@@ -268,8 +274,8 @@ ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
 				in->table_reader_ext->release_table_entry(ps->thread_table, thread);
 				return SS_PLUGIN_FAILURE;
 			}
-			ps->u64storage = tmp.u64;
-			in->fields[i].res.u64 = &ps->u64storage;
+			ps->u64storage[i] = tmp.u64;
+			in->fields[i].res.u64 = &ps->u64storage[i];
 			in->fields[i].res_len = 1;
 			in->table_reader_ext->release_table_entry(ps->thread_table, thread);
 			break;
@@ -299,10 +305,10 @@ ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
 			evtcount = in->table_reader.get_table_entry(ps->evtcount_table, &tmp);
 			if(!evtcount) {
 				// stubbing the counter to 0 if no entry exists
-				ps->u64storage = 0;
-				in->fields[i].res.u64 = &ps->u64storage;
+				ps->u64storage[i] = 0;
+				in->fields[i].res.u64 = &ps->u64storage[i];
 				in->fields[i].res_len = 1;
-				return SS_PLUGIN_SUCCESS;
+				break;
 			}
 			rc = in->table_reader.read_entry_field(ps->evtcount_table,
 			                                       evtcount,
@@ -316,8 +322,8 @@ ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
 				in->table_reader_ext->release_table_entry(ps->evtcount_table, evtcount);
 				return SS_PLUGIN_FAILURE;
 			}
-			ps->u64storage = tmp.u64;
-			in->fields[i].res.u64 = &ps->u64storage;
+			ps->u64storage[i] = tmp.u64;
+			in->fields[i].res.u64 = &ps->u64storage[i];
 			in->fields[i].res_len = 1;
 			in->table_reader_ext->release_table_entry(ps->evtcount_table, evtcount);
 			break;
@@ -342,21 +348,21 @@ ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
 				in->table_reader_ext->release_table_entry(ps->thread_table, thread);
 				return SS_PLUGIN_FAILURE;
 			}
-			ps->strstorage = std::string(tmp.str);
-			ps->strptrstorage = ps->strstorage.c_str();
-			in->fields[i].res.str = &ps->strptrstorage;
+			ps->strstorage[i] = std::string(tmp.str);
+			ps->strptrstorage[i] = ps->strstorage[i].c_str();
+			in->fields[i].res.str = &ps->strptrstorage[i];
 			in->fields[i].res_len = 1;
 			in->table_reader_ext->release_table_entry(ps->thread_table, thread);
 			break;
 		case 4:  // sample.tick
 			if(ev->evt->type == PPME_ASYNCEVENT_E &&
 			   strcmp("sampleticker", get_async_event_name(ev->evt)) == 0) {
-				ps->strstorage = "true";
+				ps->strstorage[i] = "true";
 			} else {
-				ps->strstorage = "false";
+				ps->strstorage[i] = "false";
 			}
-			ps->strptrstorage = ps->strstorage.c_str();
-			in->fields[i].res.str = &ps->strptrstorage;
+			ps->strptrstorage[i] = ps->strstorage[i].c_str();
+			in->fields[i].res.str = &ps->strptrstorage[i];
 			in->fields[i].res_len = 1;
 			break;
 		default:
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <driver/ppm_events_public.h>
+
+#include "test_plugins.h"
+
+namespace {
+
+/**
+ * Example of plugin implementing only the field extraction capability, which:
+ * - Is compatible with the "syscall" event source only
+ * - Decodes the whole event at each extraction request, like plugins that
+ *   parse a JSON payload do, and exposes many fields of the decoded event
+ * - Counts the extraction requests it receives
+ */
+struct plugin_state {
+	std::string lasterr;
+	uint64_t num_calls = 0;
+
+	// the decoded event
+	std::string hex;
+	std::vector<uint8_t> bytes;
+
+	// one result for each of the fields extracted at once
+	std::vector<uint64_t> u64storage;
+	std::vector<std::string> strstorage;
+	std::vector<const char*> strptrstorage;
+};
+
+const char* plugin_get_required_api_version() {
+	return PLUGIN_API_VERSION_STR;
+}
+
+const char* plugin_get_version() {
+	return "0.1.0";
+}
+
+const char* plugin_get_name() {
+	return "sample_syscall_extract_many";
+}
+
+const char* plugin_get_description() {
+	return "some desc";
+}
+
+const char* plugin_get_contact() {
+	return "some contact";
+}
+
+const char* plugin_get_fields() {
+	return R"(
+[
+	{"type": "uint64", "name": "many.calls", "desc": "Number of extraction requests"},
+	{"type": "uint64", "name": "many.type", "desc": "Type of the event"},
+	{"type": "uint64", "name": "many.tid", "desc": "Thread ID of the event"},
+	{"type": "uint64", "name": "many.len", "desc": "Length of the event"},
+	{"type": "uint64", "name": "many.nparams", "desc": "Number of parameters of the event"},
+	{"type": "string", "name": "many.hex", "desc": "Hex dump of the event payload"},
+	{
+		"type": "uint64",
+		"name": "many.byte",
+		"desc": "Byte of the event payload at the given index",
+		"arg": {"isRequired": true, "isIndex": true}
+	}
+])";
+}
+
+const char* plugin_get_extract_event_sources() {
+	return "[\"syscall\"]";
+}
+
+ss_plugin_t* plugin_init(const ss_plugin_init_input* in, ss_plugin_rc* rc) {
+	*rc = SS_PLUGIN_SUCCESS;
+	return new plugin_state();
+}
+
+void plugin_destroy(ss_plugin_t* s) {
+	delete reinterpret_cast<plugin_state*>(s);
+}
+
+const char* plugin_get_last_error(ss_plugin_t* s) {
+	return ((plugin_state*)s)->lasterr.c_str();
+}
+
+void decode_event(plugin_state* ps, const ss_plugin_event* evt) {
+	static const char digits[] = "0123456789abcdef";
+	auto payload = (const uint8_t*)evt + sizeof(ss_plugin_event);
+	auto len = evt->len - sizeof(ss_plugin_event);
+	ps->bytes.assign(payload, payload + len);
+	ps->hex.clear();
+	for(auto b : ps->bytes) {
+		ps->hex += digits[b >> 4];
+		ps->hex += digits[b & 0xf];
+	}
+}
+
+ss_plugin_rc plugin_extract_fields(ss_plugin_t* s,
+                                   const ss_plugin_event_input* ev,
+                                   const ss_plugin_field_extract_input* in) {
+	auto ps = reinterpret_cast<plugin_state*>(s);
+	ps->num_calls++;
+	decode_event(ps, ev->evt);
+
+	ps->u64storage.resize(in->num_fields);
+	ps->strstorage.resize(in->num_fields);
+	ps->strptrstorage.resize(in->num_fields);
+	for(uint32_t i = 0; i < in->num_fields; i++) {
+		auto& f = in->fields[i];
+		f.res.u64 = &ps->u64storage[i];
+		f.res_len = 1;
+		switch(f.field_id) {
+		case 0:  // many.calls
+			ps->u64storage[i] = ps->num_calls;
+			break;
+		case 1:  // many.type
+			ps->u64storage[i] = ev->evt->type;
+			break;
+		case 2:  // many.tid
+			ps->u64storage[i] = ev->evt->tid;
+			break;
+		case 3:  // many.len
+			ps->u64storage[i] = ev->evt->len;
+			break;
+		case 4:  // many.nparams
+			ps->u64storage[i] = ev->evt->nparams;
+			break;
+		case 5:  // many.hex
+			ps->strstorage[i] = ps->hex;
+			ps->strptrstorage[i] = ps->strstorage[i].c_str();
+			f.res.str = &ps->strptrstorage[i];
+			break;
+		case 6:  // many.byte
+			if(f.arg_index >= ps->bytes.size()) {
+				f.res_len = 0;
+				break;
+			}
+			ps->u64storage[i] = ps->bytes[f.arg_index];
+			break;
+		default:
+			f.res_len = 0;
+			ps->lasterr = "unknown field: " + std::to_string(f.field_id);
+			return SS_PLUGIN_FAILURE;
+		}
+	}
+	return SS_PLUGIN_SUCCESS;
+}
+
+}  // anonymous namespace
+
+void get_plugin_api_sample_syscall_extract_many(plugin_api& out) {
+	memset(&out, 0, sizeof(plugin_api));
+	out.get_required_api_version = plugin_get_required_api_version;
+	out.get_version = plugin_get_version;
+	out.get_description = plugin_get_description;
+	out.get_contact = plugin_get_contact;
+	out.get_name = plugin_get_name;
+	out.get_last_error = plugin_get_last_error;
+	out.init = plugin_init;
+	out.destroy = plugin_destroy;
+	out.get_fields = plugin_get_fields;
+	out.get_extract_event_sources = plugin_get_extract_event_sources;
+	out.extract_fields = plugin_extract_fields;
+}
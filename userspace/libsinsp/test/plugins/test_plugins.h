@@ -21,6 +21,7 @@ limitations under the License.
 
 void get_plugin_api_sample_syscall_source(plugin_api& out);
 void get_plugin_api_sample_syscall_extract(plugin_api& out);
+void get_plugin_api_sample_syscall_extract_many(plugin_api& out);
 void get_plugin_api_sample_syscall_parse(plugin_api& out);
 void get_plugin_api_sample_syscall_async(plugin_api& out);
 void get_plugin_api_sample_plugin_source(plugin_api& out);
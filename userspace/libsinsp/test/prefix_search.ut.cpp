@@ -108,6 +108,31 @@ TEST(prefix_search_test, glob) {
 	ASSERT_TRUE(found);
 }
 
+TEST(prefix_search_test, glob_siblings) {
+	path_prefix_search tree;
+
+	tree.add_search_path("/opt/a*/subdir");
+	tree.add_search_path("/opt/*b/subdir2");
+	tree.add_search_path("/opt/?b/subdir3");
+
+	ASSERT_TRUE(tree.match("/opt/ab/subdir"));
+	ASSERT_TRUE(tree.match("/opt/ab/subdir2"));
+	ASSERT_TRUE(tree.match("/opt/ab/subdir3/file.txt"));
+	ASSERT_FALSE(tree.match("/opt/ab/subdir4"));
+	ASSERT_FALSE(tree.match("/opt/ab"));
+}
+
+TEST(prefix_search_test, match_after_add) {
+	path_prefix_search tree;
+
+	tree.add_search_path("/var/run");
+	ASSERT_FALSE(tree.match("/etc/passwd"));
+
+	tree.add_search_path("/etc");
+	ASSERT_TRUE(tree.match("/etc/passwd"));
+	ASSERT_TRUE(tree.match("//var///run/docker.sock"));
+}
+
 TEST(prefix_search_test, subpaths) {
 	path_prefix_search tree;
 
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2024 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/slab_allocator.h>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct pooled {
+	uint64_t a;
+	uint64_t b;
+	uint64_t c;
+
+	static void* operator new(size_t size) { return libsinsp::slab_new<pooled>(size); }
+	static void operator delete(void* p, size_t size) {
+		libsinsp::slab_delete<pooled>(p, size);
+	}
+	virtual ~pooled() = default;
+};
+
+struct bigger : public pooled {
+	char pad[256];
+};
+
+}  // namespace
+
+TEST(slab_allocator, reuse_freed_blocks) {
+	using pool = libsinsp::slab_pool<40, 8>;
+	void* p = pool::allocate();
+	pool::deallocate(p);
+	ASSERT_EQ(pool::allocate(), p);
+	pool::deallocate(p);
+}
+
+TEST(slab_allocator, free_from_another_thread) {
+	using pool = libsinsp::slab_pool<48, 8>;
+	std::vector<void*> blocks;
+	for(int i = 0; i < 1000; i++) {
+		blocks.push_back(pool::allocate());
+	}
+	ASSERT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), blocks.size());
+
+	std::thread t([&blocks] {
+		for(auto b : blocks) {
+			pool::deallocate(b);
+		}
+	});
+	t.join();
+
+	// the exiting thread handed its blocks back to the depot, so they are all
+	// reused before any new slab gets allocated
+	std::set<void*> freed(blocks.begin(), blocks.end());
+	std::vector<void*> again;
+	for(int i = 0; i < 1100; i++) {
+		void* p = pool::allocate();
+		freed.erase(p);
+		again.push_back(p);
+	}
+	ASSERT_TRUE(freed.empty());
+	for(auto b : again) {
+		pool::deallocate(b);
+	}
+}
+
+TEST(slab_allocator, subclasses_use_the_heap) {
+	std::unique_ptr<pooled> a(new pooled());
+	std::unique_ptr<pooled> b(new bigger());
+	b->a = 1;
+	static_cast<bigger*>(b.get())->pad[255] = 1;
+	a.reset();
+	b.reset();
+}
+
+TEST(slab_allocator, make_slab_shared) {
+	ASSERT_EQ(libsinsp::make_slab_shared(std::unique_ptr<pooled>()), nullptr);
+
+	auto p = libsinsp::make_slab_shared(std::make_unique<pooled>());
+	p->a = 42;
+	std::weak_ptr<pooled> w = p;
+	auto copy = p;
+	ASSERT_EQ(p.use_count(), 2);
+	p.reset();
+	copy.reset();
+	ASSERT_TRUE(w.expired());
+}
@@ -291,6 +291,47 @@ TEST(dynamic_struct, mem_ownership) {
 	ASSERT_NE(tmpstr1, tmpstr2);
 }
 
+TEST(dynamic_struct, fields_added_after_access) {
+	struct sample_struct : public libsinsp::state::dynamic_struct {
+		sample_struct(const std::shared_ptr<field_infos>& i): dynamic_struct(i) {}
+	};
+
+	auto defs = std::make_shared<libsinsp::state::dynamic_struct::field_infos>();
+	auto acc_u8 = defs->add_field<uint8_t>("u8").new_accessor<uint8_t>();
+	auto acc_str = defs->add_field<std::string>("str").new_accessor<std::string>();
+
+	sample_struct s(defs);
+	s.set_dynamic_field(acc_u8, (uint8_t)3);
+	s.set_dynamic_field(acc_str, std::string("a string too long for small string optimizations"));
+
+	// new definitions grow the storage of the structs that already have fields,
+	// without losing their values
+	auto acc_u64 = defs->add_field<uint64_t>("u64").new_accessor<uint64_t>();
+	auto acc_str2 = defs->add_field<std::string>("str2").new_accessor<std::string>();
+	s.set_dynamic_field(acc_u64, (uint64_t)0x1122334455667788);
+	s.set_dynamic_field(acc_str2, std::string("hello"));
+
+	uint8_t u8;
+	uint64_t u64;
+	std::string str;
+	s.get_dynamic_field(acc_u8, u8);
+	ASSERT_EQ(u8, 3);
+	s.get_dynamic_field(acc_u64, u64);
+	ASSERT_EQ(u64, 0x1122334455667788);
+	s.get_dynamic_field(acc_str, str);
+	ASSERT_EQ(str, "a string too long for small string optimizations");
+	s.get_dynamic_field(acc_str2, str);
+	ASSERT_EQ(str, "hello");
+
+	// moved-from structs can still be accessed
+	sample_struct s2(std::move(s));
+	s2.get_dynamic_field(acc_str, str);
+	ASSERT_EQ(str, "a string too long for small string optimizations");
+	s = sample_struct(defs);
+	s.get_dynamic_field(acc_u64, u64);
+	ASSERT_EQ(u64, 0);
+}
+
 TEST(table_registry, defs_and_access) {
 	class sample_table : public libsinsp::state::table<uint64_t> {
 	public:
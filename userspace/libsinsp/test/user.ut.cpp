@@ -204,6 +204,43 @@ TEST_F(usergroup_manager_host_root_test, host_root_lookup) {
 	ASSERT_STREQ(group->name, "toor");
 }
 
+TEST_F(usergroup_manager_host_root_test, host_root_file_index) {
+	std::string container_id;
+
+	sinsp_usergroup_manager mgr(&m_inspector);
+	const auto& stats = mgr.get_file_index_stats();
+
+	// the file is parsed once for all the lookups
+	ASSERT_NE(mgr.add_user(container_id, -1, 0, 0, {}, {}, {}), nullptr);
+	ASSERT_EQ(mgr.add_user(container_id, -1, 1000, 0, {}, {}, {}), nullptr);
+	ASSERT_TRUE(mgr.rm_user(container_id, 0));
+	ASSERT_NE(mgr.add_user(container_id, -1, 0, 0, {}, {}, {}), nullptr);
+	ASSERT_EQ(mgr.add_user(container_id, -1, 1000, 0, {}, {}, {}), nullptr);
+	ASSERT_EQ(stats.m_reloads, 1);
+	ASSERT_EQ(stats.m_hits, 2);
+	ASSERT_EQ(stats.m_misses, 2);
+
+	// the file is parsed again once it changes
+	{
+		std::ofstream ofs(m_host_root + "/etc/passwd", std::ios_base::app);
+		ofs << "foo:x:1000:1001:foo:/home/foo:/bin/bash\n";
+	}
+	auto* user = mgr.add_user(container_id, -1, 1000, 0, {}, {}, {});
+	ASSERT_NE(user, nullptr);
+	ASSERT_EQ(user->gid, 1001);
+	ASSERT_STREQ(user->name, "foo");
+	ASSERT_STREQ(user->homedir, "/home/foo");
+	ASSERT_STREQ(user->shell, "/bin/bash");
+	ASSERT_EQ(stats.m_reloads, 2);
+	ASSERT_EQ(stats.m_hits, 3);
+
+	ASSERT_NE(mgr.add_group(container_id, -1, 0, {}), nullptr);
+	ASSERT_EQ(mgr.add_group(container_id, -1, 1000, {}), nullptr);
+	ASSERT_EQ(stats.m_reloads, 3);
+	ASSERT_EQ(stats.m_hits, 4);
+	ASSERT_EQ(stats.m_misses, 3);
+}
+
 TEST_F(usergroup_manager_host_root_test, nss_user_lookup) {
 	std::string container_id;  // empty container_id means host
 
@@ -165,33 +165,36 @@ sinsp_threadinfo::~sinsp_threadinfo() {
 	}
 }
 
+void sinsp_threadinfo::fix_socket_coming_from_proc(sinsp_fdinfo& fdi) {
+	if(fdi.m_type == SCAP_FD_IPV4_SOCK) {
+		if(m_inspector->m_thread_manager->m_server_ports.find(
+		           fdi.m_sockinfo.m_ipv4info.m_fields.m_sport) !=
+		   m_inspector->m_thread_manager->m_server_ports.end()) {
+			uint32_t tip;
+			uint16_t tport;
+
+			tip = fdi.m_sockinfo.m_ipv4info.m_fields.m_sip;
+			tport = fdi.m_sockinfo.m_ipv4info.m_fields.m_sport;
+
+			fdi.m_sockinfo.m_ipv4info.m_fields.m_sip = fdi.m_sockinfo.m_ipv4info.m_fields.m_dip;
+			fdi.m_sockinfo.m_ipv4info.m_fields.m_dip = tip;
+			fdi.m_sockinfo.m_ipv4info.m_fields.m_sport = fdi.m_sockinfo.m_ipv4info.m_fields.m_dport;
+			fdi.m_sockinfo.m_ipv4info.m_fields.m_dport = tport;
+
+			fdi.m_name =
+			        ipv4tuple_to_string(&fdi.m_sockinfo.m_ipv4info,
+			                            m_inspector->is_hostname_and_port_resolution_enabled());
+
+			fdi.set_role_server();
+		} else {
+			fdi.set_role_client();
+		}
+	}
+}
+
 void sinsp_threadinfo::fix_sockets_coming_from_proc() {
 	m_fdtable.loop([this](int64_t fd, sinsp_fdinfo& fdi) {
-		if(fdi.m_type == SCAP_FD_IPV4_SOCK) {
-			if(m_inspector->m_thread_manager->m_server_ports.find(
-			           fdi.m_sockinfo.m_ipv4info.m_fields.m_sport) !=
-			   m_inspector->m_thread_manager->m_server_ports.end()) {
-				uint32_t tip;
-				uint16_t tport;
-
-				tip = fdi.m_sockinfo.m_ipv4info.m_fields.m_sip;
-				tport = fdi.m_sockinfo.m_ipv4info.m_fields.m_sport;
-
-				fdi.m_sockinfo.m_ipv4info.m_fields.m_sip = fdi.m_sockinfo.m_ipv4info.m_fields.m_dip;
-				fdi.m_sockinfo.m_ipv4info.m_fields.m_dip = tip;
-				fdi.m_sockinfo.m_ipv4info.m_fields.m_sport =
-				        fdi.m_sockinfo.m_ipv4info.m_fields.m_dport;
-				fdi.m_sockinfo.m_ipv4info.m_fields.m_dport = tport;
-
-				fdi.m_name =
-				        ipv4tuple_to_string(&fdi.m_sockinfo.m_ipv4info,
-				                            m_inspector->is_hostname_and_port_resolution_enabled());
-
-				fdi.set_role_server();
-			} else {
-				fdi.set_role_client();
-			}
-		}
+		fix_socket_coming_from_proc(fdi);
 		return true;
 	});
 }
@@ -247,8 +250,7 @@ void sinsp_threadinfo::compute_program_hash() {
 	}
 }
 
-void sinsp_threadinfo::add_fd_from_scap(scap_fdinfo* fdi) {
-	auto newfdi = m_inspector->build_fdinfo();
+bool sinsp_threadinfo::set_fdinfo_from_scap(sinsp_fdinfo* newfdi, scap_fdinfo* fdi) {
 	bool do_add = true;
 
 	newfdi->m_type = fdi->type;
@@ -374,6 +376,7 @@ void sinsp_threadinfo::add_fd_from_scap(scap_fdinfo* fdi) {
 	case SCAP_FD_IOURING:
 	case SCAP_FD_MEMFD:
 	case SCAP_FD_PIDFD:
+	case SCAP_FD_UNKNOWN:
 		newfdi->m_name = fdi->info.fname;
 		break;
 	default:
@@ -382,6 +385,20 @@ void sinsp_threadinfo::add_fd_from_scap(scap_fdinfo* fdi) {
 		break;
 	}
 
+	return do_add;
+}
+
+void sinsp_threadinfo::add_fd_from_scap(scap_fdinfo* fdi, bool deferred) {
+	auto newfdi = m_inspector->build_fdinfo();
+	bool do_add = set_fdinfo_from_scap(newfdi.get(), fdi);
+
+	if(deferred) {
+		newfdi->m_flags |= sinsp_fdinfo::FLAGS_DEFERRED;
+		if(m_inspector->get_sinsp_stats_v2() != nullptr) {
+			m_inspector->get_sinsp_stats_v2()->m_n_deferred_fds++;
+		}
+	}
+
 	//
 	// Add the FD to the table
 	//
@@ -438,6 +455,29 @@ void sinsp_threadinfo::add_fd_from_scap(scap_fdinfo* fdi) {
 	}
 }
 
+void sinsp_threadinfo::resolve_deferred_fd(sinsp_fdinfo* fdinfo) {
+	fdinfo->m_flags &= ~sinsp_fdinfo::FLAGS_DEFERRED;
+
+	//
+	// The fd was only recorded by a lazy /proc scan: read its details now.
+	// If it is gone in the meantime we keep what we already know about it.
+	//
+	scap_fdinfo scap_fdi = {};
+	scap_fdi.fd = fdinfo->m_fd;
+	char error[SCAP_LASTERR_SIZE];
+	if(scap_get_fdinfo(m_inspector->get_scap_platform(), m_pid, &scap_fdi, error) !=
+	   SCAP_SUCCESS) {
+		return;
+	}
+
+	set_fdinfo_from_scap(fdinfo, &scap_fdi);
+	fix_socket_coming_from_proc(*fdinfo);
+
+	if(m_inspector->get_sinsp_stats_v2() != nullptr) {
+		m_inspector->get_sinsp_stats_v2()->m_n_resolved_fds++;
+	}
+}
+
 void sinsp_threadinfo::init(scap_threadinfo* pi) {
 	init();
 
@@ -1375,7 +1415,7 @@ const std::shared_ptr<sinsp_threadinfo>& sinsp_thread_manager::add_thread(
 		return m_nullptr_tinfo_ret;
 	}
 
-	auto tinfo_shared_ptr = std::shared_ptr<sinsp_threadinfo>(std::move(threadinfo));
+	auto tinfo_shared_ptr = libsinsp::make_slab_shared(std::move(threadinfo));
 
 	if(!from_scap_proctable) {
 		create_thread_dependencies(tinfo_shared_ptr);
@@ -1817,6 +1857,9 @@ void sinsp_thread_manager::dump_threads_to_file(scap_dumper_t* dumper) {
 				//
 				// Populate the fd info
 				//
+				if(info.is_deferred()) {
+					tinfo.resolve_deferred_fd(&info);
+				}
 				fd_to_scap(scfdinfo, &info);
 
 				//
@@ -125,6 +125,12 @@ public:
 	                         dyn_fields = nullptr);
 	virtual ~sinsp_threadinfo();
 
+	// processes come and go all the time, so their entries come from a pool
+	static void* operator new(size_t size) { return libsinsp::slab_new<sinsp_threadinfo>(size); }
+	static void operator delete(void* p, size_t size) {
+		libsinsp::slab_delete<sinsp_threadinfo>(p, size);
+	}
+
 	libsinsp::state::static_struct::field_infos static_fields() const override;
 
 	/*!
@@ -298,6 +304,10 @@ public:
 		if(fdt) {
 			sinsp_fdinfo* fdinfo = fdt->find(fd);
 			if(fdinfo) {
+				if(fdinfo->is_deferred()) {
+					resolve_deferred_fd(fdinfo);
+				}
+
 				// Its current name is now its old
 				// name. The name might change as a
 				// result of parsing.
@@ -578,7 +588,8 @@ public:
 	void init(scap_threadinfo* pi);
 	void fix_sockets_coming_from_proc();
 	sinsp_fdinfo* add_fd(int64_t fd, std::unique_ptr<sinsp_fdinfo> fdinfo);
-	void add_fd_from_scap(scap_fdinfo* fdinfo);
+	void add_fd_from_scap(scap_fdinfo* fdinfo, bool deferred = false);
+	void resolve_deferred_fd(sinsp_fdinfo* fdinfo);
 	void remove_fd(int64_t fd);
 	void update_cwd(std::string_view cwd);
 	void set_args(const char* args, size_t len);
@@ -622,6 +633,8 @@ public:
 
 private:
 	sinsp_threadinfo* get_cwd_root();
+	bool set_fdinfo_from_scap(sinsp_fdinfo* fdinfo, scap_fdinfo* fdi);
+	void fix_socket_coming_from_proc(sinsp_fdinfo& fdi);
 	bool set_env_from_proc();
 	size_t strvec_len(const std::vector<std::string>& strs) const;
 	void strvec_to_iovec(const std::vector<std::string>& strs,
@@ -44,65 +44,24 @@ limitations under the License.
 
 #endif
 
-#ifdef HAVE_PWD_H
-static struct passwd *__getpwuid(uint32_t uid, const std::string &host_root) {
-	if(host_root.empty()) {
-		// When we don't have any host root set,
-		// leverage NSS (see man nsswitch.conf)
-		return getpwuid(uid);
-	}
-
-	// If we have a host root and we can use fgetpwent,
-	// we take the entry directly from file
 #ifdef HAVE_FGET__ENT
-	static std::string filename(host_root + "/etc/passwd");
-
-	auto f = fopen(filename.c_str(), "r");
-	if(f) {
-		struct passwd *p = nullptr;
-		while((p = fgetpwent(f))) {
-			if(uid == p->pw_uid) {
-				break;
-			}
-		}
-
-		fclose(f);
-		return p;
-	}
+#include <sys/stat.h>
 #endif
-	return nullptr;
-}
-#endif
-
-#ifdef HAVE_GRP_H
-static struct group *__getgrgid(uint32_t gid, const std::string &host_root) {
-	if(host_root.empty()) {
-		// When we don't have any host root set,
-		// leverage NSS (see man nsswitch.conf)
-		return getgrgid(gid);
-	}
 
-	// If we have a host root and we can use fgetgrent,
-	// we take the entry directly from file
-#ifdef HAVE_FGET__ENT
-	static std::string filename(host_root + "/etc/group");
-
-	auto f = fopen(filename.c_str(), "r");
-	if(f) {
-		struct group *p = nullptr;
-		while((p = fgetgrent(f))) {
-			if(gid == p->gr_gid) {
-				break;
-			}
-		}
-
-		fclose(f);
-		return p;
+// Looks up an id in the index of a passwd or group file
+template<typename Map>
+static const typename Map::mapped_type *find_entry(
+        const Map &entries,
+        uint32_t id,
+        sinsp_usergroup_manager::file_index_stats &stats) {
+	auto it = entries.find(id);
+	if(it == entries.end()) {
+		stats.m_misses++;
+		return nullptr;
 	}
-#endif
-	return NULL;
+	stats.m_hits++;
+	return &it->second;
 }
-#endif
 
 using namespace std;
 
@@ -185,6 +144,8 @@ void sinsp_usergroup_manager::delete_container_users_groups(const sinsp_containe
 
 	m_userlist.erase(cinfo.m_id);
 	m_grouplist.erase(cinfo.m_id);
+	m_container_passwd.erase(cinfo.m_id);
+	m_container_group.erase(cinfo.m_id);
 }
 
 bool sinsp_usergroup_manager::clear_host_users_groups() {
@@ -250,6 +211,81 @@ scap_groupinfo *sinsp_usergroup_manager::groupinfo_map_insert(groupinfo_map &map
 	return &grp;
 }
 
+sinsp_usergroup_manager::file_stamp sinsp_usergroup_manager::get_file_stamp(
+        const std::string &path) {
+	file_stamp stamp;
+#ifdef HAVE_FGET__ENT
+	struct stat st;
+	if(stat(path.c_str(), &st) == 0) {
+		stamp.dev = st.st_dev;
+		stamp.ino = st.st_ino;
+		stamp.size = st.st_size;
+		stamp.mtime_ns = st.st_mtim.tv_sec * ONE_SECOND_IN_NS + st.st_mtim.tv_nsec;
+	}
+#endif
+	return stamp;
+}
+
+bool sinsp_usergroup_manager::load_passwd_index(passwd_index &index, const std::string &path) {
+	auto stamp = get_file_stamp(path);
+	if(index.loaded && index.stamp == stamp) {
+		return false;
+	}
+
+	index.loaded = true;
+	index.stamp = stamp;
+	index.entries.clear();
+	m_file_index_stats.m_reloads++;
+#if defined(HAVE_PWD_H) && defined(HAVE_FGET__ENT)
+	auto f = fopen(path.c_str(), "r");
+	if(f) {
+		while(auto p = fgetpwent(f)) {
+			// ignore NSS entries, and keep the first entry of each uid
+			// as getpwuid() does
+			if(p->pw_name != nullptr && (p->pw_name[0] == '+' || p->pw_name[0] == '-')) {
+				continue;
+			}
+			// In case the node is configured to use NIS,
+			// some struct passwd* fields may be set to NULL.
+			index.entries.try_emplace(p->pw_uid,
+			                          passwd_entry{p->pw_gid,
+			                                       p->pw_name ? p->pw_name : "<NA>",
+			                                       p->pw_dir ? p->pw_dir : "<NA>",
+			                                       p->pw_shell ? p->pw_shell : "<NA>"});
+		}
+		fclose(f);
+	}
+#endif
+	return true;
+}
+
+bool sinsp_usergroup_manager::load_group_index(group_index &index, const std::string &path) {
+	auto stamp = get_file_stamp(path);
+	if(index.loaded && index.stamp == stamp) {
+		return false;
+	}
+
+	index.loaded = true;
+	index.stamp = stamp;
+	index.entries.clear();
+	m_file_index_stats.m_reloads++;
+#if defined(HAVE_GRP_H) && defined(HAVE_FGET__ENT)
+	auto f = fopen(path.c_str(), "r");
+	if(f) {
+		while(auto g = fgetgrent(f)) {
+			// ignore NSS entries, and keep the first entry of each gid
+			// as getgrgid() does
+			if(g->gr_name != nullptr && (g->gr_name[0] == '+' || g->gr_name[0] == '-')) {
+				continue;
+			}
+			index.entries.try_emplace(g->gr_gid, g->gr_name ? g->gr_name : "<NA>");
+		}
+		fclose(f);
+	}
+#endif
+	return true;
+}
+
 scap_userinfo *sinsp_usergroup_manager::add_user(const std::string &container_id,
                                                  int64_t pid,
                                                  uint32_t uid,
@@ -304,10 +340,19 @@ scap_userinfo *sinsp_usergroup_manager::add_host_user(uint32_t uid,
 	scap_userinfo *retval{nullptr};
 	if(name.data() != nullptr) {
 		retval = userinfo_map_insert(m_userlist[""], uid, gid, name, home, shell);
+	} else if(!m_host_root.empty()) {
+		// If we have a host root, we take the entry directly from file,
+		// which is parsed again only when it changes
+		load_passwd_index(m_host_passwd, m_host_root + "/etc/passwd");
+		auto *e = find_entry(m_host_passwd.entries, uid, m_file_index_stats);
+		if(e) {
+			retval = userinfo_map_insert(m_userlist[""], uid, e->gid, e->name, e->home, e->shell);
+		}
 	} else {
 #ifdef HAVE_PWD_H
-		// On Host, try to load info from db
-		auto *p = __getpwuid(uid, m_host_root);
+		// When we don't have any host root set,
+		// leverage NSS (see man nsswitch.conf)
+		auto *p = getpwuid(uid);
 		if(p) {
 			retval = userinfo_map_insert(m_userlist[""],
 			                             p->pw_uid,
@@ -342,27 +387,33 @@ scap_userinfo *sinsp_usergroup_manager::add_container_user(const std::string &co
 	}
 
 	std::string path = m_ns_helper->get_pid_root(pid) + "/etc/passwd";
-	auto pwd_file = fopen(path.c_str(), "r");
-	if(pwd_file) {
+	auto &index = m_container_passwd[container_id];
+	if(load_passwd_index(index, path)) {
+		// Here we cache all container users
 		auto &userlist = m_userlist[container_id];
-		while(auto p = fgetpwent(pwd_file)) {
-			// Here we cache all container users
-			auto *usr = userinfo_map_insert(userlist,
-			                                p->pw_uid,
-			                                p->pw_gid,
-			                                p->pw_name,
-			                                p->pw_dir,
-			                                p->pw_shell);
-
+		for(const auto &[id, e] : index.entries) {
+			auto *usr = userinfo_map_insert(userlist, id, e.gid, e.name, e.home, e.shell);
 			if(notify) {
 				notify_user_changed(usr, container_id);
 			}
+		}
+	}
 
-			if(uid == p->pw_uid) {
-				retval = usr;
+	auto *e = find_entry(index.entries, uid, m_file_index_stats);
+	if(e) {
+		retval = get_user(container_id, uid);
+		if(!retval) {
+			// the file did not change, but the user was removed
+			retval = userinfo_map_insert(m_userlist[container_id],
+			                             uid,
+			                             e->gid,
+			                             e->name,
+			                             e->home,
+			                             e->shell);
+			if(notify) {
+				notify_user_changed(retval, container_id);
 			}
 		}
-		fclose(pwd_file);
 	}
 #endif
 
@@ -431,10 +482,19 @@ scap_groupinfo *sinsp_usergroup_manager::add_host_group(uint32_t gid,
 	scap_groupinfo *gr = nullptr;
 	if(name.data()) {
 		gr = groupinfo_map_insert(m_grouplist[""], gid, name);
+	} else if(!m_host_root.empty()) {
+		// If we have a host root, we take the entry directly from file,
+		// which is parsed again only when it changes
+		load_group_index(m_host_group, m_host_root + "/etc/group");
+		auto *name = find_entry(m_host_group.entries, gid, m_file_index_stats);
+		if(name) {
+			gr = groupinfo_map_insert(m_grouplist[""], gid, *name);
+		}
 	} else {
 #ifdef HAVE_GRP_H
-		// On Host, try to load info from db
-		auto *g = __getgrgid(gid, m_host_root);
+		// When we don't have any host root set,
+		// leverage NSS (see man nsswitch.conf)
+		auto *g = getgrgid(gid);
 		if(g) {
 			gr = groupinfo_map_insert(m_grouplist[""], g->gr_gid, g->gr_name);
 		}
@@ -464,22 +524,28 @@ scap_groupinfo *sinsp_usergroup_manager::add_container_group(const std::string &
 	}
 
 	std::string path = m_ns_helper->get_pid_root(pid) + "/etc/group";
-	auto group_file = fopen(path.c_str(), "r");
-	if(group_file) {
+	auto &index = m_container_group[container_id];
+	if(load_group_index(index, path)) {
+		// Here we cache all container groups
 		auto &grouplist = m_grouplist[container_id];
-		while(auto g = fgetgrent(group_file)) {
-			// Here we cache all container groups
-			auto *gr = groupinfo_map_insert(grouplist, g->gr_gid, g->gr_name);
-
+		for(const auto &[id, name] : index.entries) {
+			auto *gr = groupinfo_map_insert(grouplist, id, name);
 			if(notify) {
 				notify_group_changed(gr, container_id, true);
 			}
+		}
+	}
 
-			if(gid == g->gr_gid) {
-				retval = gr;
+	auto *name = find_entry(index.entries, gid, m_file_index_stats);
+	if(name) {
+		retval = get_group(container_id, gid);
+		if(!retval) {
+			// the file did not change, but the group was removed
+			retval = groupinfo_map_insert(m_grouplist[container_id], gid, *name);
+			if(notify) {
+				notify_group_changed(retval, container_id, true);
 			}
 		}
-		fclose(group_file);
 	}
 #endif
 
@@ -147,6 +147,22 @@ public:
 
 	bool clear_host_users_groups();
 
+	/*!
+	  \brief Counters of the lookups in the passwd and group files of the
+	  host root and of the containers, which are parsed once and kept
+	  indexed until they change.
+	*/
+	struct file_index_stats {
+		// lookups that found the id in an up to date index
+		uint64_t m_hits = 0;
+		// lookups of ids that are not in the file
+		uint64_t m_misses = 0;
+		// files parsed, for the first time or because they changed
+		uint64_t m_reloads = 0;
+	};
+
+	const file_index_stats &get_file_index_stats() const { return m_file_index_stats; }
+
 	//
 	// User and group tables
 	//
@@ -190,6 +206,44 @@ private:
 	                          const std::string &container_id,
 	                          bool added = true);
 
+	// identity of the last version of a file that was parsed
+	struct file_stamp {
+		uint64_t dev = 0;
+		uint64_t ino = 0;
+		uint64_t size = 0;
+		uint64_t mtime_ns = 0;
+
+		bool operator==(const file_stamp &o) const {
+			return dev == o.dev && ino == o.ino && size == o.size && mtime_ns == o.mtime_ns;
+		}
+	};
+
+	struct passwd_entry {
+		uint32_t gid;
+		std::string name;
+		std::string home;
+		std::string shell;
+	};
+
+	struct passwd_index {
+		bool loaded = false;
+		file_stamp stamp;
+		std::unordered_map<uint32_t, passwd_entry> entries;
+	};
+
+	struct group_index {
+		bool loaded = false;
+		file_stamp stamp;
+		std::unordered_map<uint32_t, std::string> entries;
+	};
+
+	static file_stamp get_file_stamp(const std::string &path);
+
+	// Parse the file at path in the index if it changed since the last
+	// time, and return true in that case
+	bool load_passwd_index(passwd_index &index, const std::string &path);
+	bool load_group_index(group_index &index, const std::string &path);
+
 	using userinfo_map = std::unordered_map<uint32_t, scap_userinfo>;
 	using groupinfo_map = std::unordered_map<uint32_t, scap_groupinfo>;
 
@@ -204,6 +258,13 @@ private:
 
 	std::unordered_map<std::string, userinfo_map> m_userlist;
 	std::unordered_map<std::string, groupinfo_map> m_grouplist;
+	// passwd and group files of the host root and of the containers
+	passwd_index m_host_passwd;
+	group_index m_host_group;
+	std::unordered_map<std::string, passwd_index> m_container_passwd;
+	std::unordered_map<std::string, group_index> m_container_group;
+	file_index_stats m_file_index_stats;
+
 	uint64_t m_last_flush_time_ns;
 	sinsp *m_inspector;
 